@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts the calls to the global operator new of the whole app, which AllocationCounter.cpp replaces
+namespace AllocationCounter
+{
+uint64_t getCount();
+uint64_t getBytes();
+}
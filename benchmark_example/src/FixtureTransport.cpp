@@ -0,0 +1,28 @@
+#include "FixtureTransport.h"
+
+FixtureTransport::FixtureTransport(ofxInstagram &instagram)
+    : m_Instagram(instagram)
+{
+
+}
+
+void FixtureTransport::setBody(const std::string &body)
+{
+    m_Body.set(body.data(), body.size());
+}
+
+void FixtureTransport::load(const ofHttpRequest &request)
+{
+    m_Pending.push_back(ofHttpResponse(request, m_Body, 200, ""));
+}
+
+void FixtureTransport::deliver(std::vector<uint64_t> &responseTimes)
+{
+    while (m_Pending.empty() == false) {
+        ofHttpResponse response = m_Pending.front();
+        m_Pending.pop_front();
+        const uint64_t start = ofGetElapsedTimeMicros();
+        m_Instagram.urlResponse(response);
+        responseTimes.push_back(ofGetElapsedTimeMicros() - start);
+    }
+}
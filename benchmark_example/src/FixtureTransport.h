@@ -0,0 +1,24 @@
+#pragma once
+
+#include <deque>
+#include "ofxInstagram.h"
+#include "ofxInstagramTransport.h"
+
+// Answers every request with the same body, usually one of the Fixtures. deliver() hands the pending responses to
+// ofxInstagram::urlResponse().
+class FixtureTransport : public ofxInstagramTransport
+{
+public:
+    explicit FixtureTransport(ofxInstagram &instagram);
+
+    void setBody(const std::string &body);
+    void load(const ofHttpRequest &request) override;
+
+    // Returns the time each response took in urlResponse(), in microseconds
+    void deliver(std::vector<uint64_t> &responseTimes);
+
+private:
+    ofxInstagram &m_Instagram;
+    ofBuffer m_Body;
+    std::deque<ofHttpResponse> m_Pending;
+};
@@ -0,0 +1,14 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main(int argc, char *argv[]){
+	// The benchmarks do not draw anything, so there is no need for a GL context
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, 1024, 768, OF_WINDOW);
+
+	// "./benchmark_example decode snapshot" runs only those two, without arguments all of them run
+	ofRunApp(new ofApp(std::vector<std::string>(argv + 1, argv + argc)));
+
+}
@@ -0,0 +1,563 @@
+#include "ofApp.h"
+#include "AllocationCounter.h"
+#include "ofxInstagramHistogram.h"
+#include "ofxInstagramRecorder.h"
+
+//--------------------------------------------------------------
+ofApp::ofApp(const std::vector<std::string> &benchmarks)
+    : m_Benchmarks(benchmarks)
+{
+
+}
+//--------------------------------------------------------------
+void ofApp::setup()
+{
+    // Named like the first word of their output
+    const std::vector<std::pair<std::string, std::function<void()>>> benchmarks = {
+        {"spatial_index", [this]() { benchmarkSpatialIndex(); }},
+        {"tag_index", [this]() { benchmarkTagIndex(); }},
+        {"image_pipeline", [this]() { benchmarkImageResize(); }},
+        {"atlas", [this]() { benchmarkAtlas(); }},
+        {"snapshot", [this]() { benchmarkSnapshot(); }},
+        {"decode", [this]() { benchmarkDecode(); }}
+    };
+
+    for (const std::string &name : m_Benchmarks) {
+        auto isNamed = [&name](const std::pair<std::string, std::function<void()>> &benchmark) {
+            return benchmark.first == name;
+        };
+        if (std::find_if(benchmarks.begin(), benchmarks.end(), isNamed) == benchmarks.end()) {
+            ofLogError("ofApp") << "There is no benchmark named " << name;
+        }
+    }
+
+    for (const auto &benchmark : benchmarks) {
+        if (m_Benchmarks.empty() || std::find(m_Benchmarks.begin(), m_Benchmarks.end(), benchmark.first) != m_Benchmarks.end()) {
+            // Seeded for each one, so a benchmark sees the same data whether it runs alone or with the others
+            ofSeedRandom(1);
+            benchmark.second();
+        }
+    }
+}
+//--------------------------------------------------------------
+void ofApp::update()
+{
+    ofExit();
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkSpatialIndex()
+{
+    const int pointCount = 1000000;
+    const int queryCount = 1000;
+
+    // Most of the points are clustered around a city, the rest are spread over the world
+    ofxInstagramSpatialIndex index;
+    uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < pointCount; i++) {
+        ofxInstagramTypes::Location location;
+        location.id = ofToString(i);
+        if (i % 10 == 0) {
+            location.latitude = ofRandom(-80, 80);
+            location.longitude = ofRandom(-180, 180);
+        }
+        else {
+            location.latitude = 51.5074f + ofRandom(-0.25f, 0.25f);
+            location.longitude = -0.1278f + ofRandom(-0.4f, 0.4f);
+        }
+
+        index.addLocation(location);
+    }
+
+    const uint64_t buildTime = ofGetElapsedTimeMicros() - start;
+    std::cout << "spatial_index build points=" << pointCount << " ms=" << buildTime / 1000.0 << "\n";
+
+    const double radii[] = {250, 1000, 5000};
+    for (double radius : radii) {
+        size_t resultCount = 0;
+        start = ofGetElapsedTimeMicros();
+        for (int i = 0; i < queryCount; i++) {
+            const double latitude = 51.5074 + ofRandom(-0.2f, 0.2f);
+            const double longitude = -0.1278 + ofRandom(-0.3f, 0.3f);
+            resultCount += index.findLocationsInRadius(latitude, longitude, radius).size();
+        }
+
+        const uint64_t queryTime = ofGetElapsedTimeMicros() - start;
+        std::cout << "spatial_index radius_query radius_m=" << radius << " queries=" << queryCount
+                  << " avg_results=" << resultCount / queryCount
+                  << " us_per_query=" << static_cast<double>(queryTime) / queryCount << "\n";
+    }
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkTagIndex()
+{
+    const int postCount = 100000;
+    const int queryCount = 1000;
+
+    // Tag popularity is skewed like on the real API: a few tags are on most posts, most tags are on a few
+    auto randomTag = []() {
+        const float value = ofRandom(1);
+        return "tag" + ofToString(static_cast<int>(value * value * value * 5000));
+    };
+
+    ofxInstagramTagIndex index;
+    std::vector<ofxInstagramTypes::PostHandle> posts;
+    posts.reserve(postCount);
+    for (int i = 0; i < postCount; i++) {
+        std::shared_ptr<ofxInstagramTypes::PostData> post = std::make_shared<ofxInstagramTypes::PostData>();
+        post->id = ofToString(i) + "_1234567";
+        post->likeCount = static_cast<unsigned int>(ofRandom(10000));
+        const int tagCount = 1 + static_cast<int>(ofRandom(8));
+        for (int tagIndex = 0; tagIndex < tagCount; tagIndex++) {
+            post->tags.push_back(randomTag());
+        }
+
+        posts.push_back(post);
+    }
+
+    uint64_t start = ofGetElapsedTimeMicros();
+    for (const ofxInstagramTypes::PostHandle &post : posts) {
+        index.add(post);
+    }
+
+    const uint64_t buildTime = ofGetElapsedTimeMicros() - start;
+    std::cout << "tag_index build posts=" << postCount << " tags=" << index.getTagCount() << " ms=" << buildTime / 1000.0 << "\n";
+
+    auto run = [&](const std::string & name, std::function<size_t(const std::vector<std::string> &)> query) {
+        ofxInstagramHistogram latency;
+        size_t resultCount = 0;
+        for (int i = 0; i < queryCount; i++) {
+            const std::vector<std::string> tags = {randomTag(), randomTag()};
+            const uint64_t queryStart = ofGetElapsedTimeMicros();
+            resultCount += query(tags);
+            latency.record(ofGetElapsedTimeMicros() - queryStart);
+        }
+
+        std::cout << "tag_index " << name << " posts=" << index.size() << " queries=" << queryCount
+                  << " avg_results=" << resultCount / queryCount
+                  << " p50_us=" << latency.getPercentile(50) << " p99_us=" << latency.getPercentile(99) << "\n";
+    };
+
+    run("find_all", [&](const std::vector<std::string> &tags) {
+        return index.findAll(tags).size();
+    });
+    run("find_any", [&](const std::vector<std::string> &tags) {
+        return index.findAny(tags).size();
+    });
+    run("find_top_liked", [&](const std::vector<std::string> &tags) {
+        return index.findTopLiked(tags, 20, false).size();
+    });
+
+    // Removing most of the posts compacts the index, the queries afterwards run over the remaining ones
+    start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < postCount * 3 / 4; i++) {
+        index.remove(posts[i]->id);
+    }
+
+    const uint64_t removeTime = ofGetElapsedTimeMicros() - start;
+    std::cout << "tag_index remove posts=" << postCount * 3 / 4 << " ms=" << removeTime / 1000.0 << "\n";
+    run("find_all_after_remove", [&](const std::vector<std::string> &tags) {
+        return index.findAll(tags).size();
+    });
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkImageResize()
+{
+    const int imageSize = 640;
+    const int tileSize = 250;
+    const int imagesPerThread = 200;
+    const int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // A gradient with some noise compresses roughly like a photo
+    ofPixels source;
+    source.allocate(imageSize, imageSize, 3);
+    unsigned char *data = source.getData();
+    for (int i = 0; i < imageSize * imageSize * 3; i++) {
+        const int x = (i / 3) % imageSize, y = (i / 3) / imageSize;
+        data[i] = static_cast<unsigned char>(ofClamp((x + y) / 5 + (i % 3) * 40 + ofRandom(-20, 20), 0.0f, 255.0f));
+    }
+
+    ofBuffer jpeg;
+    ofSaveImage(source, jpeg, OF_IMAGE_FORMAT_JPEG);
+
+    // The resampler on its own, every thread works on its own instance like the decode workers of the media loader
+    auto runResize = [&](const std::string & name, bool isAccelerated) {
+        const uint64_t start = ofGetElapsedTimeMicros();
+        std::vector<std::thread> threads;
+        for (int threadIndex = 0; threadIndex < threadCount; threadIndex++) {
+            threads.push_back(std::thread([&]() {
+                ofxInstagramImageResizer resizer;
+                resizer.setAccelerated(isAccelerated);
+                ofPixels resized;
+                for (int i = 0; i < imagesPerThread; i++) {
+                    resizer.resize(source, resized, tileSize, tileSize);
+                }
+            }));
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        const double seconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+        const double imagesPerSecond = threadCount * imagesPerThread / seconds;
+        std::cout << "image_pipeline " << name << " size=" << imageSize << " tile=" << tileSize << " threads=" << threadCount
+                  << " images_per_s=" << imagesPerSecond << " images_per_s_per_core=" << imagesPerSecond / threadCount << "\n";
+    };
+
+    runResize("resize_scalar", false);
+    runResize("resize_simd", true);
+
+    // The whole decode stage of the media loader. Every image has its own URL and its bytes are put in the cache up front,
+    // so the workers read them from there instead of downloading them and each one is decoded and resized once.
+    const int imageCount = threadCount * imagesPerThread;
+    const uint64_t tileBytes = static_cast<uint64_t>(tileSize) * tileSize * 3;
+    std::shared_ptr<ofxInstagramImageCache> cache = std::make_shared<ofxInstagramImageCache>();
+    cache->setup(ofToDataPath("benchmark_image_cache"), imageCount * (jpeg.size() + tileBytes) * 2);
+    cache->clear();
+    for (int i = 0; i < imageCount; i++) {
+        cache->store("https://scontent.cdninstagram.com/benchmark/" + ofToString(i) + ".jpg", jpeg);
+    }
+
+    ofxInstagramMediaLoader loader;
+    loader.setCache(cache);
+    loader.setup(4, threadCount);
+
+    int loadedCount = 0, failedCount = 0;
+    const uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < imageCount; i++) {
+        loader.loadImage("https://scontent.cdninstagram.com/benchmark/" + ofToString(i) + ".jpg", tileSize, tileSize,
+                         [&loadedCount, &failedCount](ofxInstagramMediaLoader::Result & result) {
+            if (result.isSuccessful && result.pixels) {
+                loadedCount++;
+            }
+            else {
+                failedCount++;
+            }
+        });
+    }
+
+    while (loadedCount + failedCount < imageCount) {
+        loader.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const double seconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+    const double imagesPerSecond = loadedCount / seconds;
+    std::cout << "image_pipeline decode_resize size=" << imageSize << " tile=" << tileSize << " threads=" << threadCount
+              << " images=" << loadedCount << " failed=" << failedCount
+              << " images_per_s=" << imagesPerSecond << " images_per_s_per_core=" << imagesPerSecond / threadCount << "\n";
+
+    loader.stop();
+    cache->clear();
+
+    std::cout << "image_pipeline simd_available=" << ofxInstagramImageResizer::isAccelerationAvailable() << "\n";
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkAtlas()
+{
+    const int imageCount = 20000;
+    const size_t maxPages = 4;
+
+    // A wall that keeps rotating through posts, the oldest tile makes room for the next one once the atlas is full
+    ofxInstagramAtlas atlas(2048, 3, 1, maxPages);
+    std::deque<std::string> mediaIDs;
+    ofPixels tile;
+    tile.allocate(250, 250, 3);
+    std::fill(tile.getData(), tile.getData() + 250 * 250 * 3, 128);
+
+    size_t evictionCount = 0;
+    const uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < imageCount; i++) {
+        const std::string mediaID = ofToString(i);
+        while (atlas.add(mediaID, tile) == false && mediaIDs.empty() == false) {
+            atlas.remove(mediaIDs.front());
+            mediaIDs.pop_front();
+            evictionCount++;
+        }
+
+        mediaIDs.push_back(mediaID);
+    }
+
+    const uint64_t packTime = ofGetElapsedTimeMicros() - start;
+
+    ofMesh mesh;
+    mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+    for (size_t i = 0; i < mediaIDs.size(); i++) {
+        atlas.addToMesh(mesh, mediaIDs[i], ofRectangle((i % 16) * 250, (i / 16) * 250, 250, 250));
+    }
+
+    std::cout << "atlas pack images=" << imageCount << " tile=250 pages=" << atlas.getPageCount()
+              << " resident=" << atlas.size() << " evictions=" << evictionCount
+              << " fill_ratio=" << atlas.getFillRatio()
+              << " us_per_image=" << static_cast<double>(packTime) / imageCount
+              << " mesh_vertices=" << mesh.getNumVertices() << "\n";
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkSnapshot()
+{
+    const int postCount = 50000;
+
+    ofxInstagramTypes::Posts posts;
+    posts.first.resize(postCount);
+    for (int i = 0; i < postCount; i++) {
+        ofxInstagramTypes::PostData &post = posts.first[i];
+        post.id = ofToString(i) + "_1234567";
+        post.type = i % 10 == 0 ? "video" : "image";
+        post.user.username = "user_" + ofToString(i % 500);
+        post.caption.text = "Caption of post " + ofToString(i);
+        post.imageThumbnail.url = "https://scontent.cdninstagram.com/t/" + post.id + ".jpg";
+        post.tags.push_back("tag" + ofToString(i % 50));
+        post.likeCount = i % 1000;
+        post.createdTimestamp = 1500000000 + i;
+        post.createdTime = ofToString(post.createdTimestamp);
+    }
+
+    const std::string path = ofToDataPath("benchmark_snapshot.bin");
+    uint64_t start = ofGetElapsedTimeMicros();
+    ofxInstagramSnapshot::save(path, posts);
+    const uint64_t saveTime = ofGetElapsedTimeMicros() - start;
+
+    ofxInstagramSnapshot snapshot;
+    start = ofGetElapsedTimeMicros();
+    snapshot.open(path);
+    const uint64_t openTime = ofGetElapsedTimeMicros() - start;
+
+    start = ofGetElapsedTimeMicros();
+    unsigned int likeCount = 0;
+    for (size_t i = 0; i < snapshot.getPostCount(); i++) {
+        likeCount += snapshot.getPostLikeCount(i);
+    }
+
+    const uint64_t scanTime = ofGetElapsedTimeMicros() - start;
+
+    start = ofGetElapsedTimeMicros();
+    const ofxInstagramTypes::Posts loaded = snapshot.getPosts();
+    const uint64_t decodeTime = ofGetElapsedTimeMicros() - start;
+
+    std::cout << "snapshot posts=" << loaded.first.size() << " save_ms=" << saveTime / 1000.0
+              << " open_ms=" << openTime / 1000.0 << " scan_ms=" << scanTime / 1000.0
+              << " decode_ms=" << decodeTime / 1000.0 << " likes=" << likeCount << "\n";
+    snapshot.close();
+    ofFile::removeFile(path, false);
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkDecode()
+{
+    ofxInstagram instagram;
+    std::shared_ptr<FixtureTransport> transport = std::make_shared<FixtureTransport>(instagram);
+    instagram.setTransport(transport);
+
+    // Each request counts the posts, or other objects, its callback received
+    const int sizes[] = {1, 10, 100, 1000};
+    for (int size : sizes) {
+        transport->setBody(Fixtures::posts(size));
+        benchmarkDecode(instagram, *transport, "request_user_feed", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getUserFeed(20, "self", [&count](ofxInstagramTypes::Posts posts) {
+                count += posts.first.size();
+            });
+        });
+        benchmarkDecode(instagram, *transport, "request_tag_post_list", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getListOfTaggedObjectsNormal("sunset", 20, [&count](ofxInstagramTypes::Posts posts) {
+                count += posts.first.size();
+            });
+        });
+        benchmarkDecode(instagram, *transport, "request_location_recent_media", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getRecentMediaFromLocation("213000000", [&count](ofxInstagramTypes::Posts posts) {
+                count += posts.first.size();
+            });
+        });
+
+        transport->setBody(Fixtures::users(size));
+        benchmarkDecode(instagram, *transport, "request_user_search", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getSearchUsers("user", 20, [&count](std::vector<ofxInstagramTypes::UserInfo> users) {
+                count += users.size();
+            });
+        });
+        benchmarkDecode(instagram, *transport, "request_relationship_following", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getWhoUserFollows("self", [&count](std::vector<ofxInstagramTypes::UserInfo> users) {
+                count += users.size();
+            });
+        });
+        benchmarkDecode(instagram, *transport, "request_list_of_users_who_liked_media", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getListOfUsersWhoLikedMedia("1234567890123456789_0", [&count](std::vector<ofxInstagramTypes::UserInfo> users) {
+                count += users.size();
+            });
+        });
+
+        transport->setBody(Fixtures::comments(size));
+        benchmarkDecode(instagram, *transport, "request_comment_for_media", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.getCommentsForMedia("1234567890123456789_0", [&count](std::vector<ofxInstagramTypes::Comment> comments) {
+                count += comments.size();
+            });
+        });
+
+        transport->setBody(Fixtures::tags(size));
+        benchmarkDecode(instagram, *transport, "request_tag_search", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.searchForTags("sunset", [&count](std::vector<ofxInstagramTypes::TagInfo> tags) {
+                count += tags.size();
+            });
+        });
+
+        transport->setBody(Fixtures::locations(size));
+        benchmarkDecode(instagram, *transport, "request_location_search", size, [](ofxInstagram & instagram, size_t &count) {
+            return instagram.searchForLocations("1000", "41.0256", "28.9741", [&count](std::vector<ofxInstagramTypes::Location> locations) {
+                count += locations.size();
+            });
+        });
+    }
+
+    transport->setBody(Fixtures::post());
+    benchmarkDecode(instagram, *transport, "request_media_information", 1, [](ofxInstagram & instagram, size_t &count) {
+        return instagram.getMediaInformation("1234567890123456789_0", [&count](ofxInstagramTypes::PostData) {
+            count++;
+        });
+    });
+
+    transport->setBody(Fixtures::user());
+    benchmarkDecode(instagram, *transport, "request_user_info", 1, [](ofxInstagram & instagram, size_t &count) {
+        return instagram.getUserInformation("self", [&count](ofxInstagramTypes::UserInfo) {
+            count++;
+        });
+    });
+
+    transport->setBody(Fixtures::relationship());
+    benchmarkDecode(instagram, *transport, "request_relationship_user_rel", 1, [](ofxInstagram & instagram, size_t &count) {
+        return instagram.getRelationshipToUser("1000001", [&count](ofxInstagramTypes::Relationship) {
+            count++;
+        });
+    });
+
+    transport->setBody(Fixtures::tag());
+    benchmarkDecode(instagram, *transport, "request_tag_info", 1, [](ofxInstagram & instagram, size_t &count) {
+        return instagram.getInfoForTag("sunset", [&count](ofxInstagramTypes::TagInfo) {
+            count++;
+        });
+    });
+
+    transport->setBody(Fixtures::location());
+    benchmarkDecode(instagram, *transport, "request_location_info", 1, [](ofxInstagram & instagram, size_t &count) {
+        return instagram.getInfoAboutLocation("213000000", [&count](ofxInstagramTypes::Location) {
+            count++;
+        });
+    });
+
+    // Responses recorded from the real API with ofxInstagramRecorder are run as well when there are any
+    std::vector<ofxInstagramRecorder::Record> records;
+    const std::string recordPath = ofToDataPath("fixtures.igrl");
+    if (ofFile::doesFileExist(recordPath, false) == false || ofxInstagramRecorder::load(recordPath, records) == false) {
+        return;
+    }
+
+    // request() delivers to the on...Received members, which count into the benchmark that is running
+    size_t *recordedCount = nullptr;
+    auto countPosts = [&recordedCount](ofxInstagramTypes::Posts posts) {
+        *recordedCount += posts.first.size();
+    };
+    auto countUsers = [&recordedCount](std::vector<ofxInstagramTypes::UserInfo> users) {
+        *recordedCount += users.size();
+    };
+
+    instagram.onUserFeedReceived = countPosts;
+    instagram.onUserRecentMediaReceived = countPosts;
+    instagram.onUserLikedMediaReceived = countPosts;
+    instagram.onMediaSearchReceived = countPosts;
+    instagram.onMediaPopularReceived = countPosts;
+    instagram.onPostsForTagReceived = countPosts;
+    instagram.onPostsFromLocationReceived = countPosts;
+    instagram.onUserSearchReceived = countUsers;
+    instagram.onUserFollowingReceived = countUsers;
+    instagram.onUserFollowersReceived = countUsers;
+    instagram.onUserFollowRequestsReceived = countUsers;
+    instagram.onLikeListReceived = countUsers;
+    instagram.onUserInfoReceived = [&recordedCount](ofxInstagramTypes::UserInfo) {
+        (*recordedCount)++;
+    };
+    instagram.onUserRelationshipReceived = [&recordedCount](ofxInstagramTypes::Relationship) {
+        (*recordedCount)++;
+    };
+    instagram.onMediaInformationReceived = [&recordedCount](ofxInstagramTypes::PostData) {
+        (*recordedCount)++;
+    };
+    instagram.onCommentsForMediaReceived = [&recordedCount](std::vector<ofxInstagramTypes::Comment> comments) {
+        *recordedCount += comments.size();
+    };
+    instagram.onTagInfoReceived = [&recordedCount](ofxInstagramTypes::TagInfo) {
+        (*recordedCount)++;
+    };
+    instagram.onTagSearchReceived = [&recordedCount](std::vector<ofxInstagramTypes::TagInfo> tags) {
+        *recordedCount += tags.size();
+    };
+    instagram.onLocationInfoReceived = [&recordedCount](ofxInstagramTypes::Location) {
+        (*recordedCount)++;
+    };
+    instagram.onLocationSearchReceived = [&recordedCount](std::vector<ofxInstagramTypes::Location> locations) {
+        *recordedCount += locations.size();
+    };
+
+    for (const ofxInstagramRecorder::Record &record : records) {
+        transport->setBody(record.body);
+        benchmarkDecode(instagram, *transport, record.requestName, 0, [&record, &recordedCount](ofxInstagram & instagram, size_t &count) {
+            recordedCount = &count;
+            // Next pages have no member callback, they go through the getter that follows them
+            ofxInstagramTypes::Pagination pagination;
+            pagination.nextURL = record.url;
+            if (record.requestName == "request_next_page") {
+                return instagram.getNextPage(pagination, [&count](ofxInstagramTypes::Posts posts) {
+                    count += posts.first.size();
+                });
+            }
+            else if (record.requestName == "request_next_users_page") {
+                return instagram.getNextUsersPage(pagination, [&count](ofxInstagramTypes::Users users) {
+                    count += users.first.size();
+                });
+            }
+
+            return instagram.request(record.url, record.requestName);
+        });
+    }
+}
+//--------------------------------------------------------------
+void ofApp::benchmarkDecode(ofxInstagram &instagram, FixtureTransport &transport, const std::string &endpoint, int size,
+                            const std::function<int(ofxInstagram &, size_t &)> &request)
+{
+    // Runs for a fixed time rather than a fixed count, so the small and the large responses take about as long
+    const uint64_t duration = 250000;
+    const int minimumResponseCount = 20;
+
+    instagram.getMetrics().clear();
+    std::vector<uint64_t> responseTimes;
+    responseTimes.reserve(4096);
+    size_t objectCount = 0;
+    uint64_t allocationCount = 0, allocationBytes = 0;
+
+    const uint64_t start = ofGetElapsedTimeMicros();
+    while (ofGetElapsedTimeMicros() - start < duration || static_cast<int>(responseTimes.size()) < minimumResponseCount) {
+        request(instagram, objectCount);
+
+        // Only the delivery is counted, the request and the time bookkeeping allocate as well
+        const uint64_t countBefore = AllocationCounter::getCount(), bytesBefore = AllocationCounter::getBytes();
+        transport.deliver(responseTimes);
+        allocationCount += AllocationCounter::getCount() - countBefore;
+        allocationBytes += AllocationCounter::getBytes() - bytesBefore;
+    }
+
+    const double seconds = (ofGetElapsedTimeMicros() - start) / 1000000.0;
+    const size_t responseCount = responseTimes.size();
+    ofxInstagramHistogram latency;
+    for (uint64_t responseTime : responseTimes) {
+        latency.record(responseTime);
+    }
+
+    const ofxInstagramMetrics::Endpoint metrics = instagram.getMetrics().getEndpoint(endpoint);
+    std::cout << "decode endpoint=" << endpoint << " size=" << size << " responses=" << responseCount
+              << " bytes_per_response=" << metrics.byteCount / std::max<uint64_t>(1, metrics.responseCount)
+              << " responses_per_s=" << responseCount / seconds
+              << " objects_per_s=" << objectCount / seconds
+              << " mb_per_s=" << metrics.byteCount / seconds / (1024.0 * 1024.0)
+              << " allocs_per_response=" << static_cast<double>(allocationCount) / responseCount
+              << " alloc_bytes_per_response=" << static_cast<double>(allocationBytes) / responseCount
+              << " p50_us=" << latency.getPercentile(50) << " p99_us=" << latency.getPercentile(99)
+              << " parse_p50_us=" << metrics.parseTime.getPercentile(50)
+              << " decode_p50_us=" << metrics.decodeTime.getPercentile(50)
+              << " errors=" << metrics.errorCount << "\n";
+}
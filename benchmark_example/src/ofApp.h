@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxInstagramSpatialIndex.h"
+#include "ofxInstagramTagIndex.h"
+#include "ofxInstagramImageResizer.h"
+#include "ofxInstagramMediaLoader.h"
+#include "ofxInstagramAtlas.h"
+#include "ofxInstagramSnapshot.h"
+#include "FixtureTransport.h"
+#include "Fixtures.h"
+
+class ofApp : public ofBaseApp{
+
+	public:
+		// Runs the benchmarks with these names, such as "decode" or "tag_index", or all of them when it is empty
+		explicit ofApp(const std::vector<std::string> &benchmarks);
+
+		void setup();
+		void update();
+
+    private:
+        void benchmarkSpatialIndex();
+        void benchmarkTagIndex();
+        void benchmarkImageResize();
+        void benchmarkAtlas();
+        void benchmarkSnapshot();
+        void benchmarkDecode();
+        void benchmarkDecode(ofxInstagram &instagram, FixtureTransport &transport, const std::string &endpoint, int size,
+                             const std::function<int(ofxInstagram &, size_t &)> &request);
+
+        std::vector<std::string> m_Benchmarks;
+};
@@ -0,0 +1,191 @@
+#include "Fixtures.h"
+#include "ofMain.h"
+#include "ofxInstagramExporter.h"
+
+namespace
+{
+const std::string META = "\"meta\":{\"code\":200}";
+const std::string PAGINATION = "\"pagination\":{\"next_url\":\"https://api.instagram.com/v1/users/self/media/recent?access_token=TOKEN&max_id=1234567890123456789_123456\",\"next_max_id\":\"1234567890123456789_123456\"}";
+
+ofxInstagramTypes::UserInfo makeUser(int index)
+{
+    ofxInstagramTypes::UserInfo user;
+    user.id = ofToString(1000000 + index);
+    user.username = "user_" + ofToString(index);
+    user.fullName = "Full Name " + ofToString(index);
+    user.profilePicture = "https://scontent.cdninstagram.com/t51.2885-19/s150x150/" + user.id + "_a.jpg";
+    user.bio = "Photographer";
+    user.followerCount = 1000 + index;
+    user.followingCount = 320;
+    user.mediaCount = 100 + index;
+    return user;
+}
+
+ofxInstagramTypes::PostMedia makeMedia(const std::string &url, unsigned int size)
+{
+    ofxInstagramTypes::PostMedia media;
+    media.url = url;
+    media.width = size;
+    media.height = size;
+    return media;
+}
+
+ofxInstagramTypes::PostData makePost(int index)
+{
+    ofxInstagramTypes::PostData post;
+    post.id = ofToString(1234567890123456789ULL + index) + "_" + ofToString(index % 997);
+    post.type = index % 8 == 0 ? "video" : "image";
+    post.createdTime = ofToString(1500000000 + index * 37);
+    post.link = "https://www.instagram.com/p/BXa" + ofToString(index) + "/";
+    post.filter = "Normal";
+    post.user = makeUser(index % 50);
+    post.caption.id = ofToString(17800000000000000ULL + index);
+    post.caption.createdTime = post.createdTime;
+    post.caption.text = "Sunset over the Bosphorus, what a view to end the week with #sunset #istanbul #travel #photooftheday";
+    post.caption.from = post.user;
+    post.location.id = ofToString(213000000 + index % 100);
+    post.location.name = "Galata Tower";
+    post.location.latitude = 41.0256f;
+    post.location.longitude = 28.9741f;
+
+    post.commentCount = 12;
+    for (int commentIndex = 0; commentIndex < 4; commentIndex++) {
+        ofxInstagramTypes::Comment comment;
+        comment.id = ofToString(17850000000000000ULL + index * 4 + commentIndex);
+        comment.createdTime = post.createdTime;
+        comment.text = "Beautiful shot!";
+        comment.from = makeUser(commentIndex);
+        post.comments.push_back(comment);
+    }
+
+    post.likeCount = 240;
+    for (int likeIndex = 0; likeIndex < 4; likeIndex++) {
+        post.likes.push_back(makeUser(likeIndex + 10));
+    }
+
+    post.tags = {"sunset", "istanbul", "travel", "photooftheday"};
+    ofxInstagramTypes::Position position;
+    position.x = 0.4f;
+    position.y = 0.6f;
+    post.usersInPhoto.push_back(std::make_pair(position, makeUser(7)));
+
+    const std::string mediaURL = "https://scontent.cdninstagram.com/t51.2885-15/" + post.id;
+    post.imageThumbnail = makeMedia(mediaURL + "_s150x150.jpg", 150);
+    post.imageLowResolution = makeMedia(mediaURL + "_s320x320.jpg", 320);
+    post.imageStandarResolution = makeMedia(mediaURL + "_s640x640.jpg", 640);
+    if (post.type == "video") {
+        post.videoLowBandwidth = makeMedia(mediaURL + "_lb.mp4", 480);
+        post.videoLowResolution = makeMedia(mediaURL + "_lr.mp4", 480);
+        post.videoStandartResolution = makeMedia(mediaURL + "_sr.mp4", 640);
+    }
+
+    return post;
+}
+
+std::string encodeUser(int index)
+{
+    const ofxInstagramTypes::UserInfo user = makeUser(index);
+    return "{\"id\":\"" + user.id + "\",\"username\":\"" + user.username + "\",\"full_name\":\"" + user.fullName +
+           "\",\"profile_picture\":\"" + user.profilePicture + "\",\"bio\":\"" + user.bio + "\",\"website\":\"\","
+           "\"counts\":{\"media\":" + ofToString(user.mediaCount) + ",\"follows\":" + ofToString(user.followingCount) +
+           ",\"followed_by\":" + ofToString(user.followerCount) + "}}";
+}
+
+std::string encodeTag(int index)
+{
+    return "{\"media_count\":" + ofToString(1000 * (index + 1)) + ",\"name\":\"sunset" + ofToString(index) + "\"}";
+}
+
+std::string encodeLocation(int index)
+{
+    return "{\"id\":\"" + ofToString(213000000 + index) + "\",\"name\":\"Place " + ofToString(index) +
+           "\",\"latitude\":" + ofToString(41.0 + index * 0.001) + ",\"longitude\":" + ofToString(28.9 + index * 0.001) + "}";
+}
+
+std::string encodeComment(int index)
+{
+    return "{\"id\":\"" + ofToString(17850000000000000ULL + index) + "\",\"created_time\":\"" + ofToString(1500000000 + index) +
+           "\",\"text\":\"Comment number " + ofToString(index) + "\",\"from\":" + encodeUser(index % 40) + "}";
+}
+
+template<typename Encode>
+std::string list(int count, Encode encode, bool hasPagination)
+{
+    std::string body = "{" + META + ",";
+    if (hasPagination) {
+        body += PAGINATION + ",";
+    }
+
+    body += "\"data\":[";
+    for (int index = 0; index < count; index++) {
+        body += index == 0 ? "" : ",";
+        body += encode(index);
+    }
+
+    return body + "]}";
+}
+
+std::string single(const std::string &data)
+{
+    return "{" + META + ",\"data\":" + data + "}";
+}
+}
+
+namespace Fixtures
+{
+std::string posts(int count)
+{
+    return list(count, [](int index) {
+        std::string line;
+        ofxInstagramExporter::encodePost(makePost(index), line);
+        return line;
+    }, true);
+}
+
+std::string post()
+{
+    std::string line;
+    ofxInstagramExporter::encodePost(makePost(0), line);
+    return single(line);
+}
+
+std::string users(int count)
+{
+    return list(count, encodeUser, true);
+}
+
+std::string user()
+{
+    return single(encodeUser(0));
+}
+
+std::string comments(int count)
+{
+    return list(count, encodeComment, false);
+}
+
+std::string relationship()
+{
+    return single("{\"outgoing_status\":\"follows\",\"incoming_status\":\"followed_by\"}");
+}
+
+std::string tag()
+{
+    return single(encodeTag(0));
+}
+
+std::string tags(int count)
+{
+    return list(count, encodeTag, false);
+}
+
+std::string location()
+{
+    return single(encodeLocation(0));
+}
+
+std::string locations(int count)
+{
+    return list(count, encodeLocation, false);
+}
+}
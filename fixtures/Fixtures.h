@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+// Response bodies shaped like the ones of the API, so the decode and dispatch path can be measured without the network.
+// Shared by benchmark_example and loadtest_example, which add this folder to their sources in config.make. The same
+// arguments always give the same body.
+namespace Fixtures
+{
+// Pages of posts and users carry a pagination, the other lists do not
+std::string posts(int count);
+std::string post();
+std::string users(int count);
+std::string user();
+std::string comments(int count);
+std::string relationship();
+std::string tag();
+std::string tags(int count);
+std::string location();
+std::string locations(int count);
+}
@@ -0,0 +1,395 @@
+#include "FakeInstagramServer.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "ofMain.h"
+#include "Fixtures.h"
+
+namespace
+{
+const std::string RATE_LIMITED = "{\"meta\":{\"code\":429,\"error_type\":\"OAuthRateLimitException\","
+                                 "\"error_message\":\"The maximum number of requests per hour has been exceeded.\"}}";
+const std::string NOT_FOUND = "{\"meta\":{\"code\":400,\"error_type\":\"APINotFoundError\",\"error_message\":\"this endpoint does not exist\"}}";
+
+//accept() fails with EMFILE and the like until a connection closes, the accept thread waits before it tries again
+const int MIN_ACCEPT_RETRY_MILLIS = 10;
+const int MAX_ACCEPT_RETRY_MILLIS = 1000;
+
+const char *getStatusText(int status)
+{
+    switch (status) {
+    case 200:
+        return "OK";
+    case 400:
+        return "Bad Request";
+    case 429:
+        return "Too Many Requests";
+    default:
+        return "Error";
+    }
+}
+}
+
+FakeInstagramServer::FakeInstagramServer()
+    : m_ListenSocket(-1)
+    , m_Port(0)
+    , m_IsRunning(false)
+    , m_ConnectionThreadCount(0)
+    , m_LatencyMedian(50.0)
+    , m_LatencySigma(0.5)
+    , m_RateLimit(0.0)
+    , m_Tokens(0.0)
+    , m_Burst(0)
+    , m_LastRefillTime(0)
+    , m_PageSize(20)
+    , m_RequestCount(0)
+    , m_RateLimitedCount(0)
+    , m_NotFoundCount(0)
+    , m_ByteCount(0)
+    , m_ConnectionCount(0)
+{
+
+}
+
+FakeInstagramServer::~FakeInstagramServer()
+{
+    stop();
+}
+
+bool FakeInstagramServer::start(int port)
+{
+    stop();
+    generateBodies();
+
+    m_ListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_ListenSocket < 0) {
+        ofLogError("FakeInstagramServer") << __FUNCTION__ << ": Cannot create a socket.";
+        return false;
+    }
+
+    const int reuse = 1;
+    setsockopt(m_ListenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    socklen_t addressLength = sizeof(address);
+    if (bind(m_ListenSocket, reinterpret_cast<sockaddr *>(&address), addressLength) != 0 || listen(m_ListenSocket, SOMAXCONN) != 0 ||
+            getsockname(m_ListenSocket, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0) {
+        ofLogError("FakeInstagramServer") << __FUNCTION__ << ": Cannot listen on port " << port;
+        close(m_ListenSocket);
+        m_ListenSocket = -1;
+        return false;
+    }
+
+    m_Port = ntohs(address.sin_port);
+    m_IsRunning = true;
+    m_AcceptThread = std::thread(&FakeInstagramServer::acceptThreadedFunction, this);
+    return true;
+}
+
+void FakeInstagramServer::stop()
+{
+    if (m_ListenSocket < 0) {
+        return;
+    }
+
+    m_IsRunning = false;
+    //Wakes up accept() and recv() so their threads see that the server stopped
+    shutdown(m_ListenSocket, SHUT_RDWR);
+    m_AcceptThread.join();
+    close(m_ListenSocket);
+    m_ListenSocket = -1;
+
+    std::unique_lock<std::mutex> lock(m_ConnectionMutex);
+    for (int connectionSocket : m_ConnectionSockets) {
+        shutdown(connectionSocket, SHUT_RDWR);
+    }
+
+    m_ConnectionCondition.wait(lock, [this]() {
+        return m_ConnectionThreadCount == 0;
+    });
+}
+
+int FakeInstagramServer::getPort() const
+{
+    return m_Port;
+}
+
+std::string FakeInstagramServer::getHost() const
+{
+    return "http://127.0.0.1:" + ofToString(m_Port);
+}
+
+void FakeInstagramServer::setLatency(double medianMillis, double sigma)
+{
+    m_LatencyMedian = std::max(medianMillis, 0.0);
+    m_LatencySigma = std::max(sigma, 0.0);
+}
+
+void FakeInstagramServer::setRateLimit(double requestsPerSecond, int burst)
+{
+    std::lock_guard<std::mutex> lock(m_RateMutex);
+    m_RateLimit = std::max(requestsPerSecond, 0.0);
+    m_Burst = std::max(burst, 1);
+    m_Tokens = m_Burst;
+    m_LastRefillTime = ofGetElapsedTimeMicros();
+}
+
+void FakeInstagramServer::setPageSize(int pageSize)
+{
+    m_PageSize = std::max(pageSize, 1);
+}
+
+FakeInstagramServer::Stats FakeInstagramServer::getStats() const
+{
+    Stats stats;
+    stats.requestCount = m_RequestCount;
+    stats.rateLimitedCount = m_RateLimitedCount;
+    stats.notFoundCount = m_NotFoundCount;
+    stats.byteCount = m_ByteCount;
+    stats.connectionCount = m_ConnectionCount;
+    return stats;
+}
+
+void FakeInstagramServer::resetStats()
+{
+    m_RequestCount = 0;
+    m_RateLimitedCount = 0;
+    m_NotFoundCount = 0;
+    m_ByteCount = 0;
+    m_ConnectionCount = 0;
+}
+
+void FakeInstagramServer::generateBodies()
+{
+    m_Bodies.clear();
+    m_Bodies["posts"] = Fixtures::posts(m_PageSize);
+    m_Bodies["post"] = Fixtures::post();
+    m_Bodies["users"] = Fixtures::users(m_PageSize);
+    m_Bodies["user"] = Fixtures::user();
+    m_Bodies["comments"] = Fixtures::comments(m_PageSize);
+    m_Bodies["relationship"] = Fixtures::relationship();
+    m_Bodies["tags"] = Fixtures::tags(m_PageSize);
+    m_Bodies["tag"] = Fixtures::tag();
+    m_Bodies["locations"] = Fixtures::locations(m_PageSize);
+    m_Bodies["location"] = Fixtures::location();
+}
+
+void FakeInstagramServer::acceptThreadedFunction()
+{
+    int retryMillis = MIN_ACCEPT_RETRY_MILLIS;
+    while (m_IsRunning) {
+        const int connectionSocket = accept(m_ListenSocket, nullptr, nullptr);
+        if (connectionSocket < 0) {
+            if (m_IsRunning == false) {
+                break;
+            }
+
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+
+            //Out of descriptors or memory, which passes once connections close
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                if (retryMillis == MIN_ACCEPT_RETRY_MILLIS) {
+                    ofLogWarning("FakeInstagramServer") << __FUNCTION__ << ": Cannot accept connections, " << strerror(errno);
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(retryMillis));
+                retryMillis = std::min(retryMillis * 2, MAX_ACCEPT_RETRY_MILLIS);
+                continue;
+            }
+
+            ofLogError("FakeInstagramServer") << __FUNCTION__ << ": Stopped accepting connections, " << strerror(errno);
+            break;
+        }
+
+        retryMillis = MIN_ACCEPT_RETRY_MILLIS;
+        const int noDelay = 1;
+        setsockopt(connectionSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        m_ConnectionCount++;
+
+        //Detached, so a long test does not pile up the threads of closed connections. stop() waits for the count.
+        std::lock_guard<std::mutex> lock(m_ConnectionMutex);
+        m_ConnectionSockets.push_back(connectionSocket);
+        m_ConnectionThreadCount++;
+        std::thread(&FakeInstagramServer::connectionThreadedFunction, this, connectionSocket).detach();
+    }
+}
+
+void FakeInstagramServer::connectionThreadedFunction(int connectionSocket)
+{
+    std::string received;
+    char buffer[4096];
+    bool isOpen = true;
+    while (isOpen && m_IsRunning) {
+        //Requests are GETs without a body, so a request ends with the empty line after its headers
+        size_t headerEnd = received.find("\r\n\r\n");
+        while (headerEnd == std::string::npos) {
+            const ssize_t readCount = recv(connectionSocket, buffer, sizeof(buffer), 0);
+            if (readCount <= 0) {
+                isOpen = false;
+                break;
+            }
+
+            received.append(buffer, readCount);
+            headerEnd = received.find("\r\n\r\n");
+        }
+
+        if (isOpen == false) {
+            break;
+        }
+
+        const std::string header = received.substr(0, headerEnd);
+        received.erase(0, headerEnd + 4);
+
+        //"GET /v1/users/self/feed?access_token=... HTTP/1.1"
+        const size_t pathStart = header.find(' ') + 1;
+        const size_t pathEnd = header.find(' ', pathStart);
+        const std::string target = header.substr(pathStart, pathEnd - pathStart);
+        const bool isClosing = ofToLower(header).find("connection: close") != std::string::npos;
+
+        m_RequestCount++;
+        int remaining = 0;
+        Response response = {429, &RATE_LIMITED};
+        if (takeToken(remaining)) {
+            response = route(target.substr(0, target.find('?')));
+        }
+        else {
+            m_RateLimitedCount++;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(sampleLatency()));
+
+        std::string reply = "HTTP/1.1 " + ofToString(response.status) + " " + getStatusText(response.status) + "\r\n";
+        reply += "Content-Type: application/json; charset=utf-8\r\n";
+        reply += "Content-Length: " + ofToString(response.body->size()) + "\r\n";
+        reply += "X-Ratelimit-Remaining: " + ofToString(remaining) + "\r\n";
+        reply += isClosing ? "Connection: close\r\n\r\n" : "\r\n";
+        reply += *response.body;
+        m_ByteCount += response.body->size();
+
+        size_t sentCount = 0;
+        while (sentCount < reply.size()) {
+            const ssize_t writeCount = send(connectionSocket, reply.data() + sentCount, reply.size() - sentCount, MSG_NOSIGNAL);
+            if (writeCount <= 0) {
+                isOpen = false;
+                break;
+            }
+
+            sentCount += writeCount;
+        }
+
+        isOpen = isOpen && isClosing == false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_ConnectionMutex);
+    m_ConnectionSockets.erase(std::remove(m_ConnectionSockets.begin(), m_ConnectionSockets.end(), connectionSocket), m_ConnectionSockets.end());
+    close(connectionSocket);
+    m_ConnectionThreadCount--;
+    m_ConnectionCondition.notify_all();
+}
+
+FakeInstagramServer::Response FakeInstagramServer::route(const std::string &path)
+{
+    //"/v1/tags/sunset/media/recent/" is {"v1", "tags", "sunset", "media", "recent"}
+    const std::vector<std::string> parts = ofSplitString(path, "/", true, true);
+    std::string body = "";
+    if (parts.size() >= 3 && parts[0] == "v1") {
+        const std::string &endpoint = parts[1];
+        const std::string &last = parts.back();
+        const bool isSearch = parts[2] == "search";
+        if (endpoint == "users") {
+            if (isSearch || last == "follows" || last == "followed-by" || last == "requested-by") {
+                body = "users";
+            }
+            else if (last == "relationship") {
+                body = "relationship";
+            }
+            else if (last == "feed" || last == "recent" || last == "liked") {
+                body = "posts";
+            }
+            else if (parts.size() == 3) {
+                body = "user";
+            }
+        }
+        else if (endpoint == "media") {
+            if (isSearch || parts[2] == "popular") {
+                body = "posts";
+            }
+            else if (last == "comments") {
+                body = "comments";
+            }
+            else if (last == "likes") {
+                body = "users";
+            }
+            else if (parts.size() == 3 || parts[2] == "shortcode") {
+                body = "post";
+            }
+        }
+        else if (endpoint == "tags" || endpoint == "locations") {
+            const bool isTags = endpoint == "tags";
+            if (isSearch) {
+                body = isTags ? "tags" : "locations";
+            }
+            else if (last == "recent") {
+                body = "posts";
+            }
+            else if (parts.size() == 3) {
+                body = isTags ? "tag" : "location";
+            }
+        }
+    }
+
+    if (body.length() == 0) {
+        m_NotFoundCount++;
+        Response response = {400, &NOT_FOUND};
+        return response;
+    }
+
+    Response response = {200, &m_Bodies.find(body)->second};
+    return response;
+}
+
+bool FakeInstagramServer::takeToken(int &remaining)
+{
+    std::lock_guard<std::mutex> lock(m_RateMutex);
+    if (m_RateLimit <= 0.0) {
+        remaining = 5000;
+        return true;
+    }
+
+    const uint64_t now = ofGetElapsedTimeMicros();
+    m_Tokens = std::min<double>(m_Burst, m_Tokens + (now - m_LastRefillTime) / 1000000.0 * m_RateLimit);
+    m_LastRefillTime = now;
+    if (m_Tokens < 1.0) {
+        remaining = 0;
+        return false;
+    }
+
+    m_Tokens -= 1.0;
+    remaining = static_cast<int>(m_Tokens);
+    return true;
+}
+
+uint64_t FakeInstagramServer::sampleLatency()
+{
+    static thread_local std::mt19937 generator(std::random_device{}());
+    std::normal_distribution<double> distribution(0.0, 1.0);
+    const double median = m_LatencyMedian;
+    if (median <= 0.0) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(median * std::exp(m_LatencySigma * distribution(generator)) * 1000.0);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An HTTP server on the loopback interface that answers the /v1/users, /v1/media, /v1/tags and /v1/locations endpoints
+// with bodies shaped like the API's. Every response is delayed by a log-normally distributed latency, and requests above
+// the rate limit are answered with 429 and an OAuthRateLimitException like the API did. Each connection is served on its
+// own thread, so it is meant for loopback load tests and not for the open network. POSIX sockets only.
+class FakeInstagramServer
+{
+public:
+    struct Stats {
+        uint64_t requestCount = 0,
+                 rateLimitedCount = 0,
+                 notFoundCount = 0,
+                 byteCount = 0,
+                 connectionCount = 0;
+    };
+
+public:
+    FakeInstagramServer();
+    ~FakeInstagramServer();
+
+    // Port 0 picks a free one, see getPort()
+    bool start(int port = 0);
+    void stop();
+
+    int getPort() const;
+    // Host to pass to ofxInstagramHTTPTransport::setHost()
+    std::string getHost() const;
+
+    // Half of the responses take less than medianMillis. A larger sigma gives a longer tail, 0 makes every response take
+    // the median.
+    void setLatency(double medianMillis, double sigma);
+    // 0 turns the limit off. burst requests can be made at once before the limit applies.
+    void setRateLimit(double requestsPerSecond, int burst);
+    // Number of posts, users, comments, tags and locations in a page, call it before start()
+    void setPageSize(int pageSize);
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Response {
+        int status;
+        const std::string *body;
+    };
+
+    int m_ListenSocket, m_Port;
+    std::thread m_AcceptThread;
+    std::atomic<bool> m_IsRunning;
+
+    //The connection threads are detached, m_ConnectionThreadCount is how many are still running
+    std::vector<int> m_ConnectionSockets;
+    size_t m_ConnectionThreadCount;
+    std::mutex m_ConnectionMutex;
+    std::condition_variable m_ConnectionCondition;
+
+    std::atomic<double> m_LatencyMedian, m_LatencySigma;
+
+    //The token bucket of the rate limit
+    mutable std::mutex m_RateMutex;
+    double m_RateLimit, m_Tokens;
+    int m_Burst;
+    uint64_t m_LastRefillTime;
+
+    //Bodies by what they hold, generated by start()
+    int m_PageSize;
+    std::map<std::string, std::string> m_Bodies;
+
+    std::atomic<uint64_t> m_RequestCount, m_RateLimitedCount, m_NotFoundCount, m_ByteCount, m_ConnectionCount;
+
+private:
+    void generateBodies();
+    void acceptThreadedFunction();
+    void connectionThreadedFunction(int connectionSocket);
+    Response route(const std::string &path);
+    bool takeToken(int &remaining);
+    uint64_t sampleLatency();
+};
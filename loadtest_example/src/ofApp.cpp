@@ -0,0 +1,190 @@
+#include "ofApp.h"
+
+namespace
+{
+//Requests in flight during each phase, every phase runs for PHASE_DURATION
+const int CONCURRENCIES[] = {1, 4, 16, 64};
+const size_t PHASE_COUNT = sizeof(CONCURRENCIES) / sizeof(CONCURRENCIES[0]);
+const uint64_t PHASE_DURATION = 5000000;
+
+//Roughly what the API looked like from Europe, and its limit of 5000 requests an hour sped up
+const double LATENCY_MEDIAN_MILLIS = 80.0;
+const double LATENCY_SIGMA = 0.6;
+const double RATE_LIMIT = 400.0;
+const int RATE_LIMIT_BURST = 100;
+const int PAGE_SIZE = 20;
+
+//The share of each request in the mix follows from how often it is repeated in makeRequest()
+const int REQUEST_KIND_COUNT = 16;
+}
+
+//--------------------------------------------------------------
+void ofApp::setup()
+{
+    //Responses are delivered from update(), so the frame rate would otherwise add up to a frame to every request
+    ofSetFrameRate(1000);
+
+    m_Server.setPageSize(PAGE_SIZE);
+    m_Server.setLatency(LATENCY_MEDIAN_MILLIS, LATENCY_SIGMA);
+    m_Server.setRateLimit(RATE_LIMIT, RATE_LIMIT_BURST);
+    if (m_Server.start() == false) {
+        ofExit(1);
+        return;
+    }
+
+    m_Instagram.setup("TOKEN", "CLIENT_ID");
+    m_PhaseIndex = 0;
+    m_RequestIndex = 0;
+    startPhase();
+}
+//--------------------------------------------------------------
+void ofApp::update()
+{
+    if (m_PhaseIndex >= PHASE_COUNT) {
+        return;
+    }
+
+    m_Transport->update();
+    const ofxInstagramHTTPTransport::Stats stats = m_Transport->getStats();
+    const size_t inFlightCount = stats.queuedCount + stats.activeCount + stats.finishedCount;
+    if (m_IsDraining) {
+        if (inFlightCount == 0) {
+            finishPhase();
+        }
+
+        return;
+    }
+
+    if (ofGetElapsedTimeMicros() - m_PhaseStartTime >= PHASE_DURATION) {
+        m_IsDraining = true;
+        return;
+    }
+
+    for (size_t requestIndex = inFlightCount; requestIndex < static_cast<size_t>(CONCURRENCIES[m_PhaseIndex]); requestIndex++) {
+        makeRequest();
+    }
+}
+//--------------------------------------------------------------
+void ofApp::exit()
+{
+    if (m_Transport) {
+        m_Transport->stop();
+    }
+
+    m_Server.stop();
+}
+//--------------------------------------------------------------
+void ofApp::startPhase()
+{
+    //A new transport per phase, so every phase opens its own connections
+    m_Transport = std::make_shared<ofxInstagramHTTPTransport>(m_Instagram);
+    m_Transport->setHost(m_Server.getHost());
+    m_Transport->setup(CONCURRENCIES[m_PhaseIndex]);
+    m_Instagram.setTransport(m_Transport);
+
+    m_Instagram.getMetrics().clear();
+    m_Server.resetStats();
+    m_PostCount = 0;
+    m_IsDraining = false;
+    m_PhaseStartTime = ofGetElapsedTimeMicros();
+}
+//--------------------------------------------------------------
+void ofApp::finishPhase()
+{
+    const double seconds = (ofGetElapsedTimeMicros() - m_PhaseStartTime) / 1000000.0;
+    const std::map<std::string, ofxInstagramMetrics::Endpoint> endpoints = m_Instagram.getMetrics().getEndpoints();
+    const ofxInstagramMetrics::Endpoint total = m_Instagram.getMetrics().getTotal();
+    const FakeInstagramServer::Stats serverStats = m_Server.getStats();
+
+    auto rateLimitedIt = total.errorCounts.find("OAuthRateLimitException");
+    const uint64_t rateLimitedCount = rateLimitedIt == total.errorCounts.end() ? 0 : rateLimitedIt->second;
+    std::cout << "loadtest concurrency=" << CONCURRENCIES[m_PhaseIndex] << " seconds=" << seconds
+              << " requests=" << total.requestCount << " responses=" << total.responseCount
+              << " requests_per_s=" << total.responseCount / seconds
+              << " posts_per_s=" << m_PostCount / seconds
+              << " mb_per_s=" << total.byteCount / seconds / (1024.0 * 1024.0)
+              << " rate_limited=" << rateLimitedCount << " errors=" << total.errorCount - rateLimitedCount
+              << " server_requests=" << serverStats.requestCount << " server_connections=" << serverStats.connectionCount
+              << " latency_p50_ms=" << total.networkTime.getPercentile(50) / 1000.0
+              << " latency_p90_ms=" << total.networkTime.getPercentile(90) / 1000.0
+              << " latency_p99_ms=" << total.networkTime.getPercentile(99) / 1000.0
+              << " latency_max_ms=" << total.networkTime.getMax() / 1000.0
+              << " queue_p99_ms=" << total.queueTime.getPercentile(99) / 1000.0
+              << " decode_p99_ms=" << total.decodeTime.getPercentile(99) / 1000.0 << "\n";
+    for (const auto &endpoint : endpoints) {
+        printEndpoint(endpoint.first, endpoint.second, seconds);
+    }
+
+    m_Transport->stop();
+    m_PhaseIndex++;
+    if (m_PhaseIndex < PHASE_COUNT) {
+        startPhase();
+    }
+    else {
+        ofExit();
+    }
+}
+//--------------------------------------------------------------
+void ofApp::printEndpoint(const std::string &endpoint, const ofxInstagramMetrics::Endpoint &metrics, double seconds)
+{
+    std::cout << "loadtest_endpoint concurrency=" << CONCURRENCIES[m_PhaseIndex] << " endpoint=" << endpoint
+              << " responses=" << metrics.responseCount << " requests_per_s=" << metrics.responseCount / seconds
+              << " errors=" << metrics.errorCount
+              << " latency_p50_ms=" << metrics.networkTime.getPercentile(50) / 1000.0
+              << " latency_p99_ms=" << metrics.networkTime.getPercentile(99) / 1000.0 << "\n";
+}
+//--------------------------------------------------------------
+void ofApp::makeRequest()
+{
+    const auto countPosts = [this](ofxInstagramTypes::Posts posts) {
+        m_PostCount += posts.first.size();
+    };
+
+    //Mostly pages of posts, like an app that shows a feed
+    switch (m_RequestIndex++ % REQUEST_KIND_COUNT) {
+    case 0:
+    case 1:
+    case 2:
+        m_Instagram.getUserFeed(PAGE_SIZE, "self", countPosts);
+        break;
+    case 3:
+    case 4:
+        m_Instagram.getListOfTaggedObjectsNormal("sunset", PAGE_SIZE, countPosts);
+        break;
+    case 5:
+        m_Instagram.getRecentMediaFromLocation("213000000", countPosts);
+        break;
+    case 6:
+        m_Instagram.getUserRecentMedia("1000001", PAGE_SIZE, countPosts);
+        break;
+    case 7:
+        m_Instagram.getMediaInformation("1234567890123456789_0", [this](ofxInstagramTypes::PostData) {
+            m_PostCount++;
+        });
+        break;
+    case 8:
+        m_Instagram.getCommentsForMedia("1234567890123456789_0", [](std::vector<ofxInstagramTypes::Comment>) {});
+        break;
+    case 9:
+        m_Instagram.getListOfUsersWhoLikedMedia("1234567890123456789_0", [](std::vector<ofxInstagramTypes::UserInfo>) {});
+        break;
+    case 10:
+        m_Instagram.getUserInformation("1000001", [](ofxInstagramTypes::UserInfo) {});
+        break;
+    case 11:
+        m_Instagram.getWhoUserFollows("self", [](std::vector<ofxInstagramTypes::UserInfo>) {});
+        break;
+    case 12:
+        m_Instagram.getSearchUsers("user", PAGE_SIZE, [](std::vector<ofxInstagramTypes::UserInfo>) {});
+        break;
+    case 13:
+        m_Instagram.getInfoForTag("sunset", [](ofxInstagramTypes::TagInfo) {});
+        break;
+    case 14:
+        m_Instagram.searchForTags("sun", [](std::vector<ofxInstagramTypes::TagInfo>) {});
+        break;
+    default:
+        m_Instagram.searchForLocations("1000", "41.0256", "28.9741", [](std::vector<ofxInstagramTypes::Location>) {});
+        break;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxInstagram.h"
+#include "ofxInstagramHTTPTransport.h"
+#include "FakeInstagramServer.h"
+
+// Drives ofxInstagram against FakeInstagramServer with a fixed number of requests in flight, for each of the concurrency
+// levels in ofApp.cpp, and prints what it achieved.
+class ofApp : public ofBaseApp{
+
+	public:
+		void setup();
+		void update();
+		void exit();
+
+    private:
+        void startPhase();
+        void finishPhase();
+        void makeRequest();
+        void printEndpoint(const std::string &endpoint, const ofxInstagramMetrics::Endpoint &metrics, double seconds);
+
+        FakeInstagramServer m_Server;
+        ofxInstagram m_Instagram;
+        std::shared_ptr<ofxInstagramHTTPTransport> m_Transport;
+
+        size_t m_PhaseIndex;
+        uint64_t m_PhaseStartTime;
+        bool m_IsDraining;
+        size_t m_RequestIndex;
+        uint64_t m_PostCount;
+};
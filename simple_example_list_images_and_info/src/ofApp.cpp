@@ -3,46 +3,74 @@
 //--------------------------------------------------------------
 void ofApp::exit()
 {
-    getImages.stopThread();
+    prefetcher.clear();
+    mediaLoader.stop();
 }
 //--------------------------------------------------------------
 void ofApp::setup()
 {
     instagram.setup("YOUR-ACCESS-TOKEN","self");
     instagram.setCertFileLocation(ofToDataPath("ca-bundle.crt",false));
+    mediaLoader.setCertFileLocation(ofToDataPath("ca-bundle.crt",false));
+    mediaLoader.setup();
+
+    // One post per 160px row, images are loaded 6 rows ahead and dropped again 24 rows away from the screen
+    prefetcher.setLayout(160);
+    prefetcher.setImageSize(150, 150);
+    prefetcher.setPrefetchRows(6, 24);
+    prefetcher.onImageLoaded = [this](size_t index, ofxInstagramMediaLoader::Result &result) {
+        if (result.isSuccessful) {
+            textures[index].loadData(*result.pixels);
+        }
+    };
+
     scrollValue = 0;
 }
 //--------------------------------------------------------------
 void ofApp::update()
 {
+    mediaLoader.update();
+    prefetcher.update(-scrollValue, ofGetHeight());
 
+    // Textures of the rows the prefetcher let go of are freed as well
+    for (auto it = textures.begin(); it != textures.end();) {
+        if (prefetcher.getPixels(it->first) == nullptr) {
+            it = textures.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
 }
 //--------------------------------------------------------------
 void ofApp::draw()
 {
     ofBackground(0);
-    // Can scroll through images using mouse
+    // Can scroll through images using mouse, only the rows on screen are drawn
     ofPushMatrix();
     ofTranslate(0,scrollValue);
-    if (!images.empty()) {
-        for (int i = 0; i < images.size(); i++) {
-            if (images[i].isAllocated()) {
-                images[i].draw(10, 10+(i*160), 150,150);
-                ofDrawBitmapString("Username: "+instagram.getBasicData()[i].user, 170,20+(i*160));
-                ofDrawBitmapString("Created At: "+instagram.getBasicData()[i].created_at, 170,35+(i*160));
-                ofDrawBitmapString("Image Url: "+instagram.getBasicData()[i].imageURL, 170,50+(i*160));
-                ofDrawBitmapString("Image ID: "+instagram.getBasicData()[i].imageID, 170,65+(i*160));
-                ofDrawBitmapString("Caption: "+instagram.getBasicData()[i].caption, 170, 80+(i*160));
-            }
+    const int firstRow = std::max(0, -scrollValue / 160);
+    const int lastRow = std::min<int>(prefetcher.size(), firstRow + ofGetHeight() / 160 + 2);
+    for (int i = firstRow; i < lastRow; i++) {
+        const ofxInstagramTypes::PostData &post = prefetcher.getPost(i);
+        auto texture = textures.find(i);
+        if (texture != textures.end()) {
+            texture->second.draw(10, 10+(i*160), 150,150);
         }
+        ofDrawBitmapString("Username: "+post.user.username, 170,20+(i*160));
+        ofDrawBitmapString("Created At: "+post.createdTime, 170,35+(i*160));
+        ofDrawBitmapString("Image Url: "+post.imageStandarResolution.url, 170,50+(i*160));
+        ofDrawBitmapString("Image ID: "+post.id, 170,65+(i*160));
+        ofDrawBitmapString("Caption: "+post.caption.text, 170, 80+(i*160));
     }
     ofPopMatrix();
-    
+
+    const ofxInstagramPrefetcher::Stats stats = prefetcher.getStats();
     stringstream info;
     info << "Press 'f' to Find User Data" << endl;
-    info << "Press 'S' to Save the Data" << endl;
     info << "Press 'r' to Reset the Scroll" << endl;
-    
+    info << "Posts: " << prefetcher.size() << " Images in memory: " << stats.residentCount << " Loading: " << stats.pendingCount << endl;
+
     ofDrawBitmapStringHighlight(info.str(), 5,ofGetHeight()-50);
 }
 //--------------------------------------------------------------
@@ -50,19 +78,12 @@ void ofApp::keyPressed(int key)
 {
     switch (key) {
         case 'f':
-            images.clear();
-            images.resize(12);
-            instagram.getUserFeed(12);
-            if(!instagram.getBasicData().empty())
-            {
-                for(int i = 0; i < instagram.getBasicData().size(); i++)
-                {
-                    getImages.loadFromURL(images[i], instagram.getBasicData()[i].imageURL);
-                }
-            }
-            break;
-        case 'S':
-            instagram.saveJson("myFile");
+            // Only the first page is asked for here, the prefetcher gets the next ones as the list is scrolled
+            instagram.getUserFeed(12, "self", [this](ofxInstagramTypes::Posts posts) {
+                prefetcher.clear();
+                textures.clear();
+                prefetcher.append(posts);
+            });
             break;
         case 'r':
             scrollValue = 0;
@@ -100,6 +121,5 @@ void ofApp::mouseReleased(int x, int y, int button)
 //--------------------------------------------------------------
 void ofApp::mouseScrolled(int x, int y, float scrollX, float scrollY )
 {
-    instagram.mouseScroll(scrollY);
     scrollValue += scrollY*50;
 }
\ No newline at end of file
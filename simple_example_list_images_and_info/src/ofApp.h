@@ -1,8 +1,9 @@
 #pragma once
 
 #include "ofMain.h"
-#include "ofxThreadedImageLoader.h"
 #include "ofxInstagram.h"
+#include "ofxInstagramMediaLoader.h"
+#include "ofxInstagramPrefetcher.h"
 
 class ofApp : public ofBaseApp{
 
@@ -22,9 +23,9 @@ class ofApp : public ofBaseApp{
         void mouseScrolled(int x, int y, float scrollX, float scrollY);
 
         ofxInstagram instagram;
-        ofxThreadedImageLoader getImages;
-        deque<ofImage> images;
-    
-        ofVec2f scrollAmount;
+        ofxInstagramMediaLoader mediaLoader;
+        ofxInstagramPrefetcher prefetcher{instagram, mediaLoader};
+        map<size_t, ofTexture> textures;
+
         int scrollValue;
 };
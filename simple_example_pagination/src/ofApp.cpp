@@ -15,7 +15,7 @@ void ofApp::update()
 void ofApp::draw()
 {
     ofBackground(0);
-    instagram.drawJSON(10);
+    jsonView.draw(instagram, 10);
     for (int i = 0; i < paginationIds.size(); i++) {
         ofDrawBitmapStringHighlight(paginationIds[i], 5,10+(i*15));
     }
@@ -72,5 +72,5 @@ void ofApp::mouseReleased(int x, int y, int button)
 //--------------------------------------------------------------
 void ofApp::mouseScrolled(int x, int y, float scrollX, float scrollY)
 {
-    instagram.mouseScroll(scrollY);
+    jsonView.mouseScroll(scrollY);
 }
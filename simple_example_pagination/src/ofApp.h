@@ -2,6 +2,7 @@
 
 #include "ofMain.h"
 #include "ofxInstagram.h"
+#include "ofxInstagramJSONView.h"
 
 class ofApp : public ofBaseApp{
 
@@ -18,5 +19,6 @@ class ofApp : public ofBaseApp{
         void mouseScrolled(int x, int y, float scrollX, float scrollY);
     
         ofxInstagram instagram;
+        ofxInstagramJSONView jsonView;
         vector<string> paginationIds;
 };
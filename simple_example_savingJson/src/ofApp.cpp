@@ -5,6 +5,12 @@ void ofApp::setup()
 {
     instagram.setup("6305138.976ac05.b29d71cfabee48d4a17883c7ce929fee","self");
     instagram.setCertFileLocation(ofToDataPath("ca-bundle.crt",false));
+
+    // Every feed page that arrives is appended to the archive, one post per line
+    exporter.open(ofToDataPath("myFile.ndjson"), true);
+    instagram.onUserFeedReceived = [this](ofxInstagramTypes::Posts posts) {
+        exporter.write(posts);
+    };
 }
 //--------------------------------------------------------------
 void ofApp::update()
@@ -15,7 +21,7 @@ void ofApp::update()
 void ofApp::draw()
 {
     ofBackground(0);
-    instagram.drawJSON(10);
+    jsonView.draw(instagram, 10);
     if (!images.empty()) {
         for (int i = 0; i < images.size(); i++) {
             ofSetColor(255, 255, 255);
@@ -52,7 +58,7 @@ void ofApp::keyPressed(int key)
             }
             break;
         case 'S':
-            instagram.saveJson("myFile");
+            exporter.flush();
             break;
         default:
             break;
@@ -83,5 +89,5 @@ void ofApp::mouseReleased(int x, int y, int button)
 //--------------------------------------------------------------
 void ofApp::mouseScrolled(int x, int y, float scrollX, float scrollY)
 {
-    instagram.mouseScroll(scrollY);
+    jsonView.mouseScroll(scrollY);
 }
@@ -2,6 +2,8 @@
 
 #include "ofMain.h"
 #include "ofxInstagram.h"
+#include "ofxInstagramJSONView.h"
+#include "ofxInstagramExporter.h"
 #include "ofxThreadedImageLoader.h"
 #include "ImageExtension.h"
 
@@ -20,6 +22,8 @@ class ofApp : public ofBaseApp{
         void mouseScrolled(int x, int y, float scrollX,float scrollY);
     
         ofxInstagram instagram;
+        ofxInstagramJSONView jsonView;
+        ofxInstagramExporter exporter;
         ofxThreadedImageLoader getImages;
         deque<ofImageExtension> images;
 };
@@ -3,41 +3,70 @@
 //--------------------------------------------------------------
 void ofApp::exit()
 {
-    getImages.stopThread();
+    mediaLoader.stop();
 }
 //--------------------------------------------------------------
 void ofApp::setup()
 {
     instagram.setup("YOUR-ACCESS-TOKEN","self");
     instagram.setCertFileLocation(ofToDataPath("ca-bundle.crt",false));
+    mediaLoader.setCertFileLocation(ofToDataPath("ca-bundle.crt",false));
+    mediaLoader.setup();
 }
 //--------------------------------------------------------------
 void ofApp::update()
 {
-
+    mediaLoader.update();
+}
+//--------------------------------------------------------------
+void ofApp::loadImages(ofxInstagramTypes::Posts posts)
+{
+    atlas.clear();
+    mediaIDs.clear();
+    for (size_t i = 0; i < std::min<size_t>(posts.first.size(), 12); i++) {
+        mediaIDs.push_back(posts.first[i].id);
+        // The images are drawn at 250x250, so there is no need for the standard resolution and the loader hands back
+        // pixels that are already scaled down
+        mediaLoader.load(posts.first[i], 250, 250, [this](ofxInstagramMediaLoader::Result &result) {
+            if (result.isSuccessful && std::find(mediaIDs.begin(), mediaIDs.end(), result.mediaID) != mediaIDs.end()) {
+                // The pixels are copied into the atlas and go back to the loader's pool once the handle is released
+                atlas.add(result.mediaID, *result.pixels);
+            }
+        });
+    }
 }
 //--------------------------------------------------------------
 void ofApp::draw()
 {
     ofBackground(0);
-    instagram.drawJSON(10);
-    
-    if (!images.empty()) {
-        for (int i = 0; i < images.size(); i++) {
-            ofSetColor(255, 255, 255);
-            if (images[i].isAllocated()) {
-                if(i <= 3) {
-                    images[i].draw(5+(i*255), 5, 250,250);
-                }
-                else if(i >= 4 && i <= 7) {
-                    images[i].draw(5-(4*255)+(i*255), 5+255, 250,250);
-                }
-                else if(i >= 8 && i <= 11) {
-                    images[i].draw(5-(8*255)+(i*255), 5+2*255, 250,250);
-                }
-            }
+    jsonView.draw(instagram, 10);
+
+    // Only the pages that changed since the last frame are uploaded
+    pages.resize(atlas.getPageCount());
+    for (size_t page = 0; page < atlas.getPageCount(); page++) {
+        if (atlas.isPageDirty(page)) {
+            pages[page].loadData(atlas.getPagePixels(page));
+            atlas.setPageClean(page);
         }
     }
+
+    // One mesh and one texture bind per atlas page instead of one per image
+    vector<ofMesh> meshes(pages.size());
+    for (size_t i = 0; i < mediaIDs.size(); i++) {
+        const ofxInstagramAtlas::Region *region = atlas.getRegion(mediaIDs[i]);
+        if (region != nullptr) {
+            meshes[region->page].setMode(OF_PRIMITIVE_TRIANGLES);
+            atlas.addToMesh(meshes[region->page], mediaIDs[i], ofRectangle(5+(i%4)*255, 5+(i/4)*255, 250, 250), !ofGetUsingArbTex());
+        }
+    }
+
+    ofSetColor(255, 255, 255);
+    for (size_t page = 0; page < meshes.size(); page++) {
+        pages[page].bind();
+        meshes[page].draw();
+        pages[page].unbind();
+    }
+
     stringstream info;
     info << "Press 'c' to clear the Images" << endl;
     info << "Press 'l' to Get Liked Media" << endl;
@@ -50,31 +79,21 @@ void ofApp::keyPressed(int key)
 {
     switch (key) {
         case 'l':
-            images.clear();
-            images.resize(12);
-            instagram.getUserLikedMedia(12);
-            if (!instagram.getImageURL().empty())
-            {
-                for ( int i = 0; i < instagram.getImageURL().size(); i++)
-                {
-                    getImages.loadFromURL(images[i], instagram.getImageURL()[i]);
-                }
-            }
+            mediaLoader.cancelAll();
+            instagram.getUserLikedMedia(12, "self", [this](ofxInstagramTypes::Posts posts) {
+                loadImages(posts);
+            });
             break;
         case 'f':
-            images.clear();
-            images.resize(12);
-            instagram.getUserFeed(12);
-            if (!instagram.getImageURL().empty())
-            {
-                for ( int i = 0; i < instagram.getImageURL().size(); i++)
-                {
-                    getImages.loadFromURL(images[i], instagram.getImageURL()[i]);
-                }
-            }
+            mediaLoader.cancelAll();
+            instagram.getUserFeed(12, "self", [this](ofxInstagramTypes::Posts posts) {
+                loadImages(posts);
+            });
             break;
         case 'c':
-            images.clear();
+            mediaLoader.cancelAll();
+            atlas.clear();
+            mediaIDs.clear();
             break;
         default:
             break;
@@ -108,5 +127,5 @@ void ofApp::mouseReleased(int x, int y, int button)
 //--------------------------------------------------------------
 void ofApp::mouseScrolled(int x, int y, float scrollX, float scrollY)
 {
-    instagram.mouseScroll(scrollY);
+    jsonView.mouseScroll(scrollY);
 }
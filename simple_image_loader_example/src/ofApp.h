@@ -2,7 +2,9 @@
 
 #include "ofMain.h"
 #include "ofxInstagram.h"
-#include "ofxThreadedImageLoader.h"
+#include "ofxInstagramJSONView.h"
+#include "ofxInstagramMediaLoader.h"
+#include "ofxInstagramAtlas.h"
 
 class ofApp : public ofBaseApp{
 
@@ -22,6 +24,11 @@ class ofApp : public ofBaseApp{
         void mouseScrolled(int x, int y, float scrollX,float scrollY);
 		
         ofxInstagram instagram;
-        ofxThreadedImageLoader  getImages;
-        deque<ofImage> images;
+        ofxInstagramJSONView jsonView;
+        ofxInstagramMediaLoader mediaLoader;
+        ofxInstagramAtlas atlas;
+        vector<ofTexture> pages;
+        vector<string> mediaIDs;
+
+        void loadImages(ofxInstagramTypes::Posts posts);
 };
@@ -1,8 +1,31 @@
 #include "ofxInstagram.h"
-#include "ofMain.h"
-#include <io.h>
+#include <thread>
+#include "ofLog.h"
+#include "ofUtils.h"
 using namespace ofxInstagramTypes;
 
+namespace
+{
+//ofHttpRequest takes its ID from a private counter that is not atomic, so requests are only created, here or by
+//ofLoadURLAsync(), while this is locked. Nothing else is done under it.
+std::mutex requestIDMutex;
+
+//The response that is being delivered on this thread, for the decode time and the spans recorded while decoding it
+struct Delivery {
+    int requestID = -1;
+    std::string endpoint = "";
+    uint64_t decodeTime = 0;
+};
+
+thread_local Delivery *currentDelivery = nullptr;
+
+ofHttpRequest createRequest(const std::string &url, const std::string &requestName)
+{
+    std::lock_guard<std::mutex> lock(requestIDMutex);
+    return ofHttpRequest(url, requestName);
+}
+}
+
 ofxInstagram::ofxInstagram()
     : m_UsersURL("https://api.instagram.com/v1/users/")
     , m_MediaURL("https://api.instagram.com/v1/media/")
@@ -35,15 +58,20 @@ ofxInstagram::ofxInstagram()
     , m_RequestLocationInfo("request_location_info")
     , m_RequestLocationRecentMedia("request_location_recent_media")
     , m_RequestLocationSearch("request_location_search")
+      //Pagination Requests
+    , m_RequestNextPage("request_next_page")
+    , m_RequestNextUsersPage("request_next_users_page")
     , m_Response()
     , m_AuthToken("")
     , m_ClientID("")
     , m_ResponseData("")
     , m_CertPath("")
-    , m_ScrollValue(0)
-    , m_ScrollAmount(0, 0)
-    , m_ClickOrigin(0, 0)
-    , m_ReleasePos(0, 0)
+    , m_UnregisteredRequestCount(0)
+    , m_PostStore(nullptr)
+    , m_Transport(nullptr)
+    , m_Recorder(nullptr)
+    , m_Executor(nullptr)
+    , m_Tracer(nullptr)
 {
 
 }
@@ -51,7 +79,6 @@ ofxInstagram::ofxInstagram()
 void ofxInstagram::setup(std::string auth_token, std::string clientID)
 {
     ofRegisterURLNotification(this);
-    m_ScrollValue = 0;
     // Set the Tokens
     m_AuthToken = auth_token;
     m_ClientID = clientID;
@@ -62,26 +89,6 @@ void ofxInstagram::setCertFileLocation(std::string path)
     m_CertPath = path;
 }
 
-void ofxInstagram::drawJSON(int x)
-{
-    ofPushMatrix();
-    {
-        ofTranslate(x, m_ScrollValue);
-        ofDrawBitmapString(getParsedJSONString(), 0, 0);
-    }
-    ofPopMatrix();
-}
-
-void ofxInstagram::mouseScroll(int scrollY)
-{
-    m_ScrollValue += scrollY;
-}
-
-void ofxInstagram::resetScroll()
-{
-    m_ScrollValue = 0;
-}
-
 // *                        USER ENDPOINTS
 // *  GET Info
 // *  GET User Feed
@@ -89,60 +96,77 @@ void ofxInstagram::resetScroll()
 // *  GET User Like Media
 // *  GET User Search Users
 
-void ofxInstagram::getUserInformation(std::string who, std::function<void(UserInfo)> callback)
+int ofxInstagram::getUserInformation(std::string who, std::function<void(UserInfo)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserInfoReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructUserInfo(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << who << "/?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestUserInfo));
+    const int requestID = loadURL(url.str(), m_RequestUserInfo, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "Getting Info about User: This is your request: " << url.str()  << "\n";
 #endif _DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getUserFeed(int count, std::string username, std::function<void(Posts)> callback, std::string minID, std::string maxID)
+int ofxInstagram::getUserFeed(int count, std::string username, std::function<void(Posts)> callback, std::string minID, std::string maxID,
+                              FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserFeedReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << username << "/feed?access_token=" << m_AuthToken << "&count=" << std::to_string(count);
 
     if (minID.length() != 0) {
-        url << "&minID=" << minID;
+        url << "&min_id=" << minID;
     }
 
     if (maxID.length() != 0) {
-        url << "&maxID=" << maxID;
+        url << "&max_id=" << maxID;
     }
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestUserFeed));
+    const int requestID = loadURL(url.str(), m_RequestUserFeed, handler, onFailure, buildStartTime);
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "Getting Users Feed: This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getUserRecentMedia(std::string who, int count, std::function<void(Posts)> callback, std::string maxTimestamp, std::string minTimestamp,
-                                      std::string minID, std::string maxID)
+int ofxInstagram::getUserRecentMedia(std::string who, int count, std::function<void(Posts)> callback, std::string maxTimestamp, std::string minTimestamp,
+                                     std::string minID, std::string maxID, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserRecentMediaReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << who << "/media/recent?access_token=" << m_AuthToken << "&count=" << std::to_string(count);
 
     if (minID.length() != 0) {
-        url << "&minID=" << minID;
+        url << "&min_id=" << minID;
     }
 
     if (maxID.length() != 0) {
-        url << "&maxID=" << maxID;
+        url << "&max_id=" << maxID;
     }
 
     if (minTimestamp.length() != 0) {
@@ -153,38 +177,50 @@ void ofxInstagram::getUserRecentMedia(std::string who, int count, std::function<
         url << "&max_timestamp=" << maxTimestamp;
     }
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestUserRecentMedia));
+    const int requestID = loadURL(url.str(), m_RequestUserRecentMedia, handler, onFailure, buildStartTime);
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "Getting " << who << "'s Feed: This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getUserLikedMedia(int count, std::string username, std::function<void(Posts)> callback, std::string maxLikeID)
+int ofxInstagram::getUserLikedMedia(int count, std::string username, std::function<void(Posts)> callback, std::string maxLikeID, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserLikedMediaReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << username << "/media/liked?access_token=" << m_AuthToken << "&count=" << std::to_string(count);
 
     if (maxLikeID.length() != 0) {
-        url << "&max_like_ID=" << maxLikeID;
+        url << "&max_like_id=" << maxLikeID;
     }
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestUserLikedMedia));
+    const int requestID = loadURL(url.str(), m_RequestUserLikedMedia, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getSearchUsers(std::string query, int count, std::function<void(std::vector<UserInfo>)> callback)
+int ofxInstagram::getSearchUsers(std::string query, int count, std::function<void(std::vector<UserInfo>)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserSearchReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructUserInfos(json));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << "search?access_token=" << m_AuthToken << "&count=" << std::to_string(count);
 
@@ -192,10 +228,12 @@ void ofxInstagram::getSearchUsers(std::string query, int count, std::function<vo
         url << "&q=" << query;
     }
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestUserSearch));
+    const int requestID = loadURL(url.str(), m_RequestUserSearch, handler, onFailure, buildStartTime);
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
 // *                RELATIONSHIP ENDPOINTS
@@ -205,65 +243,125 @@ void ofxInstagram::getSearchUsers(std::string query, int count, std::function<vo
 // *  GET relationship to User
 // *  POST change Relationship to User
 
-void ofxInstagram::getWhoUserFollows(std::string who, std::function<void(std::vector<UserInfo>)> callback)
+int ofxInstagram::getWhoUserFollows(std::string who, std::function<void(std::vector<UserInfo>)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserFollowingReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructUserInfos(json));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << who << "/follows?access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestRelationshipFollowing));
+    const int requestID = loadURL(url.str(), m_RequestRelationshipFollowing, handler, onFailure, buildStartTime);
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getUserFollowers(std::string who, std::function<void(std::vector<UserInfo>)> callback)
+int ofxInstagram::getUserFollowers(std::string who, std::function<void(std::vector<UserInfo>)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserFollowersReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructUserInfos(json));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << who << "/followed-by?access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestRelationshipFollowers));
+    const int requestID = loadURL(url.str(), m_RequestRelationshipFollowers, handler, onFailure, buildStartTime);
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getWhoHasRequestedToFollow(std::string who, std::function<void(std::vector<UserInfo>)> callback)
+int ofxInstagram::getWhoUserFollowsPage(std::string who, std::function<void(Users)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = [this, callback](const ofxJSONElement & json) {
+        callback(constructUsers(json));
+    };
+
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
+    std::stringstream url;
+    url << m_UsersURL << who << "/follows?access_token=" << m_AuthToken;
+
+    const int requestID = loadURL(url.str(), m_RequestRelationshipFollowing, handler, onFailure, buildStartTime);
+#ifdef _DEBUG
+    std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
+#endif //_DEBUG
+
+    return requestID;
+}
+
+int ofxInstagram::getUserFollowersPage(std::string who, std::function<void(Users)> callback, FailureHandler onFailure)
+{
+    ResponseHandler handler = [this, callback](const ofxJSONElement & json) {
+        callback(constructUsers(json));
+    };
+
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
+    std::stringstream url;
+    url << m_UsersURL << who << "/followed-by?access_token=" << m_AuthToken;
+
+    const int requestID = loadURL(url.str(), m_RequestRelationshipFollowers, handler, onFailure, buildStartTime);
+#ifdef _DEBUG
+    std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
+#endif //_DEBUG
+
+    return requestID;
+}
+
+int ofxInstagram::getWhoHasRequestedToFollow(std::string who, std::function<void(std::vector<UserInfo>)> callback, FailureHandler onFailure)
+{
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserFollowRequestsReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructUserInfos(json));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << who << "/requested-by?access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestRelationshipFollowRequests));
+    const int requestID = loadURL(url.str(), m_RequestRelationshipFollowRequests, handler, onFailure, buildStartTime);
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getRelationshipToUser(std::string who, std::function<void(Relationship)> callback)
+int ofxInstagram::getRelationshipToUser(std::string who, std::function<void(Relationship)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onUserRelationshipReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructRelationship(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_UsersURL << who << "/relationship?access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestRelationshipUserRel));
+    const int requestID = loadURL(url.str(), m_RequestRelationshipUserRel, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
 void ofxInstagram::changeRelationshipToUser(std::string who, std::string action, std::function<void(UserInfo)> callback)
@@ -280,43 +378,59 @@ void ofxInstagram::changeRelationshipToUser(std::string who, std::string action,
 // *  GET Popular Media
 // *
 
-void ofxInstagram::getMediaInformation(std::string mediaID, std::function<void(PostData)> callback)
+int ofxInstagram::getMediaInformation(std::string mediaID, std::function<void(PostData)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onMediaInformationReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPost(json["data"], callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_MediaURL << mediaID << "?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestMediaInformation));
+    const int requestID = loadURL(url.str(), m_RequestMediaInformation, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getMediaInfoUsingShortcode(std::string shortcode, std::function<void(PostData)> callback)
+int ofxInstagram::getMediaInfoUsingShortcode(std::string shortcode, std::function<void(PostData)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onMediaInformationReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPost(json["data"], callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_MediaURL << "shortcode/" << shortcode << "?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestMediaInformation));
+    const int requestID = loadURL(url.str(), m_RequestMediaInformation, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::searchMedia(std::string lat, std::string lng, std::string min_timestamp, std::string max_timestamp, int distance,
-                               std::function<void(Posts)> callback)
+int ofxInstagram::searchMedia(std::string lat, std::string lng, std::string min_timestamp, std::string max_timestamp, int distance,
+                              std::function<void(Posts)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onMediaSearchReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_MediaURL << "search?access_token=" << m_AuthToken;
 
@@ -337,41 +451,55 @@ void ofxInstagram::searchMedia(std::string lat, std::string lng, std::string min
     }
     url << "&distance=" << distance;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestMediaSearch));
+    const int requestID = loadURL(url.str(), m_RequestMediaSearch, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::searchMedia(const string &tag, std::function<void (Posts)> callback)
+int ofxInstagram::searchMedia(const string &tag, std::function<void (Posts)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onMediaSearchReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_TagsURL << tag << "/media/recent/" << "?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestMediaSearch));
+    const int requestID = loadURL(url.str(), m_RequestMediaSearch, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getPopularMedia(std::function<void(Posts)> callback)
+int ofxInstagram::getPopularMedia(std::function<void(Posts)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onMediaPopularReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_MediaURL << "popular?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestMediaPopular));
+    const int requestID = loadURL(url.str(), m_RequestMediaPopular, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
 // *
@@ -381,19 +509,25 @@ void ofxInstagram::getPopularMedia(std::function<void(Posts)> callback)
 // *  DELETE Comment on Media Object - TODO
 // *
 
-void ofxInstagram::getCommentsForMedia(std::string mediaID, std::function<void(std::vector<Comment>)> callback)
+int ofxInstagram::getCommentsForMedia(std::string mediaID, std::function<void(std::vector<Comment>)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onCommentsForMediaReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructComments(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_MediaURL << mediaID << "/comments?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestCommentForMedia));
+    const int requestID = loadURL(url.str(), m_RequestCommentForMedia, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
 // *                        LIKE ENDPOINTS
@@ -402,19 +536,25 @@ void ofxInstagram::getCommentsForMedia(std::string mediaID, std::function<void(s
 // *  POST unlike Media - TODO
 // *
 
-void ofxInstagram::getListOfUsersWhoLikedMedia(std::string mediaID, std::function<void(std::vector<UserInfo>)> callback)
+int ofxInstagram::getListOfUsersWhoLikedMedia(std::string mediaID, std::function<void(std::vector<UserInfo>)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onLikeListReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructUserInfos(json));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_MediaURL << mediaID << "/likes?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestLikesUserListForMedia));
+    const int requestID = loadURL(url.str(), m_RequestLikesUserListForMedia, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
 // *
@@ -424,28 +564,38 @@ void ofxInstagram::getListOfUsersWhoLikedMedia(std::string mediaID, std::functio
 // *  GET Search for Tag Objects
 // *
 
-void ofxInstagram::getInfoForTag(std::string tagname, std::function<void(TagInfo)> callback)
+int ofxInstagram::getInfoForTag(std::string tagname, std::function<void(TagInfo)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onTagInfoReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructTagInfo(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_TagsURL << tagname << "?access_token=" << m_AuthToken;
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestTagInfo));
+    const int requestID = loadURL(url.str(), m_RequestTagInfo, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getListOfTaggedObjectsNormal(std::string tagname, int count, std::function<void(Posts)> callback, std::string min_tagID,
-        std::string max_tagID)
+int ofxInstagram::getListOfTaggedObjectsNormal(std::string tagname, int count, std::function<void(Posts)> callback, std::string min_tagID,
+        std::string max_tagID, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onPostsForTagReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_TagsURL << tagname << "/media/recent?access_token=" << m_AuthToken;
 
@@ -459,15 +609,20 @@ void ofxInstagram::getListOfTaggedObjectsNormal(std::string tagname, int count,
 
     url << "&count=" << count;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestTagPostList));
+    return loadURL(url.str(), m_RequestTagPostList, handler, onFailure, buildStartTime);
 }
 
-void ofxInstagram::getListOfTaggedObjectsPagination(std::string tagname, int count, std::function<void(Posts)> callback, std::string max_tagID)
+int ofxInstagram::getListOfTaggedObjectsPagination(std::string tagname, int count, std::function<void(Posts)> callback, std::string max_tagID,
+                                                   FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onPostsForTagReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_TagsURL << tagname << "/media/recent?access_token=" << m_AuthToken;
 
@@ -477,23 +632,29 @@ void ofxInstagram::getListOfTaggedObjectsPagination(std::string tagname, int cou
 
     url << "&count=" << count;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestTagPostList));
+    return loadURL(url.str(), m_RequestTagPostList, handler, onFailure, buildStartTime);
 }
 
-void ofxInstagram::searchForTags(std::string query, std::function<void(std::vector<TagInfo>)> callback)
+int ofxInstagram::searchForTags(std::string query, std::function<void(std::vector<TagInfo>)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onTagSearchReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructTagInfos(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_TagsURL << "search?q=" << query << "&access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestTagSearch));
+    const int requestID = loadURL(url.str(), m_RequestTagSearch, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
 // *                   LOCATIONS ENDPOINTS
@@ -501,29 +662,39 @@ void ofxInstagram::searchForTags(std::string query, std::function<void(std::vect
 // *  GET Recent Media from Location
 // *  GET Search for Locations by LAT,LNG
 
-void ofxInstagram::getInfoAboutLocation(std::string locationID, std::function<void(Location)> callback)
+int ofxInstagram::getInfoAboutLocation(std::string locationID, std::function<void(Location)> callback, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onLocationInfoReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructLocation(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_LocationsURL << locationID << "?access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestLocationInfo));
+    const int requestID = loadURL(url.str(), m_RequestLocationInfo, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
 }
 
-void ofxInstagram::getRecentMediaFromLocation(std::string locationID, std::function<void(Posts)> callback, std::string minTimestamp, std::string maxTimestamp,
-        std::string minID, std::string maxID)
+int ofxInstagram::getRecentMediaFromLocation(std::string locationID, std::function<void(Posts)> callback, std::string minTimestamp, std::string maxTimestamp,
+        std::string minID, std::string maxID, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onPostsFromLocationReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            dispatchPosts(json, callback);
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_LocationsURL << locationID << "/media/recent?access_token=" << m_AuthToken;
 
@@ -542,17 +713,21 @@ void ofxInstagram::getRecentMediaFromLocation(std::string locationID, std::funct
     if (maxTimestamp.length() != 0) {
         url << "&max_timestamp=" << maxTimestamp;
     }
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestLocationRecentMedia));
+    return loadURL(url.str(), m_RequestLocationRecentMedia, handler, onFailure, buildStartTime);
 }
 
-void ofxInstagram::searchForLocations(std::string distance, std::string lat, std::string lng, std::function<void(std::vector<Location>)> callback,
-                                      std::string facebook_PlacesID,
-                                      std::string foursquareID)
+int ofxInstagram::searchForLocations(std::string distance, std::string lat, std::string lng, std::function<void(std::vector<Location>)> callback,
+                                     std::string facebook_PlacesID,
+                                     std::string foursquareID, FailureHandler onFailure)
 {
+    ResponseHandler handler = nullptr;
     if (callback) {
-        onLocationSearchReceived = callback;
+        handler = [this, callback](const ofxJSONElement & json) {
+            callback(constructLocations(json["data"]));
+        };
     }
 
+    const uint64_t buildStartTime = ofGetElapsedTimeMicros();
     std::stringstream url;
     url << m_LocationsURL << "search?";
 
@@ -575,62 +750,412 @@ void ofxInstagram::searchForLocations(std::string distance, std::string lat, std
     url << "&distance=" << distance;
     url << "&access_token=" << m_AuthToken;
 
-    m_RequestIDs.push_back(ofLoadURLAsync(url.str(), m_RequestLocationSearch));
+    const int requestID = loadURL(url.str(), m_RequestLocationSearch, handler, onFailure, buildStartTime);
 
 #ifdef _DEBUG
     std::cout << __FUNCTION__ << ": " << "This is your request: " << url.str()  << "\n";
 #endif //_DEBUG
+
+    return requestID;
+}
+
+// *
+// *                        PAGINATION
+// *  GET Next Page
+// *
+
+int ofxInstagram::getNextPage(const Pagination &pagination, std::function<void(Posts)> callback, FailureHandler onFailure)
+{
+    if (pagination.nextURL.length() == 0) {
+        return -1;
+    }
+
+    //The next page can come from any endpoint that returns posts, so it is always handled here
+    ResponseHandler handler = [this, callback](const ofxJSONElement & json) {
+        dispatchPosts(json, callback);
+    };
+
+    //next_url already carries the access token and the paging parameters
+    const int requestID = loadURL(pagination.nextURL, m_RequestNextPage, handler, onFailure);
+
+#ifdef _DEBUG
+    std::cout << __FUNCTION__ << ": " << "This is your request: " << pagination.nextURL  << "\n";
+#endif //_DEBUG
+
+    return requestID;
+}
+
+int ofxInstagram::getNextUsersPage(const Pagination &pagination, std::function<void(Users)> callback, FailureHandler onFailure)
+{
+    if (pagination.nextURL.length() == 0) {
+        return -1;
+    }
+
+    ResponseHandler handler = [this, callback](const ofxJSONElement & json) {
+        callback(constructUsers(json));
+    };
+
+    //next_url already carries the access token and the cursor
+    const int requestID = loadURL(pagination.nextURL, m_RequestNextUsersPage, handler, onFailure);
+
+#ifdef _DEBUG
+    std::cout << __FUNCTION__ << ": " << "This is your request: " << pagination.nextURL  << "\n";
+#endif //_DEBUG
+
+    return requestID;
+}
+
+int ofxInstagram::request(const std::string &url, const std::string &requestName)
+{
+    //Next pages have no member callback, they can only go to the post store
+    ResponseHandler handler = nullptr;
+    if (requestName == m_RequestNextPage) {
+        handler = [this](const ofxJSONElement & json) {
+            dispatchPosts(json, nullptr);
+        };
+    }
+
+    return loadURL(url, requestName, handler);
 }
 
 Meta ofxInstagram::getLastError() const
 {
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(m_ResponseMutex);
+        data = m_Response.data.getText();
+    }
+
     ofxJSONElement json;
-    json.parse(m_Response.data);
+    json.parse(data);
     return constructMeta(json["meta"]);
 }
 
 void ofxInstagram::urlResponse(ofHttpResponse &response)
 {
-    auto idIndex = std::find(m_RequestIDs.begin(), m_RequestIDs.end(), response.request.getID());
-    if (idIndex == m_RequestIDs.end()) {
-        return;
+    const uint64_t receiveTime = ofGetElapsedTimeMicros();
+    const int requestID = response.request.getID();
+    PendingRequest request;
+    if (takeRequest(requestID, request) == false) {
+        //ofLoadURLAsync() may answer before the thread that called it registered the request, which only takes the lock
+        //of its shard. Every response of ofLoadURLAsync() comes through here, also the ones of other clients and of the
+        //app itself, so unknown IDs are not an error.
+        bool isTaken = false;
+        while (isTaken == false && m_UnregisteredRequestCount.load() > 0) {
+            std::this_thread::yield();
+            isTaken = takeRequest(requestID, request);
+        }
+
+        if (isTaken == false) {
+            return;
+        }
     }
 
-    m_RequestIDs.erase(idIndex);
-    m_Response = response;
-    ofxJSONElement json;
-    const bool isParseSuccesful = json.parse(response.data);
+    const ResponseHandler &handler = request.handler;
+    const uint64_t startTime = request.startTime;
+    //The response can arrive before loadURL() noted when the transport took the request
+    const uint64_t sendTime = request.sendTime != 0 ? request.sendTime : startTime;
+
+    ofxInstagramTracer::Scope responseScope(m_Tracer.get(), "response", response.request.name, requestID);
+    if (m_Tracer) {
+        m_Tracer->record("network", response.request.name, requestID, sendTime, receiveTime > sendTime ? receiveTime - sendTime : 0, true);
+    }
+
+    if (m_Recorder) {
+        m_Recorder->record(response, startTime);
+    }
+
+    ofxInstagramMetrics::Sample sample;
+    sample.byteCount = response.data.size();
+    sample.networkTime = receiveTime > startTime ? receiveTime - startTime : 0;
+    if (m_Transport) {
+        m_Transport->getTiming(requestID, sample.queueTime, sample.networkTime);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_ResponseMutex);
+        m_Response = response;
+    }
+
+    //Shared with the task of the executor, if there is one
+    const std::shared_ptr<ofxJSONElement> json = std::make_shared<ofxJSONElement>();
+    const uint64_t parseStartTime = ofGetElapsedTimeMicros();
+    const bool isParseSuccesful = json->parse(response.data);
+    const uint64_t parseEndTime = ofGetElapsedTimeMicros();
+    sample.parseTime = parseEndTime - parseStartTime;
+    if (m_Tracer) {
+        m_Tracer->record("parse", response.request.name, requestID, parseStartTime, sample.parseTime);
+    }
+
+    const FailureHandler failureHandler = request.failureHandler;
+    const auto fail = [this, &failureHandler](const Meta &meta) {
+        if (m_Executor) {
+            m_Executor->execute(std::bind(failureHandler, meta));
+        }
+        else {
+            failureHandler(meta);
+        }
+    };
+
     if (isParseSuccesful == false) {
         ofLogError("ofxInstagram") << __FUNCTION__ << ": Parse error. Request type: " << response.request.name;
+        sample.errorType = response.status == 200 ? ofxInstagramMetrics::ERROR_PARSE : ofxInstagramMetrics::ERROR_HTTP;
+        m_Metrics.recordResponse(response.request.name, sample);
+        if (failureHandler) {
+            Meta meta;
+            meta.errorType = sample.errorType;
+            meta.code = ofToString(response.status);
+            meta.errorMessage = response.error;
+            fail(meta);
+        }
+
+        return;
+    }
+
+    //Error responses of the API carry their type in the meta
+    sample.errorType = (*json)["meta"]["error_type"].isString() ? (*json)["meta"]["error_type"].asString() : "";
+    if (sample.errorType.length() == 0 && response.status != 200) {
+        sample.errorType = ofxInstagramMetrics::ERROR_HTTP;
+    }
+
+    //Without a failure handler the error is only logged, the callbacks would get empty data. getLastError() still has it.
+    if (sample.errorType.length() != 0) {
+        m_Metrics.recordResponse(response.request.name, sample);
+        Meta meta = constructMeta((*json)["meta"]);
+        meta.errorType = sample.errorType;
+        if (meta.code.length() == 0) {
+            meta.code = ofToString(response.status);
+        }
+
+        if (failureHandler) {
+            fail(meta);
+        }
+        else {
+            ofLogError("ofxInstagram") << __FUNCTION__ << ": " << meta.errorType << " " << meta.code << " " << meta.errorMessage
+                                       << ". Request type: " << response.request.name;
+        }
+
         return;
     }
 
-    //User Endpoints
-    handleUserEndpointResponse(response, json);
-    //Relationship Endpoints
-    handleRelationshipEndpointResponse(response, json);
-    //Media Endpoints
-    handleMediaEndpointResponse(response, json);
-    //Comment Endpoints
-    handleCommentEndpointResponse(response, json);
-    //Like Endpoints
-    handleLikeEndpointResponse(response, json);
-    //Tag Endpoints
-    handleTagEndpointResponse(response, json);
-    //Location Endpoints
-    handleLocationEndpointResponse(response, json);
+    if (m_Executor) {
+        //The task only needs the request of the response, the body was parsed already
+        const ofHttpResponse parsedResponse(response.request, response.status, response.error);
+        const ResponseHandler taskHandler = handler;
+        m_Executor->execute([this, parsedResponse, json, taskHandler, sample, parseEndTime]() {
+            deliver(parsedResponse, *json, taskHandler, sample, parseEndTime);
+        });
+    }
+    else {
+        deliver(response, *json, handler, sample, parseEndTime);
+    }
+}
+
+void ofxInstagram::deliver(const ofHttpResponse &response, const ofxJSONElement &json, const ResponseHandler &handler,
+                           ofxInstagramMetrics::Sample sample, uint64_t parseEndTime)
+{
+    const int requestID = response.request.getID();
+    const uint64_t deliveryStartTime = ofGetElapsedTimeMicros();
+    if (m_Tracer && m_Executor) {
+        m_Tracer->record("executor", response.request.name, requestID, parseEndTime, deliveryStartTime - parseEndTime, true);
+    }
+
+    Delivery delivery;
+    delivery.requestID = requestID;
+    delivery.endpoint = response.request.name;
+    //A callback can deliver another response, such as one of a transport that answers at once
+    Delivery *const outerDelivery = currentDelivery;
+    currentDelivery = &delivery;
+    //Requests made with a callback are only delivered to that callback
+    if (handler) {
+        handler(json);
+    }
+    else {
+        //User Endpoints
+        handleUserEndpointResponse(response, json);
+        //Relationship Endpoints
+        handleRelationshipEndpointResponse(response, json);
+        //Media Endpoints
+        handleMediaEndpointResponse(response, json);
+        //Comment Endpoints
+        handleCommentEndpointResponse(response, json);
+        //Like Endpoints
+        handleLikeEndpointResponse(response, json);
+        //Tag Endpoints
+        handleTagEndpointResponse(response, json);
+        //Location Endpoints
+        handleLocationEndpointResponse(response, json);
+    }
+
+    currentDelivery = outerDelivery;
+    const uint64_t deliveryTime = ofGetElapsedTimeMicros() - deliveryStartTime;
+    if (m_Tracer) {
+        m_Tracer->record("callback", response.request.name, requestID, deliveryStartTime, deliveryTime);
+    }
+    sample.decodeTime = delivery.decodeTime;
+    sample.callbackTime = deliveryTime > delivery.decodeTime ? deliveryTime - delivery.decodeTime : 0;
+    m_Metrics.recordResponse(response.request.name, sample);
+}
+
+int ofxInstagram::loadURL(const std::string &url, const std::string &requestName, ResponseHandler handler, FailureHandler failureHandler,
+                          uint64_t buildStartTime)
+{
+    PendingRequest request;
+    request.handler = handler;
+    request.failureHandler = failureHandler;
+    request.startTime = ofGetElapsedTimeMicros();
+    if (buildStartTime == 0) {
+        buildStartTime = request.startTime;
+    }
+
+    //Only taken for the tracer, the metrics start at startTime
+    uint64_t loadTime = 0;
+    int requestID = 0;
+    if (m_Transport) {
+        //Registered before the transport has it, so the transport can deliver it on any thread
+        const ofHttpRequest httpRequest = createRequest(url, requestName);
+        requestID = httpRequest.getID();
+        {
+            RequestShard &shard = getRequestShard(requestID);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.requests[requestID] = request;
+        }
+
+        if (m_Tracer) {
+            loadTime = ofGetElapsedTimeMicros();
+        }
+
+        m_Transport->load(httpRequest);
+    }
+    else {
+        if (m_Tracer) {
+            loadTime = ofGetElapsedTimeMicros();
+        }
+
+        ++m_UnregisteredRequestCount;
+        {
+            std::lock_guard<std::mutex> lock(requestIDMutex);
+            requestID = ofLoadURLAsync(url, requestName);
+        }
+
+        {
+            RequestShard &shard = getRequestShard(requestID);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.requests[requestID] = request;
+        }
+        --m_UnregisteredRequestCount;
+    }
+
+    request.sendTime = ofGetElapsedTimeMicros();
+    {
+        RequestShard &shard = getRequestShard(requestID);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto requestIt = shard.requests.find(requestID);
+        if (requestIt != shard.requests.end()) {
+            requestIt->second.sendTime = request.sendTime;
+        }
+    }
+
+    m_Metrics.recordRequest(requestName);
+
+    if (m_Tracer) {
+        m_Tracer->record("build_url", requestName, requestID, buildStartTime, loadTime - buildStartTime);
+        m_Tracer->record("enqueue", requestName, requestID, loadTime, request.sendTime - loadTime);
+    }
+
+    return requestID;
+}
+
+ofxInstagram::RequestShard &ofxInstagram::getRequestShard(int requestID)
+{
+    return m_RequestShards[static_cast<unsigned int>(requestID) % REQUEST_SHARD_COUNT];
+}
+
+bool ofxInstagram::takeRequest(int requestID, PendingRequest &request)
+{
+    RequestShard &shard = getRequestShard(requestID);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto requestIt = shard.requests.find(requestID);
+    if (requestIt == shard.requests.end()) {
+        return false;
+    }
+
+    request = std::move(requestIt->second);
+    shard.requests.erase(requestIt);
+    return true;
 }
 
 std::string ofxInstagram::getParsedJSONString() const
 {
-    if (m_Response.data.size() == 0) {
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(m_ResponseMutex);
+        data = m_Response.data.getText();
+    }
+
+    if (data.size() == 0) {
         return "";
     }
     else {
-        return ofxJSONElement(m_Response.data).toStyledString();
+        return ofxJSONElement(data).toStyledString();
     }
 }
 
+void ofxInstagram::setPostStore(std::shared_ptr<ofxInstagramPostStore> store)
+{
+    m_PostStore = store;
+}
+
+std::shared_ptr<ofxInstagramPostStore> ofxInstagram::getPostStore() const
+{
+    return m_PostStore;
+}
+
+void ofxInstagram::setTransport(std::shared_ptr<ofxInstagramTransport> transport)
+{
+    m_Transport = transport;
+}
+
+std::shared_ptr<ofxInstagramTransport> ofxInstagram::getTransport() const
+{
+    return m_Transport;
+}
+
+void ofxInstagram::setRecorder(std::shared_ptr<ofxInstagramRecorder> recorder)
+{
+    m_Recorder = recorder;
+}
+
+std::shared_ptr<ofxInstagramRecorder> ofxInstagram::getRecorder() const
+{
+    return m_Recorder;
+}
+
+ofxInstagramMetrics &ofxInstagram::getMetrics()
+{
+    return m_Metrics;
+}
+
+void ofxInstagram::setExecutor(std::shared_ptr<ofxInstagramExecutor> executor)
+{
+    m_Executor = executor;
+}
+
+std::shared_ptr<ofxInstagramExecutor> ofxInstagram::getExecutor() const
+{
+    return m_Executor;
+}
+
+void ofxInstagram::setTracer(std::shared_ptr<ofxInstagramTracer> tracer)
+{
+    m_Tracer = tracer;
+}
+
+std::shared_ptr<ofxInstagramTracer> ofxInstagram::getTracer() const
+{
+    return m_Tracer;
+}
+
 std::vector<PostData> ofxInstagram::constructPostDatas(const ofxJSONElement &json) const
 {
     std::vector<PostData> posts;
@@ -649,6 +1174,7 @@ PostData ofxInstagram::constructPostData(const ofxJSONElement &postJson) const
     PostData post;
     post.attribution = postJson["attribution"].asString();
     post.createdTime = postJson["created_time"].asString();
+    post.createdTimestamp = static_cast<std::time_t>(std::strtoll(post.createdTime.c_str(), nullptr, 10));
     post.filter = postJson["filter"].asString();
     post.id = postJson["id"].asString();
     post.link = postJson["link"].asString();
@@ -731,13 +1257,75 @@ PostData ofxInstagram::constructPostData(const ofxJSONElement &postJson) const
     const unsigned int userInPhotoCount = userInPhotoJson.size();
     for (unsigned int userInPhotoIndex = 0; userInPhotoIndex < userInPhotoCount; userInPhotoIndex++) {
         const ofxJSONElement userInPhoto = userInPhotoJson[userInPhotoIndex];
-        const ofVec2f pos(userInPhoto["position"]["x"].asFloat(), userInPhoto["position"]["y"].asFloat());
+        Position pos;
+        pos.x = userInPhoto["position"]["x"].asFloat();
+        pos.y = userInPhoto["position"]["y"].asFloat();
         post.usersInPhoto.push_back(std::make_pair(pos, constructUserInfo(userInPhoto["user"])));
     }
 
     return post;
 }
 
+void ofxInstagram::dispatchPosts(const ofxJSONElement &json, const std::function<void(Posts)> &callback)
+{
+    if (!callback && !m_PostStore) {
+        return;
+    }
+
+    const uint64_t decodeStartTime = ofGetElapsedTimeMicros();
+    Posts posts = std::make_pair(constructPostDatas(json), constructPagination(json["pagination"]));
+    const uint64_t decodeTime = ofGetElapsedTimeMicros() - decodeStartTime;
+    if (currentDelivery) {
+        currentDelivery->decodeTime += decodeTime;
+        if (m_Tracer) {
+            m_Tracer->record("constructPostDatas", currentDelivery->endpoint, currentDelivery->requestID, decodeStartTime, decodeTime);
+        }
+    }
+    if (m_PostStore) {
+        SharedPosts sharedPosts;
+        sharedPosts.second = posts.second;
+        // Only copy the posts into the store when they are also delivered by value
+        if (callback) {
+            sharedPosts.first = m_PostStore->merge(posts.first);
+            callback(posts);
+        }
+        else {
+            sharedPosts.first = m_PostStore->merge(std::move(posts.first));
+        }
+
+        if (onSharedPostsReceived) {
+            onSharedPostsReceived(sharedPosts);
+        }
+    }
+    else {
+        callback(posts);
+    }
+}
+
+void ofxInstagram::dispatchPost(const ofxJSONElement &postJson, const std::function<void(PostData)> &callback)
+{
+    if (!callback && !m_PostStore) {
+        return;
+    }
+
+    const uint64_t decodeStartTime = ofGetElapsedTimeMicros();
+    const PostData post = constructPostData(postJson);
+    const uint64_t decodeTime = ofGetElapsedTimeMicros() - decodeStartTime;
+    if (currentDelivery) {
+        currentDelivery->decodeTime += decodeTime;
+        if (m_Tracer) {
+            m_Tracer->record("constructPostData", currentDelivery->endpoint, currentDelivery->requestID, decodeStartTime, decodeTime);
+        }
+    }
+    if (m_PostStore) {
+        m_PostStore->merge(post);
+    }
+
+    if (callback) {
+        callback(post);
+    }
+}
+
 std::vector<UserInfo> ofxInstagram::constructUserInfos(const ofxJSONElement &json) const
 {
     const ofxJSONElement usersJson = json["data"];
@@ -750,6 +1338,11 @@ std::vector<UserInfo> ofxInstagram::constructUserInfos(const ofxJSONElement &jso
     return users;
 }
 
+Users ofxInstagram::constructUsers(const ofxJSONElement &json) const
+{
+    return std::make_pair(constructUserInfos(json), constructPagination(json["pagination"]));
+}
+
 UserInfo ofxInstagram::constructUserInfo(const ofxJSONElement &userJson) const
 {
     UserInfo user;
@@ -814,6 +1407,44 @@ Location ofxInstagram::constructLocation(const ofxJSONElement &locationJson) con
     return location;
 }
 
+std::vector<Location> ofxInstagram::constructLocations(const ofxJSONElement &locationsJson) const
+{
+    std::vector<Location> locations;
+    const unsigned int locationCount = locationsJson.size();
+    for (unsigned int locationIndex = 0; locationIndex < locationCount; locationIndex++) {
+        locations.push_back(constructLocation(locationsJson[locationIndex]));
+    }
+
+    return locations;
+}
+
+Relationship ofxInstagram::constructRelationship(const ofxJSONElement &relationshipJson) const
+{
+    Relationship rel;
+    rel.outgoingStatus = relationshipJson["outgoing_status"].asString();
+    rel.incomngStatus = relationshipJson["incoming_status"].asString();
+    return rel;
+}
+
+TagInfo ofxInstagram::constructTagInfo(const ofxJSONElement &tagJson) const
+{
+    TagInfo tagInfo;
+    tagInfo.mediaCount = tagJson["media_count"].asInt();
+    tagInfo.name = tagJson["name"].asString();
+    return tagInfo;
+}
+
+std::vector<TagInfo> ofxInstagram::constructTagInfos(const ofxJSONElement &tagsJson) const
+{
+    std::vector<TagInfo> tags;
+    const unsigned int tagCount = tagsJson.size();
+    for (unsigned int tagIndex = 0; tagIndex < tagCount; tagIndex++) {
+        tags.push_back(constructTagInfo(tagsJson[tagIndex]));
+    }
+
+    return tags;
+}
+
 Meta ofxInstagram::constructMeta(const ofxJSONElement &metaJson) const
 {
     Meta meta;
@@ -831,19 +1462,13 @@ void ofxInstagram::handleUserEndpointResponse(const ofHttpResponse &response, co
         }
     }
     else if (response.request.name == m_RequestUserFeed) {
-        if (onUserFeedReceived) {
-            onUserFeedReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onUserFeedReceived);
     }
     else if (response.request.name == m_RequestUserRecentMedia) {
-        if (onUserRecentMediaReceived) {
-            onUserRecentMediaReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onUserRecentMediaReceived);
     }
     else if (response.request.name == m_RequestUserLikedMedia) {
-        if (onUserLikedMediaReceived) {
-            onUserLikedMediaReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onUserLikedMediaReceived);
     }
     else if (response.request.name == m_RequestUserSearch) {
         if (onUserSearchReceived) {
@@ -871,10 +1496,7 @@ void ofxInstagram::handleRelationshipEndpointResponse(const ofHttpResponse &resp
     }
     else if (response.request.name == m_RequestRelationshipUserRel) {
         if (onUserRelationshipReceived) {
-            Relationship rel;
-            rel.outgoingStatus = json["data"]["outgoing_status"].asString();
-            rel.incomngStatus = json["data"]["incoming_status"].asString();
-            onUserRelationshipReceived(rel);
+            onUserRelationshipReceived(constructRelationship(json["data"]));
         }
     }
 }
@@ -882,19 +1504,13 @@ void ofxInstagram::handleRelationshipEndpointResponse(const ofHttpResponse &resp
 void ofxInstagram::handleMediaEndpointResponse(const ofHttpResponse &response, const ofxJSONElement &json)
 {
     if (response.request.name == m_RequestMediaInformation) {
-        if (onMediaInformationReceived) {
-            onMediaInformationReceived(constructPostData(json["data"]));
-        }
+        dispatchPost(json["data"], onMediaInformationReceived);
     }
     else if (response.request.name == m_RequestMediaSearch) {
-        if (onMediaSearchReceived) {
-            onMediaSearchReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onMediaSearchReceived);
     }
     else if (response.request.name == m_RequestMediaPopular) {
-        if (onMediaPopularReceived) {
-            onMediaPopularReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onMediaPopularReceived);
     }
 }
 
@@ -920,30 +1536,15 @@ void ofxInstagram::handleTagEndpointResponse(const ofHttpResponse &response, con
 {
     if (response.request.name == m_RequestTagInfo) {
         if (onTagInfoReceived) {
-            TagInfo tagInfo;
-            tagInfo.mediaCount = json["data"]["media_count"].asInt();
-            tagInfo.name = json["data"]["name"].asString();
-            onTagInfoReceived(tagInfo);
+            onTagInfoReceived(constructTagInfo(json["data"]));
         }
     }
     else if (response.request.name == m_RequestTagPostList) {
-        if (onPostsForTagReceived) {
-            onPostsForTagReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onPostsForTagReceived);
     }
     else if (response.request.name == m_RequestTagSearch) {
         if (onTagSearchReceived) {
-            std::vector<TagInfo> tags;
-            const ofxJSONElement tagsJson = json["data"];
-            const unsigned int tagCount = tagsJson.size();
-            for (unsigned int tagIndex = 0; tagIndex < tagCount; tagIndex++) {
-                TagInfo tagInfo;
-                tagInfo.mediaCount = tagsJson[tagIndex]["media_count"].asInt();
-                tagInfo.name = tagsJson[tagIndex]["name"].asString();
-                tags.push_back(tagInfo);
-            }
-
-            onTagSearchReceived(tags);
+            onTagSearchReceived(constructTagInfos(json["data"]));
         }
     }
 }
@@ -956,19 +1557,11 @@ void ofxInstagram::handleLocationEndpointResponse(const ofHttpResponse &response
         }
     }
     else if (response.request.name == m_RequestLocationRecentMedia) {
-        if (onPostsFromLocationReceived) {
-            onPostsFromLocationReceived(std::make_pair(constructPostDatas(json), constructPagination(json["pagination"])));
-        }
+        dispatchPosts(json, onPostsFromLocationReceived);
     }
     else if (response.request.name == m_RequestLocationSearch) {
         if (onLocationSearchReceived) {
-            std::vector<Location> locations;
-            const ofxJSONElement locationsJson = json["data"];
-            const unsigned int locationCount = locationsJson.size();
-            for (unsigned int locationIndex = 0; locationIndex < locationCount; locationIndex++) {
-                locations.push_back(constructLocation(locationsJson[locationIndex]));
-            }
-            onLocationSearchReceived(locations);
+            onLocationSearchReceived(constructLocations(json["data"]));
         }
     }
 }
@@ -4,10 +4,26 @@
  *  David Haylock 2015
  */
 
-#include "ofVec2f.h"
+#ifndef OFXINSTAGRAM_H
+#define OFXINSTAGRAM_H
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "ofURLFileLoader.h"
 #include "ofxJSON.h"
 #include "ofxInstagramTypes.h"
-
+#include "ofxInstagramExecutor.h"
+#include "ofxInstagramMetrics.h"
+#include "ofxInstagramPostStore.h"
+#include "ofxInstagramRecorder.h"
+#include "ofxInstagramTracer.h"
+#include "ofxInstagramTransport.h"
+
+// The getters can be called from any thread. A response is parsed on the thread that hands it to urlResponse(): the main
+// thread for ofLoadURLAsync() and ofxInstagramReplayTransport, the thread that calls update() or a worker for
+// ofxInstagramHTTPTransport. Without an executor it is decoded and the callbacks and the on...Received members run on that
+// thread as well, otherwise on the executor's, see setExecutor(). Set the members, the post store, executor, transport,
+// recorder and tracer before requests are made from other threads.
 class ofxInstagram
 {
 public:
@@ -44,6 +60,9 @@ public:
     std::function<void(ofxInstagramTypes::Posts)> onPostsFromLocationReceived;
     std::function<void(std::vector<ofxInstagramTypes::Location>)> onLocationSearchReceived;
 
+    //Post Store Callbacks. Called for every response that contains posts when a post store is set.
+    std::function<void(ofxInstagramTypes::SharedPosts)> onSharedPostsReceived;
+
 public:
     ofxInstagram();
 
@@ -51,47 +70,87 @@ public:
     void setup(std::string auth_token, std::string clientID);
     void setCertFileLocation(std::string path);
 
-    void draw();
-    void drawJSON(int x);
+    // The body of the last response, indented. ofxInstagramJSONView draws it.
+    std::string getParsedJSONString() const;
 
-    void resetScroll();
-    void mouseScroll(int scrollY);
+    // Posts from every endpoint are merged into the store, so the same media ID is only kept once.
+    void setPostStore(std::shared_ptr<ofxInstagramPostStore> store);
+    std::shared_ptr<ofxInstagramPostStore> getPostStore() const;
 
-    std::string getParsedJSONString() const;
+    // Requests are loaded through the transport when one is set, otherwise with ofLoadURLAsync()
+    void setTransport(std::shared_ptr<ofxInstagramTransport> transport);
+    std::shared_ptr<ofxInstagramTransport> getTransport() const;
+
+    // Every response is written to the recorder while one is set
+    void setRecorder(std::shared_ptr<ofxInstagramRecorder> recorder);
+    std::shared_ptr<ofxInstagramRecorder> getRecorder() const;
+
+    // Request counts, errors and latency histograms per endpoint, by the name of the request
+    ofxInstagramMetrics &getMetrics();
+
+    // The executor runs the decoding and the callbacks of every response once it is parsed, such as on the main thread with
+    // ofxInstagramMainThreadExecutor or on a pool with ofxInstagramThreadPoolExecutor. Without one they run inline. To
+    // choose for a single request wrap its callback with ofxInstagramExecutor::wrap(). Queued deliveries call into the
+    // client, so stop the executor before the client is destroyed.
+    void setExecutor(std::shared_ptr<ofxInstagramExecutor> executor);
+    std::shared_ptr<ofxInstagramExecutor> getExecutor() const;
+
+    // While a tracer is set every request records spans for building its URL, handing it to the transport, the network,
+    // parsing, decoding posts and the callbacks. They carry the request name and the request ID.
+    void setTracer(std::shared_ptr<ofxInstagramTracer> tracer);
+    std::shared_ptr<ofxInstagramTracer> getTracer() const;
+
+    // Every getter returns the ID of its request. A callback passed to a getter is only called for that request, requests
+    // made without one are delivered to the matching on...Received member above. The failure handler passed to a getter is
+    // called instead of the callback when the request fails: with the meta of an error response, or with the error type of
+    // ofxInstagramMetrics when the response does not parse or the transport could not load it. It runs where the callback
+    // would have.
+    using FailureHandler = std::function<void(const ofxInstagramTypes::Meta &)>;
 
     //------------- USER ENDPOINTS -------------
 
     // GET User Info
-    void getUserInformation(std::string who = "self", std::function<void(ofxInstagramTypes::UserInfo)> callback = nullptr);
+    int getUserInformation(std::string who = "self", std::function<void(ofxInstagramTypes::UserInfo)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     // GET User Feed use count to limit number of returns
-    void getUserFeed(int count = 20, std::string username = "self", std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, std::string minID = "",
-                     std::string maxID = "");
+    int getUserFeed(int count = 20, std::string username = "self", std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, std::string minID = "",
+                    std::string maxID = "", FailureHandler onFailure = nullptr);
 
     // GET User recent images from user pass the who as the user ID number
-    void getUserRecentMedia(std::string who = "self", int count = 20, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
-                            std::string maxTimestamp = "",
-                            std::string minTimestamp = "", std::string minID = "", std::string maxID = "");
+    int getUserRecentMedia(std::string who = "self", int count = 20, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
+                           std::string maxTimestamp = "",
+                           std::string minTimestamp = "", std::string minID = "", std::string maxID = "", FailureHandler onFailure = nullptr);
 
     // GET User Liked Media
-    void getUserLikedMedia(int count = 20, string username = "self", std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, std::string maxLikeID = "");
+    int getUserLikedMedia(int count = 20, string username = "self", std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, std::string maxLikeID = "",
+                          FailureHandler onFailure = nullptr);
 
     // GET User Search for users
-    void getSearchUsers(std::string query = "", int count = 20, std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr);
+    int getSearchUsers(std::string query = "", int count = 20, std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr,
+                       FailureHandler onFailure = nullptr);
 
     //------------- RELATIONSHIP ENDPOINTS -------------
 
     // GET User Follows
-    void getWhoUserFollows(std::string who = "self", std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr);
+    int getWhoUserFollows(std::string who = "self", std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr,
+                          FailureHandler onFailure = nullptr);
 
     // GET User Followed By
-    void getUserFollowers(std::string who = "self", std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr);
+    int getUserFollowers(std::string who = "self", std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr,
+                         FailureHandler onFailure = nullptr);
+
+    // GET User Follows and Followed By a page at a time, getNextUsersPage() requests the page after one that was received.
+    // The callback is called for this request only.
+    int getWhoUserFollowsPage(std::string who, std::function<void(ofxInstagramTypes::Users)> callback, FailureHandler onFailure = nullptr);
+    int getUserFollowersPage(std::string who, std::function<void(ofxInstagramTypes::Users)> callback, FailureHandler onFailure = nullptr);
 
     // GET User Requested-by
-    void getWhoHasRequestedToFollow(std::string who = "self", std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr);
+    int getWhoHasRequestedToFollow(std::string who = "self", std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr,
+                                   FailureHandler onFailure = nullptr);
 
     // GET User Relationship
-    void getRelationshipToUser(std::string who = "self", std::function<void(ofxInstagramTypes::Relationship)> callback = nullptr);
+    int getRelationshipToUser(std::string who = "self", std::function<void(ofxInstagramTypes::Relationship)> callback = nullptr,
+                              FailureHandler onFailure = nullptr);
 
     // POST User Modify Relationship
     void changeRelationshipToUser(std::string who = "self", std::string action = "", std::function<void(ofxInstagramTypes::UserInfo)> callback = nullptr);
@@ -99,60 +158,89 @@ public:
     //------------- MEDIA ENDPOINTS -------------
 
     // GET Info about Media Object
-    void getMediaInformation(std::string mediaID, std::function<void(ofxInstagramTypes::PostData)> callback = nullptr);
+    int getMediaInformation(std::string mediaID, std::function<void(ofxInstagramTypes::PostData)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     // GET Info about Media using Shortcode
-    void getMediaInfoUsingShortcode(std::string shortcode = "", std::function<void(ofxInstagramTypes::PostData)> callback = nullptr);
+    int getMediaInfoUsingShortcode(std::string shortcode = "", std::function<void(ofxInstagramTypes::PostData)> callback = nullptr,
+                                   FailureHandler onFailure = nullptr);
 
     // GET Media Search
-    void searchMedia(std::string lat = "", std::string lng = "", std::string min_timestamp = "", std::string max_timestamp = "", int distance = 1000,
-                     std::function<void(ofxInstagramTypes::Posts)> callback = nullptr);
-    void searchMedia(const std::string &tag, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr);
+    int searchMedia(std::string lat = "", std::string lng = "", std::string min_timestamp = "", std::string max_timestamp = "", int distance = 1000,
+                    std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, FailureHandler onFailure = nullptr);
+    int searchMedia(const std::string &tag, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     // GET Popular Media
-    void getPopularMedia(std::function<void(ofxInstagramTypes::Posts)> callback = nullptr);
+    int getPopularMedia(std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     //------------- COMMENTS ENDPOINTS -------------
 
     // GET Comments on Media Object
-    void getCommentsForMedia(std::string mediaID, std::function<void(std::vector<ofxInstagramTypes::Comment>)> callback = nullptr);
+    int getCommentsForMedia(std::string mediaID, std::function<void(std::vector<ofxInstagramTypes::Comment>)> callback = nullptr,
+                            FailureHandler onFailure = nullptr);
 
     //------------- LIKE ENDPOINTS -------------
 
     // GET List of Users who have Liked a Media Object
-    void getListOfUsersWhoLikedMedia(std::string mediaID, std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr);
+    int getListOfUsersWhoLikedMedia(std::string mediaID, std::function<void(std::vector<ofxInstagramTypes::UserInfo>)> callback = nullptr,
+                                    FailureHandler onFailure = nullptr);
 
     //------------- TAG ENDPOINTS -------------
 
     // GET Info about tagged object
-    void getInfoForTag(std::string tagname, std::function<void(ofxInstagramTypes::TagInfo)> callback = nullptr);
+    int getInfoForTag(std::string tagname, std::function<void(ofxInstagramTypes::TagInfo)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     // GET List of recently tagged objects
-    void getListOfTaggedObjectsNormal(std::string tagname, int count = 20, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
-                                      std::string min_tagID = "",
-                                      std::string max_tagID = "");
+    int getListOfTaggedObjectsNormal(std::string tagname, int count = 20, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
+                                     std::string min_tagID = "",
+                                     std::string max_tagID = "", FailureHandler onFailure = nullptr);
     // GET List of recently tagged objects
-    void getListOfTaggedObjectsPagination(std::string tagname, int count = 20, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
-                                          std::string max_tagID = "");
+    int getListOfTaggedObjectsPagination(std::string tagname, int count = 20, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
+                                         std::string max_tagID = "", FailureHandler onFailure = nullptr);
     // GET Search Tags
-    void searchForTags(std::string query, std::function<void(std::vector<ofxInstagramTypes::TagInfo>)> callback = nullptr);
+    int searchForTags(std::string query, std::function<void(std::vector<ofxInstagramTypes::TagInfo>)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     //------------- LOCATIONS ENDPOINTS -------------
 
     // GET Info about a Location
-    void getInfoAboutLocation(std::string locationID, std::function<void(ofxInstagramTypes::Location)> callback = nullptr);
+    int getInfoAboutLocation(std::string locationID, std::function<void(ofxInstagramTypes::Location)> callback = nullptr, FailureHandler onFailure = nullptr);
 
     // GET Recent Media from location
-    void getRecentMediaFromLocation(std::string locationID, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, std::string minTimestamp = "",
-                                    std::string maxTimestamp = "", std::string minID = "", std::string maxID = "");
+    int getRecentMediaFromLocation(std::string locationID, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr, std::string minTimestamp = "",
+                                   std::string maxTimestamp = "", std::string minID = "", std::string maxID = "", FailureHandler onFailure = nullptr);
 
     // GET Find Location ID
-    void searchForLocations(std::string distance, std::string lat, std::string lng,
-                            std::function<void(std::vector<ofxInstagramTypes::Location>)> callback = nullptr,
-                            std::string facebook_PlacesID = "", std::string foursquareID = "");
+    int searchForLocations(std::string distance, std::string lat, std::string lng,
+                           std::function<void(std::vector<ofxInstagramTypes::Location>)> callback = nullptr,
+                           std::string facebook_PlacesID = "", std::string foursquareID = "", FailureHandler onFailure = nullptr);
+
+    //------------- PAGINATION -------------
+
+    // GET the page after one that was received, using its next_url. Returns -1 if there is no next page.
+    int getNextPage(const ofxInstagramTypes::Pagination &pagination, std::function<void(ofxInstagramTypes::Posts)> callback = nullptr,
+                    FailureHandler onFailure = nullptr);
+    // The same for pages of users. Returns -1 if there is no next page.
+    int getNextUsersPage(const ofxInstagramTypes::Pagination &pagination, std::function<void(ofxInstagramTypes::Users)> callback,
+                         FailureHandler onFailure = nullptr);
+
+    // Requests a URL that was built elsewhere, such as a recorded one. The response is delivered to the on...Received
+    // member of the getter that uses requestName.
+    int request(const std::string &url, const std::string &requestName);
 
     ofxInstagramTypes::Meta getLastError() const;
 
+    // Decoding of the API's JSON. The plural versions that take the whole response read its "data" array, the others take
+    // a single object. Useful for responses that were saved to disk.
+    std::vector<ofxInstagramTypes::PostData> constructPostDatas(const ofxJSONElement &json) const;
+    ofxInstagramTypes::PostData constructPostData(const ofxJSONElement &postJson) const;
+    std::vector<ofxInstagramTypes::UserInfo> constructUserInfos(const ofxJSONElement &json) const;
+    ofxInstagramTypes::Users constructUsers(const ofxJSONElement &json) const;
+    ofxInstagramTypes::UserInfo constructUserInfo(const ofxJSONElement &userJson) const;
+    std::vector<ofxInstagramTypes::Comment> constructComments(const ofxJSONElement &commentsJson) const;
+    ofxInstagramTypes::Pagination constructPagination(const ofxJSONElement &paginationJson) const;
+    ofxInstagramTypes::Location constructLocation(const ofxJSONElement &locationJson) const;
+    std::vector<ofxInstagramTypes::Location> constructLocations(const ofxJSONElement &locationsJson) const;
+
+    // Responses of different requests can be delivered from different threads at once
     void urlResponse(ofHttpResponse &response);
 
 private:
@@ -195,35 +283,71 @@ private:
           m_RequestLocationRecentMedia,
           m_RequestLocationSearch;
 
+    //Request Names - Pagination
+    const std::string m_RequestNextPage,
+          m_RequestNextUsersPage;
+
     //Holds the response data for the latest request
     ofHttpResponse m_Response;
+    mutable std::mutex m_ResponseMutex;
 
     std::string m_AuthToken;
     std::string m_ClientID;
     std::string m_ResponseData;
     std::string m_CertPath;
 
-    int m_ScrollValue;
-    ofVec2f m_ScrollAmount;
-    ofVec2f m_ClickOrigin;
-    ofVec2f m_ReleasePos;
-
-    std::vector<unsigned int> m_RequestIDs;
+    //Pending requests and the handler of the callback that was passed with them, if any
+    using ResponseHandler = std::function<void(const ofxJSONElement &)>;
+    struct PendingRequest {
+        ResponseHandler handler;
+        //The onFailure of the getter, if one was passed. Error responses and ones that do not parse go here instead of to
+        //the handler, without one they are only logged.
+        FailureHandler failureHandler;
+        //ofGetElapsedTimeMicros() of when the request was made and when the transport took it
+        uint64_t startTime = 0,
+                 sendTime = 0;
+    };
+
+    //Pending requests by ID % REQUEST_SHARD_COUNT, so requests made and delivered on different threads rarely wait for
+    //each other
+    struct RequestShard {
+        std::mutex mutex;
+        std::unordered_map<int, PendingRequest> requests;
+    };
+
+    static const size_t REQUEST_SHARD_COUNT = 16;
+    RequestShard m_RequestShards[REQUEST_SHARD_COUNT];
+    //Requests handed to ofLoadURLAsync() that are not registered yet, see urlResponse()
+    std::atomic<int> m_UnregisteredRequestCount;
+
+    std::shared_ptr<ofxInstagramPostStore> m_PostStore;
+    std::shared_ptr<ofxInstagramTransport> m_Transport;
+    std::shared_ptr<ofxInstagramRecorder> m_Recorder;
+    std::shared_ptr<ofxInstagramExecutor> m_Executor;
+
+    ofxInstagramMetrics m_Metrics;
+    std::shared_ptr<ofxInstagramTracer> m_Tracer;
 
 private:
-    std::vector<ofxInstagramTypes::PostData> constructPostDatas(const ofxJSONElement &json) const;
-    ofxInstagramTypes::PostData constructPostData(const ofxJSONElement &postJson) const;
+    void dispatchPosts(const ofxJSONElement &json, const std::function<void(ofxInstagramTypes::Posts)> &callback);
+    void dispatchPost(const ofxJSONElement &postJson, const std::function<void(ofxInstagramTypes::PostData)> &callback);
 
-    std::vector<ofxInstagramTypes::UserInfo> constructUserInfos(const ofxJSONElement &json) const;
-    ofxInstagramTypes::UserInfo constructUserInfo(const ofxJSONElement &userJson) const;
-
-    std::vector<ofxInstagramTypes::Comment> constructComments(const ofxJSONElement &commentsJson) const;
-    ofxInstagramTypes::Pagination constructPagination(const ofxJSONElement &paginationJson) const;
-
-    ofxInstagramTypes::Location constructLocation(const ofxJSONElement &locationJson) const;
+    ofxInstagramTypes::Relationship constructRelationship(const ofxJSONElement &relationshipJson) const;
+    ofxInstagramTypes::TagInfo constructTagInfo(const ofxJSONElement &tagJson) const;
+    std::vector<ofxInstagramTypes::TagInfo> constructTagInfos(const ofxJSONElement &tagsJson) const;
 
     ofxInstagramTypes::Meta constructMeta(const ofxJSONElement &metaJson) const;
 
+    // Traced as build_url from buildStartTime, taken by the getter before it builds the URL, until the request is registered,
+    // and as enqueue while the transport takes it. 0 starts the span here, for URLs that were not built.
+    int loadURL(const std::string &url, const std::string &requestName, ResponseHandler handler, FailureHandler failureHandler = nullptr,
+                uint64_t buildStartTime = 0);
+    RequestShard &getRequestShard(int requestID);
+    bool takeRequest(int requestID, PendingRequest &request);
+    //Decodes the parsed response and calls its callbacks, on the executor when there is one
+    void deliver(const ofHttpResponse &response, const ofxJSONElement &json, const ResponseHandler &handler, ofxInstagramMetrics::Sample sample,
+                 uint64_t parseEndTime);
+
     void handleUserEndpointResponse(const ofHttpResponse &response, const ofxJSONElement &json);
     void handleRelationshipEndpointResponse(const ofHttpResponse &response, const ofxJSONElement &json);
     void handleMediaEndpointResponse(const ofHttpResponse &response, const ofxJSONElement &json);
@@ -234,3 +358,5 @@ private:
 
     void handleLocationEndpointResponse(const ofHttpResponse &response, const ofxJSONElement &json);
 };
+
+#endif // OFXINSTAGRAM_H
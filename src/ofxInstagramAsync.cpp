@@ -0,0 +1,239 @@
+#include "ofxInstagramAsync.h"
+using namespace ofxInstagramTypes;
+
+namespace
+{
+const std::string ERROR_NO_NEXT_PAGE = "NoNextPage";
+}
+
+ofxInstagramAsync::ofxInstagramAsync(ofxInstagram &instagram)
+    : m_Instagram(instagram)
+{
+
+}
+
+template<typename Value>
+ofxInstagramFuture<Value> ofxInstagramAsync::call(const std::function<int(std::function<void(Value)>, ofxInstagram::FailureHandler)> &makeRequest)
+{
+    ofxInstagramPromise<Value> promise;
+    const int requestID = makeRequest([promise](Value value) mutable {
+        promise.setValue(std::move(value));
+    }, [promise](const Meta &error) mutable {
+        promise.setError(error);
+    });
+
+    if (requestID == -1) {
+        Meta error;
+        error.errorType = ERROR_NO_NEXT_PAGE;
+        promise.setError(error);
+    }
+
+    return promise.getFuture();
+}
+
+//------------- USER ENDPOINTS -------------
+
+ofxInstagramFuture<UserInfo> ofxInstagramAsync::getUserInformation(std::string who)
+{
+    return call<UserInfo>([&](std::function<void(UserInfo)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getUserInformation(who, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getUserFeed(int count, std::string username, std::string minID, std::string maxID)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getUserFeed(count, username, callback, minID, maxID, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getUserRecentMedia(std::string who, int count, std::string maxTimestamp, std::string minTimestamp,
+                                                               std::string minID, std::string maxID)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getUserRecentMedia(who, count, callback, maxTimestamp, minTimestamp, minID, maxID, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getUserLikedMedia(int count, std::string username, std::string maxLikeID)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getUserLikedMedia(count, username, callback, maxLikeID, onFailure);
+    });
+}
+
+ofxInstagramFuture<std::vector<UserInfo>> ofxInstagramAsync::getSearchUsers(std::string query, int count)
+{
+    return call<std::vector<UserInfo>>([&](std::function<void(std::vector<UserInfo>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getSearchUsers(query, count, callback, onFailure);
+    });
+}
+
+//------------- RELATIONSHIP ENDPOINTS -------------
+
+ofxInstagramFuture<std::vector<UserInfo>> ofxInstagramAsync::getWhoUserFollows(std::string who)
+{
+    return call<std::vector<UserInfo>>([&](std::function<void(std::vector<UserInfo>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getWhoUserFollows(who, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<std::vector<UserInfo>> ofxInstagramAsync::getUserFollowers(std::string who)
+{
+    return call<std::vector<UserInfo>>([&](std::function<void(std::vector<UserInfo>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getUserFollowers(who, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Users> ofxInstagramAsync::getWhoUserFollowsPage(std::string who)
+{
+    return call<Users>([&](std::function<void(Users)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getWhoUserFollowsPage(who, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Users> ofxInstagramAsync::getUserFollowersPage(std::string who)
+{
+    return call<Users>([&](std::function<void(Users)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getUserFollowersPage(who, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<std::vector<UserInfo>> ofxInstagramAsync::getWhoHasRequestedToFollow(std::string who)
+{
+    return call<std::vector<UserInfo>>([&](std::function<void(std::vector<UserInfo>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getWhoHasRequestedToFollow(who, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Relationship> ofxInstagramAsync::getRelationshipToUser(std::string who)
+{
+    return call<Relationship>([&](std::function<void(Relationship)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getRelationshipToUser(who, callback, onFailure);
+    });
+}
+
+//------------- MEDIA ENDPOINTS -------------
+
+ofxInstagramFuture<PostData> ofxInstagramAsync::getMediaInformation(std::string mediaID)
+{
+    return call<PostData>([&](std::function<void(PostData)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getMediaInformation(mediaID, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<PostData> ofxInstagramAsync::getMediaInfoUsingShortcode(std::string shortcode)
+{
+    return call<PostData>([&](std::function<void(PostData)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getMediaInfoUsingShortcode(shortcode, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::searchMedia(std::string lat, std::string lng, std::string min_timestamp, std::string max_timestamp,
+                                                        int distance)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.searchMedia(lat, lng, min_timestamp, max_timestamp, distance, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::searchMedia(const std::string &tag)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.searchMedia(tag, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getPopularMedia()
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getPopularMedia(callback, onFailure);
+    });
+}
+
+//------------- COMMENTS AND LIKE ENDPOINTS -------------
+
+ofxInstagramFuture<std::vector<Comment>> ofxInstagramAsync::getCommentsForMedia(std::string mediaID)
+{
+    return call<std::vector<Comment>>([&](std::function<void(std::vector<Comment>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getCommentsForMedia(mediaID, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<std::vector<UserInfo>> ofxInstagramAsync::getListOfUsersWhoLikedMedia(std::string mediaID)
+{
+    return call<std::vector<UserInfo>>([&](std::function<void(std::vector<UserInfo>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getListOfUsersWhoLikedMedia(mediaID, callback, onFailure);
+    });
+}
+
+//------------- TAG ENDPOINTS -------------
+
+ofxInstagramFuture<TagInfo> ofxInstagramAsync::getInfoForTag(std::string tagname)
+{
+    return call<TagInfo>([&](std::function<void(TagInfo)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getInfoForTag(tagname, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getListOfTaggedObjectsNormal(std::string tagname, int count, std::string min_tagID, std::string max_tagID)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getListOfTaggedObjectsNormal(tagname, count, callback, min_tagID, max_tagID, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getListOfTaggedObjectsPagination(std::string tagname, int count, std::string max_tagID)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getListOfTaggedObjectsPagination(tagname, count, callback, max_tagID, onFailure);
+    });
+}
+
+ofxInstagramFuture<std::vector<TagInfo>> ofxInstagramAsync::searchForTags(std::string query)
+{
+    return call<std::vector<TagInfo>>([&](std::function<void(std::vector<TagInfo>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.searchForTags(query, callback, onFailure);
+    });
+}
+
+//------------- LOCATIONS ENDPOINTS -------------
+
+ofxInstagramFuture<Location> ofxInstagramAsync::getInfoAboutLocation(std::string locationID)
+{
+    return call<Location>([&](std::function<void(Location)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getInfoAboutLocation(locationID, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getRecentMediaFromLocation(std::string locationID, std::string minTimestamp, std::string maxTimestamp,
+                                                                       std::string minID, std::string maxID)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getRecentMediaFromLocation(locationID, callback, minTimestamp, maxTimestamp, minID, maxID, onFailure);
+    });
+}
+
+ofxInstagramFuture<std::vector<Location>> ofxInstagramAsync::searchForLocations(std::string distance, std::string lat, std::string lng,
+                                                                               std::string facebook_PlacesID, std::string foursquareID)
+{
+    return call<std::vector<Location>>([&](std::function<void(std::vector<Location>)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.searchForLocations(distance, lat, lng, callback, facebook_PlacesID, foursquareID, onFailure);
+    });
+}
+
+//------------- PAGINATION -------------
+
+ofxInstagramFuture<Posts> ofxInstagramAsync::getNextPage(const Pagination &pagination)
+{
+    return call<Posts>([&](std::function<void(Posts)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getNextPage(pagination, callback, onFailure);
+    });
+}
+
+ofxInstagramFuture<Users> ofxInstagramAsync::getNextUsersPage(const Pagination &pagination)
+{
+    return call<Users>([&](std::function<void(Users)> callback, ofxInstagram::FailureHandler onFailure) {
+        return m_Instagram.getNextUsersPage(pagination, callback, onFailure);
+    });
+}
@@ -0,0 +1,78 @@
+#ifndef OFXINSTAGRAMASYNC_H
+#define OFXINSTAGRAMASYNC_H
+#include "ofxInstagram.h"
+#include "ofxInstagramFuture.h"
+
+// The getters of ofxInstagram returning a future instead of taking a callback, so requests can be chained and fanned out
+// without nesting callbacks. Error responses and responses that do not parse fail the future with their meta.
+//
+//     ofxInstagramAsync async(instagram);
+//     std::vector<ofxInstagramFuture<std::vector<ofxInstagramTypes::Comment>>> comments;
+//     for (const ofxInstagramTypes::PostData &post : posts.first) {
+//         comments.push_back(async.getCommentsForMedia(post.id));
+//     }
+//     ofxInstagramWhenAll(comments).then([](const std::vector<std::vector<ofxInstagramTypes::Comment>> &allComments) { ... });
+class ofxInstagramAsync
+{
+public:
+    explicit ofxInstagramAsync(ofxInstagram &instagram);
+
+    //------------- USER ENDPOINTS -------------
+    ofxInstagramFuture<ofxInstagramTypes::UserInfo> getUserInformation(std::string who = "self");
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getUserFeed(int count = 20, std::string username = "self", std::string minID = "", std::string maxID = "");
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getUserRecentMedia(std::string who = "self", int count = 20, std::string maxTimestamp = "",
+                                                                     std::string minTimestamp = "", std::string minID = "", std::string maxID = "");
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getUserLikedMedia(int count = 20, std::string username = "self", std::string maxLikeID = "");
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::UserInfo>> getSearchUsers(std::string query = "", int count = 20);
+
+    //------------- RELATIONSHIP ENDPOINTS -------------
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::UserInfo>> getWhoUserFollows(std::string who = "self");
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::UserInfo>> getUserFollowers(std::string who = "self");
+    ofxInstagramFuture<ofxInstagramTypes::Users> getWhoUserFollowsPage(std::string who = "self");
+    ofxInstagramFuture<ofxInstagramTypes::Users> getUserFollowersPage(std::string who = "self");
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::UserInfo>> getWhoHasRequestedToFollow(std::string who = "self");
+    ofxInstagramFuture<ofxInstagramTypes::Relationship> getRelationshipToUser(std::string who = "self");
+
+    //------------- MEDIA ENDPOINTS -------------
+    ofxInstagramFuture<ofxInstagramTypes::PostData> getMediaInformation(std::string mediaID);
+    ofxInstagramFuture<ofxInstagramTypes::PostData> getMediaInfoUsingShortcode(std::string shortcode);
+    ofxInstagramFuture<ofxInstagramTypes::Posts> searchMedia(std::string lat = "", std::string lng = "", std::string min_timestamp = "",
+                                                              std::string max_timestamp = "", int distance = 1000);
+    ofxInstagramFuture<ofxInstagramTypes::Posts> searchMedia(const std::string &tag);
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getPopularMedia();
+
+    //------------- COMMENTS AND LIKE ENDPOINTS -------------
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::Comment>> getCommentsForMedia(std::string mediaID);
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::UserInfo>> getListOfUsersWhoLikedMedia(std::string mediaID);
+
+    //------------- TAG ENDPOINTS -------------
+    ofxInstagramFuture<ofxInstagramTypes::TagInfo> getInfoForTag(std::string tagname);
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getListOfTaggedObjectsNormal(std::string tagname, int count = 20, std::string min_tagID = "",
+                                                                              std::string max_tagID = "");
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getListOfTaggedObjectsPagination(std::string tagname, int count = 20, std::string max_tagID = "");
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::TagInfo>> searchForTags(std::string query);
+
+    //------------- LOCATIONS ENDPOINTS -------------
+    ofxInstagramFuture<ofxInstagramTypes::Location> getInfoAboutLocation(std::string locationID);
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getRecentMediaFromLocation(std::string locationID, std::string minTimestamp = "",
+                                                                            std::string maxTimestamp = "", std::string minID = "",
+                                                                            std::string maxID = "");
+    ofxInstagramFuture<std::vector<ofxInstagramTypes::Location>> searchForLocations(std::string distance, std::string lat, std::string lng,
+                                                                                    std::string facebook_PlacesID = "",
+                                                                                    std::string foursquareID = "");
+
+    //------------- PAGINATION -------------
+    // Fails with the error type "NoNextPage" when the page was the last one
+    ofxInstagramFuture<ofxInstagramTypes::Posts> getNextPage(const ofxInstagramTypes::Pagination &pagination);
+    ofxInstagramFuture<ofxInstagramTypes::Users> getNextUsersPage(const ofxInstagramTypes::Pagination &pagination);
+
+private:
+    ofxInstagram &m_Instagram;
+
+private:
+    //Makes the request with a callback that sets the value of the future and a failure handler that fails it
+    template<typename Value>
+    ofxInstagramFuture<Value> call(const std::function<int(std::function<void(Value)>, ofxInstagram::FailureHandler)> &makeRequest);
+};
+
+#endif // OFXINSTAGRAMASYNC_H
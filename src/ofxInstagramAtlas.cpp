@@ -0,0 +1,267 @@
+#include "ofxInstagramAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+ofxInstagramAtlas::ofxInstagramAtlas(int pageSize, int channels, int padding, size_t maxPages)
+    : m_PageSize(pageSize)
+    , m_Channels(channels)
+    , m_Padding(std::max(padding, 0))
+    , m_MaxPages(maxPages)
+    , m_UsedArea(0)
+{
+
+}
+
+bool ofxInstagramAtlas::add(const std::string &mediaID, const ofPixels &pixels)
+{
+    if (pixels.isAllocated() == false) {
+        return false;
+    }
+
+    if (static_cast<int>(pixels.getNumChannels()) != m_Channels) {
+        ofLogWarning("ofxInstagramAtlas") << __FUNCTION__ << ": " << mediaID << " has " << pixels.getNumChannels() << " channels, the atlas expects " << m_Channels;
+        return false;
+    }
+
+    const int width = pixels.getWidth(), height = pixels.getHeight();
+    auto it = m_Entries.find(mediaID);
+    if (it != m_Entries.end()) {
+        //Same size, the image can be replaced in place
+        if (static_cast<int>(it->second.region.rect.width) == width && static_cast<int>(it->second.region.rect.height) == height) {
+            copyIntoPage(m_Pages[it->second.region.page], it->second.slot, pixels);
+            return true;
+        }
+
+        remove(mediaID);
+    }
+
+    size_t page = 0;
+    Rect slot;
+    if (allocateSlot(width + 2 * m_Padding, height + 2 * m_Padding, page, slot) == false) {
+        return false;
+    }
+
+    copyIntoPage(m_Pages[page], slot, pixels);
+    m_Pages[page].imageCount++;
+    m_UsedArea += static_cast<uint64_t>(width) * height;
+
+    Entry entry;
+    entry.slot = slot;
+    entry.region.page = page;
+    entry.region.rect = ofRectangle(slot.x + m_Padding, slot.y + m_Padding, width, height);
+    entry.region.uv = ofRectangle(entry.region.rect.x / m_PageSize, entry.region.rect.y / m_PageSize,
+                                  entry.region.rect.width / m_PageSize, entry.region.rect.height / m_PageSize);
+    m_Entries[mediaID] = entry;
+    return true;
+}
+
+bool ofxInstagramAtlas::remove(const std::string &mediaID)
+{
+    auto it = m_Entries.find(mediaID);
+    if (it == m_Entries.end()) {
+        return false;
+    }
+
+    const Entry &entry = it->second;
+    Page &page = m_Pages[entry.region.page];
+    m_UsedArea -= static_cast<uint64_t>(entry.region.rect.width) * entry.region.rect.height;
+    page.imageCount--;
+    if (page.imageCount == 0) {
+        //Nothing left on the page, start it over so differently sized images can use it
+        page.shelves.clear();
+        page.freeRects.clear();
+        page.nextShelfY = 0;
+    }
+    else {
+        page.freeRects.push_back(entry.slot);
+    }
+
+    m_Entries.erase(it);
+    return true;
+}
+
+bool ofxInstagramAtlas::contains(const std::string &mediaID) const
+{
+    return m_Entries.find(mediaID) != m_Entries.end();
+}
+
+void ofxInstagramAtlas::clear()
+{
+    m_Pages.clear();
+    m_Entries.clear();
+    m_UsedArea = 0;
+}
+
+const ofxInstagramAtlas::Region *ofxInstagramAtlas::getRegion(const std::string &mediaID) const
+{
+    auto it = m_Entries.find(mediaID);
+    return it != m_Entries.end() ? &it->second.region : nullptr;
+}
+
+bool ofxInstagramAtlas::addToMesh(ofMesh &mesh, const std::string &mediaID, const ofRectangle &bounds, bool normalized) const
+{
+    const Region *region = getRegion(mediaID);
+    if (region == nullptr) {
+        return false;
+    }
+
+    const ofRectangle &texCoords = normalized ? region->uv : region->rect;
+    const ofIndexType firstIndex = mesh.getNumVertices();
+
+    mesh.addVertex(ofVec3f(bounds.x, bounds.y, 0));
+    mesh.addTexCoord(ofVec2f(texCoords.x, texCoords.y));
+    mesh.addVertex(ofVec3f(bounds.x + bounds.width, bounds.y, 0));
+    mesh.addTexCoord(ofVec2f(texCoords.x + texCoords.width, texCoords.y));
+    mesh.addVertex(ofVec3f(bounds.x + bounds.width, bounds.y + bounds.height, 0));
+    mesh.addTexCoord(ofVec2f(texCoords.x + texCoords.width, texCoords.y + texCoords.height));
+    mesh.addVertex(ofVec3f(bounds.x, bounds.y + bounds.height, 0));
+    mesh.addTexCoord(ofVec2f(texCoords.x, texCoords.y + texCoords.height));
+
+    mesh.addIndex(firstIndex);
+    mesh.addIndex(firstIndex + 1);
+    mesh.addIndex(firstIndex + 2);
+    mesh.addIndex(firstIndex);
+    mesh.addIndex(firstIndex + 2);
+    mesh.addIndex(firstIndex + 3);
+    return true;
+}
+
+size_t ofxInstagramAtlas::getPageCount() const
+{
+    return m_Pages.size();
+}
+
+const ofPixels &ofxInstagramAtlas::getPagePixels(size_t page) const
+{
+    return m_Pages.at(page).pixels;
+}
+
+bool ofxInstagramAtlas::isPageDirty(size_t page) const
+{
+    return page < m_Pages.size() && m_Pages[page].isDirty;
+}
+
+void ofxInstagramAtlas::setPageClean(size_t page)
+{
+    if (page < m_Pages.size()) {
+        m_Pages[page].isDirty = false;
+    }
+}
+
+size_t ofxInstagramAtlas::size() const
+{
+    return m_Entries.size();
+}
+
+float ofxInstagramAtlas::getFillRatio() const
+{
+    if (m_Pages.empty()) {
+        return 0.0f;
+    }
+
+    return static_cast<float>(static_cast<double>(m_UsedArea) / (static_cast<double>(m_PageSize) * m_PageSize * m_Pages.size()));
+}
+
+bool ofxInstagramAtlas::allocateSlot(int width, int height, size_t &page, Rect &slot)
+{
+    if (width > m_PageSize || height > m_PageSize) {
+        return false;
+    }
+
+    for (size_t pageIndex = 0; pageIndex < m_Pages.size(); pageIndex++) {
+        if (allocateInPage(m_Pages[pageIndex], width, height, slot)) {
+            page = pageIndex;
+            return true;
+        }
+    }
+
+    if (m_MaxPages != 0 && m_Pages.size() >= m_MaxPages) {
+        return false;
+    }
+
+    m_Pages.push_back(Page());
+    Page &newPage = m_Pages.back();
+    newPage.pixels.allocate(m_PageSize, m_PageSize, m_Channels);
+    std::memset(newPage.pixels.getData(), 0, static_cast<size_t>(m_PageSize) * m_PageSize * m_Channels);
+
+    page = m_Pages.size() - 1;
+    return allocateInPage(newPage, width, height, slot);
+}
+
+bool ofxInstagramAtlas::allocateInPage(Page &page, int width, int height, Rect &slot) const
+{
+    //The free rectangle that wastes the least area
+    auto bestFree = page.freeRects.end();
+    int bestWaste = std::numeric_limits<int>::max();
+    for (auto it = page.freeRects.begin(); it != page.freeRects.end(); ++it) {
+        const int waste = it->width * it->height - width * height;
+        if (it->width >= width && it->height >= height && waste < bestWaste) {
+            bestFree = it;
+            bestWaste = waste;
+        }
+    }
+
+    if (bestFree != page.freeRects.end()) {
+        const Rect freeRect = *bestFree;
+        page.freeRects.erase(bestFree);
+
+        //What is left is split into the part to the right and the part below
+        if (freeRect.width > width) {
+            page.freeRects.push_back({freeRect.x + width, freeRect.y, freeRect.width - width, height});
+        }
+
+        if (freeRect.height > height) {
+            page.freeRects.push_back({freeRect.x, freeRect.y + height, freeRect.width, freeRect.height - height});
+        }
+
+        slot = {freeRect.x, freeRect.y, width, height};
+        return true;
+    }
+
+    //The lowest shelf that still has room
+    Shelf *bestShelf = nullptr;
+    for (Shelf &shelf : page.shelves) {
+        if (shelf.height >= height && shelf.nextX + width <= m_PageSize && (bestShelf == nullptr || shelf.height < bestShelf->height)) {
+            bestShelf = &shelf;
+        }
+    }
+
+    if (bestShelf == nullptr) {
+        if (page.nextShelfY + height > m_PageSize) {
+            return false;
+        }
+
+        page.shelves.push_back({page.nextShelfY, height, 0});
+        page.nextShelfY += height;
+        bestShelf = &page.shelves.back();
+    }
+
+    slot = {bestShelf->nextX, bestShelf->y, width, height};
+    bestShelf->nextX += width;
+    return true;
+}
+
+void ofxInstagramAtlas::copyIntoPage(Page &page, const Rect &slot, const ofPixels &pixels)
+{
+    const int width = pixels.getWidth(), height = pixels.getHeight();
+    const size_t pixelSize = m_Channels;
+    const size_t sourceStride = width * pixelSize;
+    const size_t pageStride = static_cast<size_t>(m_PageSize) * pixelSize;
+    const unsigned char *source = pixels.getData();
+    unsigned char *destination = page.pixels.getData();
+
+    //The padding rows and columns repeat the nearest edge of the image
+    for (int row = -m_Padding; row < height + m_Padding; row++) {
+        const unsigned char *sourceRow = source + std::min(std::max(row, 0), height - 1) * sourceStride;
+        unsigned char *destinationRow = destination + (slot.y + m_Padding + row) * pageStride + slot.x * pixelSize;
+        for (int column = 0; column < m_Padding; column++) {
+            std::memcpy(destinationRow + column * pixelSize, sourceRow, pixelSize);
+            std::memcpy(destinationRow + (m_Padding + width + column) * pixelSize, sourceRow + (width - 1) * pixelSize, pixelSize);
+        }
+
+        std::memcpy(destinationRow + m_Padding * pixelSize, sourceRow, sourceStride);
+    }
+
+    page.isDirty = true;
+}
@@ -0,0 +1,90 @@
+#ifndef OFXINSTAGRAMATLAS_H
+#define OFXINSTAGRAMATLAS_H
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ofMain.h"
+
+// Packs decoded thumbnails into large pages so a whole grid of posts can be drawn from one texture with one mesh. All of
+// the packing happens on the CPU into ofPixels pages, uploading a page to a texture is left to the caller, which only has
+// to do it for the pages that are marked dirty. Images are placed on shelves, which suits tiles that mostly have the same
+// size, and the space of removed images is reused for images that fit into it.
+class ofxInstagramAtlas
+{
+public:
+    struct Region {
+        size_t page = 0;
+        //In pixels, without the padding
+        ofRectangle rect;
+        //Normalised to the page size
+        ofRectangle uv;
+    };
+
+public:
+    // Images are copied into pages of pageSize x pageSize with the given number of channels. The padding around every image
+    // repeats its edge pixels, so linear filtering does not bleed in from its neighbours. maxPages of 0 means no limit.
+    ofxInstagramAtlas(int pageSize = 2048, int channels = 3, int padding = 1, size_t maxPages = 0);
+
+    // Adding an ID that is already in the atlas replaces its image. Returns false if the image does not fit or the atlas
+    // is full, call remove() to make room.
+    bool add(const std::string &mediaID, const ofPixels &pixels);
+    bool remove(const std::string &mediaID);
+    bool contains(const std::string &mediaID) const;
+    void clear();
+
+    // Returns nullptr if the ID is not in the atlas
+    const Region *getRegion(const std::string &mediaID) const;
+
+    // Adds a textured quad for the image to the mesh, which has to be in OF_PRIMITIVE_TRIANGLES mode. Set normalized to
+    // false when the page is uploaded as a rectangle (ARB) texture. Returns false if the ID is not in the atlas.
+    bool addToMesh(ofMesh &mesh, const std::string &mediaID, const ofRectangle &bounds, bool normalized = true) const;
+
+    size_t getPageCount() const;
+    const ofPixels &getPagePixels(size_t page) const;
+    bool isPageDirty(size_t page) const;
+    // Call after uploading the page
+    void setPageClean(size_t page);
+
+    size_t size() const;
+    // Share of the page area covered by images, from 0 to 1
+    float getFillRatio() const;
+
+private:
+    struct Rect {
+        int x, y, width, height;
+    };
+
+    struct Shelf {
+        int y, height, nextX;
+    };
+
+    struct Page {
+        ofPixels pixels;
+        std::vector<Shelf> shelves;
+        //Space left behind by removed images
+        std::vector<Rect> freeRects;
+        int nextShelfY = 0;
+        size_t imageCount = 0;
+        bool isDirty = true;
+    };
+
+    struct Entry {
+        Region region;
+        //Including the padding
+        Rect slot;
+    };
+
+    const int m_PageSize, m_Channels, m_Padding;
+    const size_t m_MaxPages;
+
+    std::vector<Page> m_Pages;
+    std::unordered_map<std::string, Entry> m_Entries;
+    uint64_t m_UsedArea;
+
+private:
+    bool allocateSlot(int width, int height, size_t &page, Rect &slot);
+    bool allocateInPage(Page &page, int width, int height, Rect &slot) const;
+    void copyIntoPage(Page &page, const Rect &slot, const ofPixels &pixels);
+};
+
+#endif // OFXINSTAGRAMATLAS_H
@@ -0,0 +1,212 @@
+#include "ofxInstagramEnricher.h"
+#include <algorithm>
+#include "ofLog.h"
+#include "ofUtils.h"
+using namespace ofxInstagramTypes;
+
+namespace
+{
+const size_t DEFAULT_MAX_ACTIVE_COUNT = 8;
+}
+
+ofxInstagramEnricher::ofxInstagramEnricher(ofxInstagram &instagram)
+    : m_Async(instagram)
+    , m_EnrichComments(true)
+    , m_EnrichLikes(true)
+    , m_ActiveCount(0)
+    , m_MaxActiveCount(DEFAULT_MAX_ACTIVE_COUNT)
+    , m_PendingPageCount(0)
+{
+
+}
+
+void ofxInstagramEnricher::setEnrichComments(bool enrichComments)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_EnrichComments = enrichComments;
+}
+
+void ofxInstagramEnricher::setEnrichLikes(bool enrichLikes)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_EnrichLikes = enrichLikes;
+}
+
+void ofxInstagramEnricher::setMaxActiveCount(size_t maxActiveCount)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_MaxActiveCount = std::max<size_t>(maxActiveCount, 1);
+    }
+
+    startJobs();
+}
+
+void ofxInstagramEnricher::setRateLimitBackoff(double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_RateLimit.setBackoff(seconds);
+}
+
+void ofxInstagramEnricher::update()
+{
+    startJobs();
+}
+
+void ofxInstagramEnricher::enrich(const Posts &posts, std::function<void(Posts)> callback)
+{
+    std::shared_ptr<Page> page = std::make_shared<Page>();
+    page->posts = posts;
+    page->callback = callback;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stats.pageCount++;
+        for (size_t postIndex = 0; postIndex < page->posts.first.size(); postIndex++) {
+            if (m_EnrichComments) {
+                m_Queue.push_back(Job{page, postIndex, true});
+            }
+
+            if (m_EnrichLikes) {
+                m_Queue.push_back(Job{page, postIndex, false});
+            }
+        }
+
+        page->remainingCount = (m_EnrichComments ? 1 : 0) * page->posts.first.size() + (m_EnrichLikes ? 1 : 0) * page->posts.first.size();
+        if (page->remainingCount != 0) {
+            m_PendingPageCount++;
+        }
+    }
+
+    if (page->remainingCount == 0) {
+        if (callback) {
+            callback(page->posts);
+        }
+
+        return;
+    }
+
+    startJobs();
+}
+
+size_t ofxInstagramEnricher::getQueuedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Queue.size();
+}
+
+size_t ofxInstagramEnricher::getPendingPageCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_PendingPageCount;
+}
+
+ofxInstagramEnricher::Stats ofxInstagramEnricher::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+void ofxInstagramEnricher::startJobs()
+{
+    while (true) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Queue.empty() || m_ActiveCount >= m_MaxActiveCount || m_RateLimit.isPaused(ofGetElapsedTimeMicros())) {
+                return;
+            }
+
+            job = m_Queue.front();
+            m_Queue.pop_front();
+            m_ActiveCount++;
+            m_Stats.requestCount++;
+        }
+
+        //Outside of the lock, since a response can be delivered before the request returns
+        start(job);
+    }
+}
+
+void ofxInstagramEnricher::start(const Job &job)
+{
+    const std::string &mediaID = job.page->posts.first[job.postIndex].id;
+    const auto onError = [this, job](const Meta &error) {
+        if (ofxInstagramRateLimit::isRateLimited(error)) {
+            retry(job);
+            return;
+        }
+
+        ofLogWarning("ofxInstagramEnricher") << __FUNCTION__ << ": Keeping the posts' own " << (job.isComments ? "comments" : "likes")
+                                             << " of " << job.page->posts.first[job.postIndex].id << ", " << error.errorType;
+        finish(job, true);
+    };
+
+    //The lists of the API can stop short of the counts of the feed, so a count is only raised
+    if (job.isComments) {
+        m_Async.getCommentsForMedia(mediaID).then([this, job](const std::vector<Comment> &comments) {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                PostData &post = job.page->posts.first[job.postIndex];
+                post.comments = comments;
+                post.commentCount = std::max<unsigned int>(post.commentCount, comments.size());
+            }
+
+            finish(job, false);
+        }, onError);
+    }
+    else {
+        m_Async.getListOfUsersWhoLikedMedia(mediaID).then([this, job](const std::vector<UserInfo> &likes) {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                PostData &post = job.page->posts.first[job.postIndex];
+                post.likes = likes;
+                post.likeCount = std::max<unsigned int>(post.likeCount, likes.size());
+            }
+
+            finish(job, false);
+        }, onError);
+    }
+}
+
+void ofxInstagramEnricher::retry(const Job &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ActiveCount--;
+        m_Stats.rateLimitedCount++;
+        m_Queue.push_front(job);
+        //The other requests of the burst are limited as well, only the first one of them starts the pause
+        const uint64_t now = ofGetElapsedTimeMicros();
+        if (m_RateLimit.backOff(now)) {
+            ofLogWarning("ofxInstagramEnricher") << __FUNCTION__ << ": Rate limited, waiting " << (m_RateLimit.getResumeTime() - now) / 1000000.0 << " s.";
+        }
+    }
+
+    startJobs();
+}
+
+void ofxInstagramEnricher::finish(const Job &job, bool isFailed)
+{
+    bool isPageDone = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ActiveCount--;
+        if (isFailed) {
+            m_Stats.failedCount++;
+        }
+        else {
+            m_RateLimit.reset();
+        }
+
+        isPageDone = --job.page->remainingCount == 0;
+        if (isPageDone) {
+            m_PendingPageCount--;
+        }
+    }
+
+    //The next requests go out before the page is delivered, so a slow callback does not hold them up
+    startJobs();
+    if (isPageDone && job.page->callback) {
+        job.page->callback(std::move(job.page->posts));
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef OFXINSTAGRAMENRICHER_H
+#define OFXINSTAGRAMENRICHER_H
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "ofxInstagramAsync.h"
+#include "ofxInstagramRateLimit.h"
+
+// Fills in the comments and the likes of a page of posts. The feeds only carry the first few of each, so enrich() requests
+// the comments and the users who liked every post, at most setMaxActiveCount() of them at once over all pages, and
+// delivers the page once all of them arrived. The comment and like counts are raised to the lists when they are longer. A
+// post whose request fails keeps what the feed had. A rate limited comment or like request goes back to the front of the
+// queue, and the queue waits for the back off of ofxInstagramRateLimit before update() sends it again. The callback runs
+// on the thread that delivered the last response of the page, or at once when there was nothing to request. The enricher
+// has to outlive the pages it is working on.
+//
+//     enricher.enrich(posts, [](ofxInstagramTypes::Posts enrichedPosts) { ... });
+//     ...
+//     enricher.update();
+class ofxInstagramEnricher
+{
+public:
+    struct Stats {
+        uint64_t pageCount = 0,
+                 requestCount = 0,
+                 rateLimitedCount = 0,
+                 failedCount = 0;
+    };
+
+public:
+    explicit ofxInstagramEnricher(ofxInstagram &instagram);
+
+    // Both are requested by default
+    void setEnrichComments(bool enrichComments);
+    void setEnrichLikes(bool enrichLikes);
+    // Requests that are on their way at once, the rest wait for them. 8 by default.
+    void setMaxActiveCount(size_t maxActiveCount);
+    // Seconds to wait after the first rate limit response
+    void setRateLimitBackoff(double seconds);
+
+    void enrich(const ofxInstagramTypes::Posts &posts, std::function<void(ofxInstagramTypes::Posts)> callback);
+    // Makes the requests that waited for a rate limit back off, call it from ofApp::update()
+    void update();
+
+    // Requests waiting for the ones on their way, and pages waiting for their requests
+    size_t getQueuedCount() const;
+    size_t getPendingPageCount() const;
+    Stats getStats() const;
+
+private:
+    struct Page {
+        ofxInstagramTypes::Posts posts;
+        std::function<void(ofxInstagramTypes::Posts)> callback;
+        size_t remainingCount = 0;
+    };
+
+    struct Job {
+        std::shared_ptr<Page> page;
+        size_t postIndex;
+        bool isComments;
+    };
+
+    ofxInstagramAsync m_Async;
+    bool m_EnrichComments, m_EnrichLikes;
+
+    std::deque<Job> m_Queue;
+    size_t m_ActiveCount, m_MaxActiveCount, m_PendingPageCount;
+    ofxInstagramRateLimit m_RateLimit;
+    Stats m_Stats;
+    mutable std::mutex m_Mutex;
+
+private:
+    void startJobs();
+    void start(const Job &job);
+    void retry(const Job &job);
+    void finish(const Job &job, bool isFailed);
+};
+
+#endif // OFXINSTAGRAMENRICHER_H
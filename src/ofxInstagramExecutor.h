@@ -0,0 +1,34 @@
+#ifndef OFXINSTAGRAMEXECUTOR_H
+#define OFXINSTAGRAMEXECUTOR_H
+#include <functional>
+#include <memory>
+
+// Runs the delivery of responses, see ofxInstagram::setExecutor(). Without an executor a response is decoded and its
+// callbacks are called inline on the thread that delivered it. ofxInstagramMainThreadExecutor queues them for the main
+// thread and ofxInstagramThreadPoolExecutor runs them on its own threads. To deliver on a thread pool of your own, derive
+// from this and hand the task to the pool in execute().
+class ofxInstagramExecutor
+{
+public:
+    virtual ~ofxInstagramExecutor() {}
+
+    // Can be called from any thread
+    virtual void execute(std::function<void()> task) = 0;
+
+    // Wraps the callback of a single request so that it is called on executor, while the response is decoded wherever
+    // the client delivers it:
+    //     instagram.getUserFeed(20, "self", ofxInstagramExecutor::wrap<ofxInstagramTypes::Posts>(pool, onFeed));
+    template<typename Value>
+    static std::function<void(Value)> wrap(std::shared_ptr<ofxInstagramExecutor> executor, std::function<void(Value)> callback)
+    {
+        if (!executor || !callback) {
+            return callback;
+        }
+
+        return [executor, callback](Value value) {
+            executor->execute(std::bind(callback, std::move(value)));
+        };
+    }
+};
+
+#endif // OFXINSTAGRAMEXECUTOR_H
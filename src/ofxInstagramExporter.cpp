@@ -0,0 +1,468 @@
+#include "ofxInstagramExporter.h"
+#include "ofLog.h"
+#include <cstdio>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+const size_t DEFAULT_MAX_QUEUED_POSTS = 4096;
+const size_t DEFAULT_BATCH_BYTES = 1 << 20;
+
+//The values are appended with a trailing comma, closing the object or array replaces the last one
+void appendEscaped(std::string &line, const std::string &value)
+{
+    line += '"';
+    for (const char character : value) {
+        switch (character) {
+            case '"':
+                line += "\\\"";
+                break;
+            case '\\':
+                line += "\\\\";
+                break;
+            case '\n':
+                line += "\\n";
+                break;
+            case '\r':
+                line += "\\r";
+                break;
+            case '\t':
+                line += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(character));
+                    line += escaped;
+                }
+                else {
+                    line += character;
+                }
+                break;
+        }
+    }
+
+    line += '"';
+}
+
+void appendKey(std::string &line, const char *key)
+{
+    line += '"';
+    line += key;
+    line += "\":";
+}
+
+void appendField(std::string &line, const char *key, const std::string &value)
+{
+    appendKey(line, key);
+    appendEscaped(line, value);
+    line += ',';
+}
+
+void appendField(std::string &line, const char *key, unsigned int value)
+{
+    appendKey(line, key);
+    line += std::to_string(value);
+    line += ',';
+}
+
+void appendField(std::string &line, const char *key, float value)
+{
+    //Nine significant digits bring back the same float when it is parsed again
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.9g", value);
+    appendKey(line, key);
+    line += number;
+    line += ',';
+}
+
+void closeBracket(std::string &line, char bracket)
+{
+    if (line.back() == ',') {
+        line.back() = bracket;
+    }
+    else {
+        line += bracket;
+    }
+}
+
+void appendUser(std::string &line, const UserInfo &user)
+{
+    line += '{';
+    appendField(line, "username", user.username);
+    appendField(line, "full_name", user.fullName);
+    appendField(line, "id", user.id);
+    appendField(line, "profile_picture", user.profilePicture);
+    if (user.bio.length() != 0) {
+        appendField(line, "bio", user.bio);
+    }
+
+    if (user.website.length() != 0) {
+        appendField(line, "website", user.website);
+    }
+
+    if (user.followerCount != 0 || user.followingCount != 0 || user.mediaCount != 0) {
+        appendKey(line, "counts");
+        line += '{';
+        appendField(line, "followed_by", user.followerCount);
+        appendField(line, "follows", user.followingCount);
+        appendField(line, "media", user.mediaCount);
+        closeBracket(line, '}');
+        line += ',';
+    }
+
+    closeBracket(line, '}');
+}
+
+void appendMedia(std::string &line, const char *key, const PostMedia &media)
+{
+    if (media.url.length() == 0) {
+        return;
+    }
+
+    appendKey(line, key);
+    line += '{';
+    appendField(line, "url", media.url);
+    appendField(line, "width", media.width);
+    appendField(line, "height", media.height);
+    closeBracket(line, '}');
+    line += ',';
+}
+}
+
+ofxInstagramExporter::ofxInstagramExporter()
+    : m_MaxQueuedPosts(DEFAULT_MAX_QUEUED_POSTS)
+    , m_BatchBytes(DEFAULT_BATCH_BYTES)
+    , m_WritingCount(0)
+    , m_IsRunning(false)
+    , m_IsFlushRequested(false)
+{
+
+}
+
+ofxInstagramExporter::~ofxInstagramExporter()
+{
+    close();
+}
+
+bool ofxInstagramExporter::open(const std::string &path, bool append)
+{
+    close();
+    m_File.open(path.c_str(), std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (m_File.is_open() == false) {
+        ofLogError("ofxInstagramExporter") << __FUNCTION__ << ": Cannot open " << path;
+        return false;
+    }
+
+    m_Stats = Stats();
+    m_IsRunning = true;
+    m_Thread = std::thread(&ofxInstagramExporter::threadedFunction, this);
+    return true;
+}
+
+void ofxInstagramExporter::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_IsRunning == false) {
+            return;
+        }
+
+        m_IsRunning = false;
+    }
+
+    //The thread writes what is left in the queue before it exits
+    m_QueueCondition.notify_all();
+    m_SpaceCondition.notify_all();
+    m_Thread.join();
+    m_File.close();
+    m_FlushCondition.notify_all();
+}
+
+bool ofxInstagramExporter::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_IsRunning;
+}
+
+void ofxInstagramExporter::setMaxQueuedPosts(size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxQueuedPosts = std::max<size_t>(count, 1);
+}
+
+void ofxInstagramExporter::setBatchBytes(size_t byteCount)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_BatchBytes = byteCount;
+}
+
+void ofxInstagramExporter::write(const PostData &post)
+{
+    PostData copy = post;
+    push(std::move(copy));
+}
+
+void ofxInstagramExporter::write(PostData &&post)
+{
+    push(std::move(post));
+}
+
+void ofxInstagramExporter::write(const Posts &posts)
+{
+    for (const PostData &post : posts.first) {
+        write(post);
+    }
+}
+
+void ofxInstagramExporter::write(const SharedPosts &posts)
+{
+    for (const PostHandle &post : posts.first) {
+        if (post) {
+            write(*post);
+        }
+    }
+}
+
+void ofxInstagramExporter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (m_IsRunning == false) {
+        return;
+    }
+
+    m_IsFlushRequested = true;
+    m_QueueCondition.notify_one();
+    m_FlushCondition.wait(lock, [this]() {
+        return m_IsFlushRequested == false || m_IsRunning == false;
+    });
+}
+
+ofxInstagramExporter::Stats ofxInstagramExporter::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats = m_Stats;
+    stats.queuedCount = m_Queue.size() + m_WritingCount;
+    return stats;
+}
+
+void ofxInstagramExporter::encodePost(const PostData &post, std::string &line)
+{
+    line += '{';
+    appendField(line, "id", post.id);
+    appendField(line, "type", post.type);
+    appendField(line, "created_time", post.createdTime);
+    appendField(line, "link", post.link);
+    appendField(line, "filter", post.filter);
+    if (post.attribution.length() != 0) {
+        appendField(line, "attribution", post.attribution);
+    }
+
+    appendKey(line, "user_has_liked");
+    line += post.userHasLiked ? "true," : "false,";
+    appendKey(line, "user");
+    appendUser(line, post.user);
+    line += ',';
+
+    //Location
+    if (post.location.id.length() != 0 || post.location.name.length() != 0 || post.location.latitude != 0.f ||
+        post.location.longitude != 0.f) {
+        appendKey(line, "location");
+        line += '{';
+        appendField(line, "id", post.location.id);
+        appendField(line, "name", post.location.name);
+        appendField(line, "latitude", post.location.latitude);
+        appendField(line, "longitude", post.location.longitude);
+        closeBracket(line, '}');
+        line += ',';
+    }
+
+    //Caption
+    if (post.caption.id.length() != 0 || post.caption.text.length() != 0) {
+        appendKey(line, "caption");
+        line += '{';
+        appendField(line, "created_time", post.caption.createdTime);
+        appendField(line, "id", post.caption.id);
+        appendField(line, "text", post.caption.text);
+        appendKey(line, "from");
+        appendUser(line, post.caption.from);
+        line += '}';
+        line += ',';
+    }
+
+    //Comments
+    appendKey(line, "comments");
+    line += '{';
+    appendField(line, "count", post.commentCount);
+    appendKey(line, "data");
+    line += '[';
+    for (const Comment &comment : post.comments) {
+        line += '{';
+        appendField(line, "created_time", comment.createdTime);
+        appendField(line, "id", comment.id);
+        appendField(line, "text", comment.text);
+        appendKey(line, "from");
+        appendUser(line, comment.from);
+        line += "},";
+    }
+
+    closeBracket(line, ']');
+    line += "},";
+
+    //Images and Videos
+    appendKey(line, "images");
+    line += '{';
+    appendMedia(line, "low_resolution", post.imageLowResolution);
+    appendMedia(line, "standard_resolution", post.imageStandarResolution);
+    appendMedia(line, "thumbnail", post.imageThumbnail);
+    closeBracket(line, '}');
+    line += ',';
+
+    if (post.videoLowBandwidth.url.length() != 0 || post.videoLowResolution.url.length() != 0 ||
+            post.videoStandartResolution.url.length() != 0) {
+        appendKey(line, "videos");
+        line += '{';
+        appendMedia(line, "low_bandwidth", post.videoLowBandwidth);
+        appendMedia(line, "low_resolution", post.videoLowResolution);
+        appendMedia(line, "standard_resolution", post.videoStandartResolution);
+        closeBracket(line, '}');
+        line += ',';
+    }
+
+    //Likes
+    appendKey(line, "likes");
+    line += '{';
+    appendField(line, "count", post.likeCount);
+    appendKey(line, "data");
+    line += '[';
+    for (const UserInfo &user : post.likes) {
+        appendUser(line, user);
+        line += ',';
+    }
+
+    closeBracket(line, ']');
+    line += "},";
+
+    //Tags
+    appendKey(line, "tags");
+    line += '[';
+    for (const std::string &tag : post.tags) {
+        appendEscaped(line, tag);
+        line += ',';
+    }
+
+    closeBracket(line, ']');
+    line += ',';
+
+    //Users In Photo
+    appendKey(line, "users_in_photo");
+    line += '[';
+    for (const std::pair<Position, UserInfo> &userInPhoto : post.usersInPhoto) {
+        line += '{';
+        appendKey(line, "position");
+        line += '{';
+        appendField(line, "x", userInPhoto.first.x);
+        appendField(line, "y", userInPhoto.first.y);
+        closeBracket(line, '}');
+        line += ',';
+        appendKey(line, "user");
+        appendUser(line, userInPhoto.second);
+        line += "},";
+    }
+
+    closeBracket(line, ']');
+    line += '}';
+}
+
+void ofxInstagramExporter::threadedFunction()
+{
+    std::deque<PostData> batch;
+    std::string buffer;
+
+    while (true) {
+        size_t batchBytes = 0;
+        bool isFlushRequested = false;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_QueueCondition.wait(lock, [this]() {
+                return m_Queue.empty() == false || m_IsFlushRequested || m_IsRunning == false;
+            });
+
+            if (m_Queue.empty() && m_IsRunning == false) {
+                break;
+            }
+
+            //Everything that piled up while the last batch was written goes out together
+            batch.swap(m_Queue);
+            m_WritingCount = batch.size();
+            batchBytes = m_BatchBytes;
+            isFlushRequested = m_IsFlushRequested;
+        }
+
+        m_SpaceCondition.notify_all();
+
+        uint64_t byteCount = 0;
+        for (const PostData &post : batch) {
+            encodePost(post, buffer);
+            buffer += '\n';
+            if (buffer.size() >= batchBytes) {
+                m_File.write(buffer.data(), buffer.size());
+                byteCount += buffer.size();
+                buffer.clear();
+            }
+        }
+
+        if (buffer.empty() == false) {
+            m_File.write(buffer.data(), buffer.size());
+            byteCount += buffer.size();
+            buffer.clear();
+        }
+
+        if (isFlushRequested) {
+            m_File.flush();
+        }
+
+        if (m_File.good() == false) {
+            ofLogError("ofxInstagramExporter") << __FUNCTION__ << ": Writing failed, " << batch.size() << " posts are lost.";
+            m_File.clear();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (batch.empty() == false) {
+                m_Stats.postCount += batch.size();
+                m_Stats.byteCount += byteCount;
+                m_Stats.batchCount++;
+            }
+
+            m_WritingCount = 0;
+            //A flush that came in while writing waits for the next round, which picks up the posts queued before it
+            if (isFlushRequested) {
+                m_IsFlushRequested = false;
+            }
+        }
+
+        batch.clear();
+        m_FlushCondition.notify_all();
+    }
+
+    m_File.flush();
+}
+
+void ofxInstagramExporter::push(PostData &&post)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_SpaceCondition.wait(lock, [this]() {
+            return m_Queue.size() < m_MaxQueuedPosts || m_IsRunning == false;
+        });
+
+        if (m_IsRunning == false) {
+            return;
+        }
+
+        m_Queue.push_back(std::move(post));
+    }
+
+    m_QueueCondition.notify_one();
+}
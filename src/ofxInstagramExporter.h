@@ -0,0 +1,73 @@
+#ifndef OFXINSTAGRAMEXPORTER_H
+#define OFXINSTAGRAMEXPORTER_H
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ofxInstagramTypes.h"
+
+// Appends posts to a file of newline delimited JSON, one post per line in the same format as the "data" entries of the
+// API, so ofxInstagram::constructPostData() and ofxInstagramImporter read them back. Posts are encoded and written on a
+// background thread in batches. The number of posts waiting to be written is bounded, write() blocks while the queue is
+// full so that exporting a long crawl does not hold it in memory.
+class ofxInstagramExporter
+{
+public:
+    struct Stats {
+        size_t queuedCount = 0;
+
+        uint64_t postCount = 0,
+                 byteCount = 0,
+                 batchCount = 0;
+    };
+
+public:
+    ofxInstagramExporter();
+    ~ofxInstagramExporter();
+
+    // Starts a new file unless append is true
+    bool open(const std::string &path, bool append = false);
+    // Writes what is still queued and closes the file
+    void close();
+    bool isOpen() const;
+
+    // Number of posts the queue holds before write() waits for the background thread
+    void setMaxQueuedPosts(size_t count);
+    // Encoded posts are kept in memory until they add up to this many bytes, then written with one call
+    void setBatchBytes(size_t byteCount);
+
+    void write(const ofxInstagramTypes::PostData &post);
+    void write(ofxInstagramTypes::PostData &&post);
+    void write(const ofxInstagramTypes::Posts &posts);
+    void write(const ofxInstagramTypes::SharedPosts &posts);
+
+    // Blocks until everything that was queued so far is on disk
+    void flush();
+
+    Stats getStats() const;
+
+    // Encodes a post as a single line of JSON, without the line break, and appends it to line
+    static void encodePost(const ofxInstagramTypes::PostData &post, std::string &line);
+
+private:
+    std::ofstream m_File;
+    std::thread m_Thread;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_QueueCondition, m_SpaceCondition, m_FlushCondition;
+    std::deque<ofxInstagramTypes::PostData> m_Queue;
+    size_t m_MaxQueuedPosts, m_BatchBytes;
+    //Posts taken off the queue that are not on disk yet
+    size_t m_WritingCount;
+    bool m_IsRunning, m_IsFlushRequested;
+    Stats m_Stats;
+
+private:
+    void threadedFunction();
+    void push(ofxInstagramTypes::PostData &&post);
+};
+
+#endif // OFXINSTAGRAMEXPORTER_H
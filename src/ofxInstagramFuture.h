@@ -0,0 +1,271 @@
+#ifndef OFXINSTAGRAMFUTURE_H
+#define OFXINSTAGRAMFUTURE_H
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "ofxInstagramTypes.h"
+
+template<typename Value>
+class ofxInstagramPromise;
+
+// The result of a request that is yet to arrive, see ofxInstagramAsync. It either gets a value or fails with the meta of
+// the error response. Continuations passed to then() run on the thread that delivers the response, or at once when the
+// future is ready. Copies share the result. When the request is dropped without an answer, such as by a client that is
+// destroyed while it is pending, the future fails with the error type "BrokenPromise".
+//
+// With C++20 it can be awaited in a coroutine, which resumes on the delivering thread:
+//     ofxInstagramTypes::Posts posts = co_await async.getUserFeed(20);
+template<typename Value>
+class ofxInstagramFuture
+{
+public:
+    using ErrorCallback = std::function<void(const ofxInstagramTypes::Meta &)>;
+
+public:
+    ofxInstagramFuture()
+        : m_State(std::make_shared<State>())
+    {
+
+    }
+
+    bool isReady() const
+    {
+        std::lock_guard<std::mutex> lock(m_State->mutex);
+        return m_State->isReady;
+    }
+
+    bool isFailed() const
+    {
+        std::lock_guard<std::mutex> lock(m_State->mutex);
+        return m_State->isFailed;
+    }
+
+    // Blocks until the future is ready. Never call it on the thread that delivers the responses, such as the main thread
+    // with ofLoadURLAsync(), since it would wait for itself. The value of a failed future is empty.
+    const Value &get() const
+    {
+        std::unique_lock<std::mutex> lock(m_State->mutex);
+        m_State->condition.wait(lock, [this]() {
+            return m_State->isReady;
+        });
+
+        return m_State->value;
+    }
+
+    // Blocks until the future is ready or the timeout passed, and returns whether it is ready. get() returns at once
+    // after it returned true.
+    bool waitFor(std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock<std::mutex> lock(m_State->mutex);
+        return m_State->condition.wait_for(lock, timeout, [this]() {
+            return m_State->isReady;
+        });
+    }
+
+    ofxInstagramTypes::Meta getError() const
+    {
+        std::lock_guard<std::mutex> lock(m_State->mutex);
+        return m_State->error;
+    }
+
+    void then(std::function<void(const Value &)> onValue, ErrorCallback onError = nullptr) const
+    {
+        std::shared_ptr<State> state = m_State;
+        addContinuation([state, onValue, onError]() {
+            if (state->isFailed == false && onValue) {
+                onValue(state->value);
+            }
+            else if (state->isFailed && onError) {
+                onError(state->error);
+            }
+        });
+    }
+
+    //For co_await
+    bool await_ready() const
+    {
+        return isReady();
+    }
+
+    template<typename Handle>
+    void await_suspend(Handle handle) const
+    {
+        addContinuation([handle]() mutable {
+            handle.resume();
+        });
+    }
+
+    Value await_resume() const
+    {
+        return get();
+    }
+
+private:
+    friend class ofxInstagramPromise<Value>;
+
+    struct State {
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool isReady = false,
+             isFailed = false;
+
+        Value value;
+        ofxInstagramTypes::Meta error;
+        std::vector<std::function<void()>> continuations;
+    };
+
+    std::shared_ptr<State> m_State;
+
+private:
+    void addContinuation(std::function<void()> continuation) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_State->mutex);
+            if (m_State->isReady == false) {
+                m_State->continuations.push_back(std::move(continuation));
+                return;
+            }
+        }
+
+        continuation();
+    }
+};
+
+// The side of a future that sets its result. Only the first value or error counts. Copies share the future, once the last
+// one is destroyed without setting a result the future fails with the error type "BrokenPromise".
+template<typename Value>
+class ofxInstagramPromise
+{
+public:
+    ofxInstagramPromise()
+        : m_Owner(std::make_shared<Owner>())
+    {
+
+    }
+
+    ofxInstagramFuture<Value> getFuture() const
+    {
+        return m_Owner->future;
+    }
+
+    void setValue(Value value)
+    {
+        resolve(m_Owner->future, [&value](typename ofxInstagramFuture<Value>::State &state) {
+            state.value = std::move(value);
+        });
+    }
+
+    void setError(const ofxInstagramTypes::Meta &error)
+    {
+        resolve(m_Owner->future, [&error](typename ofxInstagramFuture<Value>::State &state) {
+            state.isFailed = true;
+            state.error = error;
+        });
+    }
+
+private:
+    //Shared by the copies of the promise, such as the ones in the callbacks of a request
+    struct Owner {
+        ofxInstagramFuture<Value> future;
+
+        ~Owner()
+        {
+            ofxInstagramTypes::Meta error;
+            error.errorType = "BrokenPromise";
+            error.errorMessage = "The promise was destroyed without a result";
+            resolve(future, [&error](typename ofxInstagramFuture<Value>::State &state) {
+                state.isFailed = true;
+                state.error = error;
+            });
+        }
+    };
+
+    std::shared_ptr<Owner> m_Owner;
+
+private:
+    static void resolve(const ofxInstagramFuture<Value> &future, const std::function<void(typename ofxInstagramFuture<Value>::State &)> &setResult)
+    {
+        //The future may be all that is left of the promise once it is ready, so the state is kept alive until this returns
+        const std::shared_ptr<typename ofxInstagramFuture<Value>::State> sharedState = future.m_State;
+        typename ofxInstagramFuture<Value>::State &state = *sharedState;
+        std::vector<std::function<void()>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.isReady) {
+                return;
+            }
+
+            setResult(state);
+            state.isReady = true;
+            continuations.swap(state.continuations);
+        }
+
+        state.condition.notify_all();
+        for (std::function<void()> &continuation : continuations) {
+            continuation();
+        }
+    }
+};
+
+// Ready once all the futures are, with their values in the same order. Fails with the first error.
+template<typename Value>
+ofxInstagramFuture<std::vector<Value>> ofxInstagramWhenAll(const std::vector<ofxInstagramFuture<Value>> &futures)
+{
+    struct Join {
+        ofxInstagramPromise<std::vector<Value>> promise;
+        std::vector<Value> values;
+        size_t remainingCount;
+        std::mutex mutex;
+    };
+
+    std::shared_ptr<Join> join = std::make_shared<Join>();
+    join->values.resize(futures.size());
+    join->remainingCount = futures.size();
+    if (futures.empty()) {
+        join->promise.setValue(std::vector<Value>());
+        return join->promise.getFuture();
+    }
+
+    for (size_t futureIndex = 0; futureIndex < futures.size(); futureIndex++) {
+        futures[futureIndex].then([join, futureIndex](const Value &value) {
+            bool isDone = false;
+            {
+                std::lock_guard<std::mutex> lock(join->mutex);
+                join->values[futureIndex] = value;
+                isDone = --join->remainingCount == 0;
+            }
+
+            if (isDone) {
+                join->promise.setValue(std::move(join->values));
+            }
+        }, [join](const ofxInstagramTypes::Meta &error) {
+            join->promise.setError(error);
+        });
+    }
+
+    return join->promise.getFuture();
+}
+
+// Ready once both futures are, such as the comments and the likes of a post
+template<typename First, typename Second>
+ofxInstagramFuture<std::pair<First, Second>> ofxInstagramWhenAll(const ofxInstagramFuture<First> &first, const ofxInstagramFuture<Second> &second)
+{
+    ofxInstagramPromise<std::pair<First, Second>> promise;
+    first.then([promise, second](const First &firstValue) mutable {
+        second.then([promise, firstValue](const Second &secondValue) mutable {
+            promise.setValue(std::make_pair(firstValue, secondValue));
+        }, [promise](const ofxInstagramTypes::Meta &error) mutable {
+            promise.setError(error);
+        });
+    }, [promise](const ofxInstagramTypes::Meta &error) mutable {
+        promise.setError(error);
+    });
+
+    return promise.getFuture();
+}
+
+#endif // OFXINSTAGRAMFUTURE_H
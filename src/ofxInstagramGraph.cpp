@@ -0,0 +1,142 @@
+#include "ofxInstagramGraph.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+const ofxInstagramGraph::Node ofxInstagramGraph::NO_NODE = std::numeric_limits<Node>::max();
+
+namespace
+{
+const std::string NO_USER = "";
+}
+
+ofxInstagramGraph::ofxInstagramGraph()
+{
+    clear();
+}
+
+void ofxInstagramGraph::build(std::vector<std::string> userIDs, std::vector<std::string> usernames, std::vector<std::pair<Node, Node>> edges)
+{
+    m_UserIDs = std::move(userIDs);
+    m_Usernames = std::move(usernames);
+    m_Usernames.resize(m_UserIDs.size());
+    m_Nodes.clear();
+    m_Nodes.reserve(m_UserIDs.size());
+    for (Node node = 0; node < m_UserIDs.size(); node++) {
+        m_Nodes[m_UserIDs[node]] = node;
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    buildRows(m_UserIDs.size(), edges, m_FollowingOffsets, m_Following);
+
+    for (std::pair<Node, Node> &edge : edges) {
+        std::swap(edge.first, edge.second);
+    }
+
+    std::sort(edges.begin(), edges.end());
+    buildRows(m_UserIDs.size(), edges, m_FollowerOffsets, m_Followers);
+}
+
+void ofxInstagramGraph::clear()
+{
+    m_UserIDs.clear();
+    m_Usernames.clear();
+    m_Nodes.clear();
+    m_FollowingOffsets.assign(1, 0);
+    m_FollowerOffsets.assign(1, 0);
+    m_Following.clear();
+    m_Followers.clear();
+}
+
+size_t ofxInstagramGraph::getNodeCount() const
+{
+    return m_UserIDs.size();
+}
+
+size_t ofxInstagramGraph::getEdgeCount() const
+{
+    return m_Following.size();
+}
+
+ofxInstagramGraph::Node ofxInstagramGraph::getNode(const std::string &userID) const
+{
+    auto nodeIt = m_Nodes.find(userID);
+    return nodeIt == m_Nodes.end() ? NO_NODE : nodeIt->second;
+}
+
+const std::string &ofxInstagramGraph::getUserID(Node node) const
+{
+    return node < m_UserIDs.size() ? m_UserIDs[node] : NO_USER;
+}
+
+const std::string &ofxInstagramGraph::getUsername(Node node) const
+{
+    return node < m_Usernames.size() ? m_Usernames[node] : NO_USER;
+}
+
+ofxInstagramGraph::Nodes ofxInstagramGraph::getFollowing(Node node) const
+{
+    if (node >= m_UserIDs.size()) {
+        return Nodes(nullptr, nullptr);
+    }
+
+    return Nodes(m_Following.data() + m_FollowingOffsets[node], m_Following.data() + m_FollowingOffsets[node + 1]);
+}
+
+ofxInstagramGraph::Nodes ofxInstagramGraph::getFollowers(Node node) const
+{
+    if (node >= m_UserIDs.size()) {
+        return Nodes(nullptr, nullptr);
+    }
+
+    return Nodes(m_Followers.data() + m_FollowerOffsets[node], m_Followers.data() + m_FollowerOffsets[node + 1]);
+}
+
+bool ofxInstagramGraph::isFollowing(Node follower, Node followed) const
+{
+    const Nodes following = getFollowing(follower);
+    return std::binary_search(following.first, following.second, followed);
+}
+
+std::vector<ofxInstagramGraph::Node> ofxInstagramGraph::getMutualFollows(Node node) const
+{
+    const Nodes following = getFollowing(node);
+    const Nodes followers = getFollowers(node);
+    std::vector<Node> mutualFollows;
+    std::set_intersection(following.first, following.second, followers.first, followers.second, std::back_inserter(mutualFollows));
+    return mutualFollows;
+}
+
+std::vector<ofxInstagramGraph::Node> ofxInstagramGraph::getCommonFollowing(Node first, Node second) const
+{
+    const Nodes firstFollowing = getFollowing(first);
+    const Nodes secondFollowing = getFollowing(second);
+    std::vector<Node> commonFollowing;
+    std::set_intersection(firstFollowing.first, firstFollowing.second, secondFollowing.first, secondFollowing.second, std::back_inserter(commonFollowing));
+    return commonFollowing;
+}
+
+std::vector<ofxInstagramGraph::Node> ofxInstagramGraph::getFansOf(Node node) const
+{
+    const Nodes following = getFollowing(node);
+    const Nodes followers = getFollowers(node);
+    std::vector<Node> fans;
+    std::set_difference(followers.first, followers.second, following.first, following.second, std::back_inserter(fans));
+    return fans;
+}
+
+void ofxInstagramGraph::buildRows(size_t nodeCount, std::vector<std::pair<Node, Node>> &edges, std::vector<uint32_t> &offsets, std::vector<Node> &targets)
+{
+    //The edges are sorted by their source, so every row is a run of them and comes out sorted
+    offsets.assign(nodeCount + 1, 0);
+    targets.resize(edges.size());
+    for (size_t edgeIndex = 0; edgeIndex < edges.size(); edgeIndex++) {
+        offsets[edges[edgeIndex].first + 1]++;
+        targets[edgeIndex] = edges[edgeIndex].second;
+    }
+
+    for (size_t node = 0; node < nodeCount; node++) {
+        offsets[node + 1] += offsets[node];
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef OFXINSTAGRAMGRAPH_H
+#define OFXINSTAGRAMGRAPH_H
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Who follows whom among a set of users, as built by ofxInstagramGraphCrawler. Users are numbered densely from 0 and both
+// directions are kept in compressed sparse rows: one array of offsets by node into one array of the nodes it follows,
+// sorted, and the same for its followers. That is 8 bytes per follow, and a query is a binary search or a merge of two
+// sorted ranges without touching the network.
+class ofxInstagramGraph
+{
+public:
+    using Node = uint32_t;
+    //A range of nodes, sorted
+    using Nodes = std::pair<const Node *, const Node *>;
+
+    static const Node NO_NODE;
+
+public:
+    ofxInstagramGraph();
+
+    // Builds the rows. userIDs and usernames are by node, every edge is (follower, followed). Repeated edges are kept once.
+    void build(std::vector<std::string> userIDs, std::vector<std::string> usernames, std::vector<std::pair<Node, Node>> edges);
+    void clear();
+
+    size_t getNodeCount() const;
+    size_t getEdgeCount() const;
+
+    // NO_NODE for users that are not in the graph
+    Node getNode(const std::string &userID) const;
+    const std::string &getUserID(Node node) const;
+    const std::string &getUsername(Node node) const;
+
+    Nodes getFollowing(Node node) const;
+    Nodes getFollowers(Node node) const;
+
+    bool isFollowing(Node follower, Node followed) const;
+    // Users who follow the node back
+    std::vector<Node> getMutualFollows(Node node) const;
+    // Users both nodes follow
+    std::vector<Node> getCommonFollowing(Node first, Node second) const;
+    // Followers of the node that it does not follow back
+    std::vector<Node> getFansOf(Node node) const;
+
+private:
+    std::vector<std::string> m_UserIDs, m_Usernames;
+    std::unordered_map<std::string, Node> m_Nodes;
+
+    std::vector<uint32_t> m_FollowingOffsets, m_FollowerOffsets;
+    std::vector<Node> m_Following, m_Followers;
+
+private:
+    static void buildRows(size_t nodeCount, std::vector<std::pair<Node, Node>> &edges, std::vector<uint32_t> &offsets, std::vector<Node> &targets);
+};
+
+#endif // OFXINSTAGRAMGRAPH_H
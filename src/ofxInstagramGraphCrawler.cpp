@@ -0,0 +1,328 @@
+#include "ofxInstagramGraphCrawler.h"
+#include <algorithm>
+#include "ofLog.h"
+#include "ofUtils.h"
+using namespace ofxInstagramTypes;
+
+namespace
+{
+const int DEFAULT_MAX_DEPTH = 2;
+const size_t DEFAULT_MAX_ACTIVE_COUNT = 4;
+//5000 requests an hour
+const double DEFAULT_MAX_REQUESTS_PER_SECOND = 5000.0 / 3600.0;
+//The future of a request that the client dropped, see ofxInstagramPromise
+const std::string BROKEN_PROMISE_ERROR = "BrokenPromise";
+}
+
+ofxInstagramGraphCrawler::ofxInstagramGraphCrawler(ofxInstagram &instagram)
+    : m_Async(instagram)
+    , m_MaxDepth(DEFAULT_MAX_DEPTH)
+    , m_MaxActiveCount(DEFAULT_MAX_ACTIVE_COUNT)
+    , m_MaxRequestsPerSecond(DEFAULT_MAX_REQUESTS_PER_SECOND)
+    , m_CrawlFollowing(true)
+    , m_CrawlFollowers(true)
+    , m_Generation(0)
+    , m_IsRunning(false)
+    , m_OnFinished(nullptr)
+    , m_ActiveCount(0)
+    , m_NextRequestTime(0)
+    , m_Lifetime(std::make_shared<Lifetime>())
+{
+
+}
+
+ofxInstagramGraphCrawler::~ofxInstagramGraphCrawler()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Lifetime->mutex);
+    m_Lifetime->isAlive = false;
+}
+
+void ofxInstagramGraphCrawler::setMaxDepth(int maxDepth)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxDepth = std::max(maxDepth, 1);
+}
+
+void ofxInstagramGraphCrawler::setMaxActiveCount(size_t maxActiveCount)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxActiveCount = std::max<size_t>(maxActiveCount, 1);
+}
+
+void ofxInstagramGraphCrawler::setMaxRequestsPerSecond(double requestsPerSecond)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxRequestsPerSecond = std::max(requestsPerSecond, 0.0);
+}
+
+void ofxInstagramGraphCrawler::setRateLimitBackoff(double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_RateLimit.setBackoff(seconds);
+}
+
+void ofxInstagramGraphCrawler::setCrawlFollowing(bool crawlFollowing)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CrawlFollowing = crawlFollowing;
+}
+
+void ofxInstagramGraphCrawler::setCrawlFollowers(bool crawlFollowers)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CrawlFollowers = crawlFollowers;
+}
+
+void ofxInstagramGraphCrawler::start(const std::string &userID, std::function<void(const ofxInstagramGraph &)> onFinished)
+{
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        generation = ++m_Generation;
+        m_IsRunning = true;
+        m_OnFinished = onFinished;
+        m_Queue.clear();
+        m_ActiveCount = 0;
+        m_NextRequestTime = 0;
+        m_RateLimit.clear();
+        m_UserIDs.clear();
+        m_Usernames.clear();
+        m_Nodes.clear();
+        m_IsExpanded.clear();
+        m_Edges.clear();
+        m_Stats = Stats();
+        expand(addUser(userID, ""), 0);
+    }
+
+    startJobs();
+    finishIfDone(generation);
+}
+
+void ofxInstagramGraphCrawler::stop()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Generation++;
+    m_IsRunning = false;
+    m_Queue.clear();
+    m_ActiveCount = 0;
+}
+
+void ofxInstagramGraphCrawler::update()
+{
+    startJobs();
+}
+
+bool ofxInstagramGraphCrawler::isRunning() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_IsRunning;
+}
+
+ofxInstagramGraphCrawler::Stats ofxInstagramGraphCrawler::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats = m_Stats;
+    stats.nodeCount = m_UserIDs.size();
+    stats.edgeCount = m_Edges.size();
+    stats.queuedCount = m_Queue.size();
+    stats.activeCount = m_ActiveCount;
+    return stats;
+}
+
+ofxInstagramGraph ofxInstagramGraphCrawler::buildGraph() const
+{
+    std::vector<std::string> userIDs, usernames;
+    std::vector<std::pair<ofxInstagramGraph::Node, ofxInstagramGraph::Node>> edges;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        userIDs = m_UserIDs;
+        usernames = m_Usernames;
+        edges = m_Edges;
+    }
+
+    ofxInstagramGraph graph;
+    graph.build(std::move(userIDs), std::move(usernames), std::move(edges));
+    return graph;
+}
+
+void ofxInstagramGraphCrawler::startJobs()
+{
+    while (true) {
+        Job job;
+        std::string userID;
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const uint64_t now = ofGetElapsedTimeMicros();
+            if (m_IsRunning == false || m_Queue.empty() || m_ActiveCount >= m_MaxActiveCount || now < m_NextRequestTime ||
+                m_RateLimit.isPaused(now)) {
+                return;
+            }
+
+            job = m_Queue.front();
+            m_Queue.pop_front();
+            userID = m_UserIDs[job.node];
+            generation = m_Generation;
+            m_ActiveCount++;
+            m_Stats.requestCount++;
+            if (m_MaxRequestsPerSecond > 0.0) {
+                m_NextRequestTime = std::max(now, m_NextRequestTime) + static_cast<uint64_t>(1000000.0 / m_MaxRequestsPerSecond);
+            }
+        }
+
+        //Outside of the lock, since a response can be delivered before the request returns
+        request(job, userID, generation);
+    }
+}
+
+void ofxInstagramGraphCrawler::request(const Job &job, const std::string &userID, uint64_t generation)
+{
+    ofxInstagramFuture<Users> users;
+    if (job.page.nextURL.length() != 0) {
+        users = m_Async.getNextUsersPage(job.page);
+    }
+    else if (job.isFollowing) {
+        users = m_Async.getWhoUserFollowsPage(userID);
+    }
+    else {
+        users = m_Async.getUserFollowersPage(userID);
+    }
+
+    const std::shared_ptr<Lifetime> lifetime = m_Lifetime;
+    users.then([this, lifetime, job, generation](const Users &receivedUsers) {
+        std::lock_guard<std::recursive_mutex> lock(lifetime->mutex);
+        if (lifetime->isAlive) {
+            receive(job, generation, receivedUsers);
+        }
+    }, [this, lifetime, job, generation](const Meta &error) {
+        std::lock_guard<std::recursive_mutex> lock(lifetime->mutex);
+        if (lifetime->isAlive) {
+            fail(job, generation, error);
+        }
+    });
+}
+
+void ofxInstagramGraphCrawler::receive(const Job &job, uint64_t generation, const Users &users)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (generation != m_Generation) {
+            return;
+        }
+
+        m_ActiveCount--;
+        m_RateLimit.reset();
+        for (const UserInfo &user : users.first) {
+            const ofxInstagramGraph::Node node = addUser(user.id, user.username);
+            m_Edges.push_back(job.isFollowing ? std::make_pair(job.node, node) : std::make_pair(node, job.node));
+            expand(node, job.depth + 1);
+        }
+
+        //The rest of a list comes before the next users, so lists are finished one at a time
+        if (users.second.nextURL.length() != 0) {
+            Job nextJob = job;
+            nextJob.page = users.second;
+            m_Queue.push_front(nextJob);
+        }
+    }
+
+    startJobs();
+    finishIfDone(generation);
+}
+
+void ofxInstagramGraphCrawler::fail(const Job &job, uint64_t generation, const Meta &error)
+{
+    bool isDropped = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (generation != m_Generation) {
+            return;
+        }
+
+        m_ActiveCount--;
+        if (error.errorType == BROKEN_PROMISE_ERROR) {
+            //The client is going away, so the crawl finishes once the requests on their way failed as well
+            m_Stats.failedCount++;
+            if (m_Queue.empty() == false) {
+                ofLogWarning("ofxInstagramGraphCrawler") << __FUNCTION__ << ": The client dropped a request, " << m_Queue.size()
+                                                         << " lists are not crawled.";
+                m_Queue.clear();
+            }
+
+            isDropped = true;
+        }
+        else if (ofxInstagramRateLimit::isRateLimited(error)) {
+            m_Stats.rateLimitedCount++;
+            m_Queue.push_front(job);
+            //Only the first response of the requests that were on their way starts the pause
+            const uint64_t now = ofGetElapsedTimeMicros();
+            if (m_RateLimit.backOff(now)) {
+                ofLogWarning("ofxInstagramGraphCrawler") << __FUNCTION__ << ": Rate limited, waiting " << (m_RateLimit.getResumeTime() - now) / 1000000.0
+                                                         << " s.";
+            }
+        }
+        else {
+            m_Stats.failedCount++;
+            ofLogWarning("ofxInstagramGraphCrawler") << __FUNCTION__ << ": Skipping a list of " << m_UserIDs[job.node] << ", " << error.errorType;
+        }
+    }
+
+    if (isDropped == false) {
+        startJobs();
+    }
+
+    finishIfDone(generation);
+}
+
+ofxInstagramGraph::Node ofxInstagramGraphCrawler::addUser(const std::string &userID, const std::string &username)
+{
+    auto nodeIt = m_Nodes.find(userID);
+    if (nodeIt != m_Nodes.end()) {
+        if (m_Usernames[nodeIt->second].length() == 0) {
+            m_Usernames[nodeIt->second] = username;
+        }
+
+        return nodeIt->second;
+    }
+
+    const ofxInstagramGraph::Node node = static_cast<ofxInstagramGraph::Node>(m_UserIDs.size());
+    m_Nodes[userID] = node;
+    m_UserIDs.push_back(userID);
+    m_Usernames.push_back(username);
+    m_IsExpanded.push_back(false);
+    return node;
+}
+
+void ofxInstagramGraphCrawler::expand(ofxInstagramGraph::Node node, int depth)
+{
+    if (depth >= m_MaxDepth || m_IsExpanded[node]) {
+        return;
+    }
+
+    m_IsExpanded[node] = true;
+    if (m_CrawlFollowing) {
+        m_Queue.push_back(Job{node, depth, true, Pagination()});
+    }
+
+    if (m_CrawlFollowers) {
+        m_Queue.push_back(Job{node, depth, false, Pagination()});
+    }
+}
+
+void ofxInstagramGraphCrawler::finishIfDone(uint64_t generation)
+{
+    std::function<void(const ofxInstagramGraph &)> onFinished;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (generation != m_Generation || m_IsRunning == false || m_Queue.empty() == false || m_ActiveCount != 0) {
+            return;
+        }
+
+        m_IsRunning = false;
+        onFinished = m_OnFinished;
+    }
+
+    if (onFinished) {
+        onFinished(buildGraph());
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef OFXINSTAGRAMGRAPHCRAWLER_H
+#define OFXINSTAGRAMGRAPHCRAWLER_H
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "ofxInstagramAsync.h"
+#include "ofxInstagramGraph.h"
+#include "ofxInstagramRateLimit.h"
+
+// Walks who users follow and who follows them breadth first from a user, following every page of the lists, and builds an
+// ofxInstagramGraph of what it found. Users up to setMaxDepth() hops away have their lists requested, the users on those
+// lists are in the graph as well. At most setMaxActiveCount() requests are on their way at once and at most
+// setMaxRequestsPerSecond() are made. A page that hits the rate limit is crawled again first, once the whole crawl has
+// waited out the back off of ofxInstagramRateLimit. Other errors, such as private accounts, skip the list. When the client drops
+// the requests, as when it is destroyed, the crawl finishes with what was found. Start from a numeric user ID rather than
+// "self", since the lists name users by ID. Responses that arrive after the crawler is destroyed are ignored.
+//
+//     crawler.start("1574083", [](const ofxInstagramGraph &graph) { ... });
+//     ...
+//     crawler.update();
+class ofxInstagramGraphCrawler
+{
+public:
+    struct Stats {
+        uint64_t nodeCount = 0,
+                 edgeCount = 0,
+                 requestCount = 0,
+                 rateLimitedCount = 0,
+                 failedCount = 0;
+
+        size_t queuedCount = 0,
+               activeCount = 0;
+    };
+
+public:
+    explicit ofxInstagramGraphCrawler(ofxInstagram &instagram);
+    ~ofxInstagramGraphCrawler();
+
+    // 1 requests the lists of the first user only. 2 by default.
+    void setMaxDepth(int maxDepth);
+    void setMaxActiveCount(size_t maxActiveCount);
+    // The API allowed 5000 requests an hour. 0 turns the limit off.
+    void setMaxRequestsPerSecond(double requestsPerSecond);
+    // Seconds to wait after the first rate limit response
+    void setRateLimitBackoff(double seconds);
+    // Both are crawled by default
+    void setCrawlFollowing(bool crawlFollowing);
+    void setCrawlFollowers(bool crawlFollowers);
+
+    // Drops the graph of an earlier crawl. onFinished is called with the graph on the thread that delivered the last response.
+    void start(const std::string &userID, std::function<void(const ofxInstagramGraph &)> onFinished = nullptr);
+    void stop();
+
+    // Makes the requests the limits allow, call it from ofApp::update()
+    void update();
+
+    bool isRunning() const;
+    Stats getStats() const;
+    // The graph of what was found so far, built when it is called
+    ofxInstagramGraph buildGraph() const;
+
+private:
+    struct Job {
+        ofxInstagramGraph::Node node;
+        int depth;
+        bool isFollowing;
+        //Empty for the first page
+        ofxInstagramTypes::Pagination page;
+    };
+
+    ofxInstagramAsync m_Async;
+    int m_MaxDepth;
+    size_t m_MaxActiveCount;
+    double m_MaxRequestsPerSecond;
+    bool m_CrawlFollowing, m_CrawlFollowers;
+
+    //Bumped by start() and stop(), so responses of an earlier crawl are ignored
+    uint64_t m_Generation;
+    bool m_IsRunning;
+    std::function<void(const ofxInstagramGraph &)> m_OnFinished;
+
+    std::deque<Job> m_Queue;
+    size_t m_ActiveCount;
+    //When the next request can be made within setMaxRequestsPerSecond()
+    uint64_t m_NextRequestTime;
+    ofxInstagramRateLimit m_RateLimit;
+
+    //Users by dense node, and the follows found so far as (follower, followed)
+    std::vector<std::string> m_UserIDs, m_Usernames;
+    std::unordered_map<std::string, ofxInstagramGraph::Node> m_Nodes;
+    std::vector<bool> m_IsExpanded;
+    std::vector<std::pair<ofxInstagramGraph::Node, ofxInstagramGraph::Node>> m_Edges;
+
+    Stats m_Stats;
+    mutable std::mutex m_Mutex;
+
+    //Shared with the callbacks of the requests, which lock it before they use the crawler. The destructor marks it dead
+    //once no callback is running. Recursive, since a transport can deliver inside a request that a callback makes.
+    struct Lifetime {
+        std::recursive_mutex mutex;
+        bool isAlive = true;
+    };
+
+    std::shared_ptr<Lifetime> m_Lifetime;
+
+private:
+    void startJobs();
+    void request(const Job &job, const std::string &userID, uint64_t generation);
+    void receive(const Job &job, uint64_t generation, const ofxInstagramTypes::Users &users);
+    void fail(const Job &job, uint64_t generation, const ofxInstagramTypes::Meta &error);
+    //These two need m_Mutex
+    ofxInstagramGraph::Node addUser(const std::string &userID, const std::string &username);
+    void expand(ofxInstagramGraph::Node node, int depth);
+    void finishIfDone(uint64_t generation);
+};
+
+#endif // OFXINSTAGRAMGRAPHCRAWLER_H
@@ -0,0 +1,296 @@
+#include "ofxInstagramHTTPTransport.h"
+#include <curl/curl.h>
+#include "ofLog.h"
+#include "ofUtils.h"
+
+namespace
+{
+const std::string API_HOST = "https://api.instagram.com";
+//Status of a request that did not get a response, like ofLoadURLAsync() does
+const int STATUS_FAILED = -1;
+
+//A request that does not connect within this many seconds, takes longer than TIMEOUT or stays under LOW_SPEED_LIMIT bytes
+//per second for LOW_SPEED_TIME seconds fails instead of keeping its worker
+const long CONNECT_TIMEOUT = 10;
+const long TIMEOUT = 60;
+const long LOW_SPEED_LIMIT = 256;
+const long LOW_SPEED_TIME = 20;
+
+std::once_flag curlInitFlag;
+
+size_t writeToString(char *data, size_t size, size_t count, void *userData)
+{
+    std::string *body = static_cast<std::string *>(userData);
+    body->append(data, size * count);
+    return size * count;
+}
+}
+
+ofxInstagramHTTPTransport::ofxInstagramHTTPTransport(ofxInstagram &instagram)
+    : m_Instagram(instagram)
+    , m_CertPath("")
+    , m_Host("")
+    , m_IsRunning(false)
+    , m_DeliverOnWorkers(false)
+    , m_ActiveCount(0)
+    , m_CompletedCount(0)
+    , m_FailedCount(0)
+    , m_ByteCount(0)
+{
+
+}
+
+ofxInstagramHTTPTransport::~ofxInstagramHTTPTransport()
+{
+    //The client may be destroyed already, so the queued requests are not answered
+    stopWorkers();
+}
+
+void ofxInstagramHTTPTransport::setup(size_t workerCount)
+{
+    stop();
+    std::call_once(curlInitFlag, []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+    });
+
+    m_IsRunning = true;
+    for (size_t workerIndex = 0; workerIndex < std::max<size_t>(workerCount, 1); workerIndex++) {
+        m_Workers.push_back(std::thread(&ofxInstagramHTTPTransport::threadedFunction, this));
+    }
+}
+
+void ofxInstagramHTTPTransport::setCertFileLocation(std::string path)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_CertPath = path;
+}
+
+void ofxInstagramHTTPTransport::setHost(const std::string &host)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_Host = host;
+}
+
+void ofxInstagramHTTPTransport::setDeliverOnWorkers(bool deliverOnWorkers)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_DeliverOnWorkers = deliverOnWorkers;
+}
+
+void ofxInstagramHTTPTransport::stop()
+{
+    //Answered so that their failure callbacks run and nothing waits for them
+    for (Request &request : stopWorkers()) {
+        Finished finished;
+        finished.response = ofHttpResponse(request.request, STATUS_FAILED, "The transport was stopped");
+        finished.queueTime = ofGetElapsedTimeMicros() - request.queuedTime;
+        finished.networkTime = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_FinishedMutex);
+            m_FailedCount++;
+        }
+
+        deliver(finished);
+    }
+}
+
+void ofxInstagramHTTPTransport::update()
+{
+    std::deque<Finished> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_FinishedMutex);
+        finished.swap(m_Finished);
+    }
+
+    for (Finished &item : finished) {
+        deliver(item);
+    }
+}
+
+ofxInstagramHTTPTransport::Stats ofxInstagramHTTPTransport::getStats() const
+{
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        stats.queuedCount = m_Queue.size();
+        stats.activeCount = m_ActiveCount;
+    }
+
+    std::lock_guard<std::mutex> lock(m_FinishedMutex);
+    stats.finishedCount = m_Finished.size();
+    stats.completedCount = m_CompletedCount;
+    stats.failedCount = m_FailedCount;
+    stats.byteCount = m_ByteCount;
+    return stats;
+}
+
+void ofxInstagramHTTPTransport::load(const ofHttpRequest &httpRequest)
+{
+    Request request;
+    request.request = httpRequest;
+    request.queuedTime = ofGetElapsedTimeMicros();
+    bool isQueued = false;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        if (m_IsRunning) {
+            m_Queue.push_back(std::move(request));
+            isQueued = true;
+        }
+    }
+
+    if (isQueued == false) {
+        //Answered at once like the ones stop() drops, so its failure callback runs
+        ofLogError("ofxInstagramHTTPTransport") << __FUNCTION__ << ": The transport is not running, " << httpRequest.name << " is dropped.";
+        Finished finished;
+        finished.response = ofHttpResponse(httpRequest, STATUS_FAILED, "The transport is not running");
+        finished.queueTime = 0;
+        finished.networkTime = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_FinishedMutex);
+            m_FailedCount++;
+        }
+
+        deliver(finished);
+        return;
+    }
+
+    m_QueueCondition.notify_one();
+}
+
+bool ofxInstagramHTTPTransport::getTiming(int requestID, uint64_t &queueTime, uint64_t &networkTime)
+{
+    std::lock_guard<std::mutex> lock(m_TimingMutex);
+    auto timingIt = m_Timings.find(requestID);
+    if (timingIt == m_Timings.end()) {
+        return false;
+    }
+
+    queueTime = timingIt->second.first;
+    networkTime = timingIt->second.second;
+    return true;
+}
+
+void ofxInstagramHTTPTransport::deliver(Finished &finished)
+{
+    const int requestID = finished.response.request.getID();
+    {
+        std::lock_guard<std::mutex> lock(m_TimingMutex);
+        m_Timings[requestID] = std::make_pair(finished.queueTime, finished.networkTime);
+    }
+
+    m_Instagram.urlResponse(finished.response);
+    std::lock_guard<std::mutex> lock(m_TimingMutex);
+    m_Timings.erase(requestID);
+}
+
+std::deque<ofxInstagramHTTPTransport::Request> ofxInstagramHTTPTransport::stopWorkers()
+{
+    std::deque<Request> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_IsRunning = false;
+        dropped.swap(m_Queue);
+    }
+
+    m_QueueCondition.notify_all();
+    for (std::thread &worker : m_Workers) {
+        worker.join();
+    }
+
+    m_Workers.clear();
+    return dropped;
+}
+
+void ofxInstagramHTTPTransport::threadedFunction()
+{
+    //One handle per worker so that connections are kept alive between requests
+    CURL *curl = curl_easy_init();
+    while (true) {
+        Request request;
+        std::string host, certPath;
+        bool deliverOnWorker = false;
+        {
+            std::unique_lock<std::mutex> lock(m_QueueMutex);
+            m_QueueCondition.wait(lock, [this]() {
+                return m_IsRunning == false || m_Queue.empty() == false;
+            });
+
+            if (m_IsRunning == false) {
+                break;
+            }
+
+            request = std::move(m_Queue.front());
+            m_Queue.pop_front();
+            host = m_Host;
+            certPath = m_CertPath;
+            deliverOnWorker = m_DeliverOnWorkers;
+            m_ActiveCount++;
+        }
+
+        Finished finished;
+        const uint64_t startTime = ofGetElapsedTimeMicros();
+        finished.queueTime = startTime - request.queuedTime;
+        finished.response = perform(curl, request.request, host, certPath);
+        finished.networkTime = ofGetElapsedTimeMicros() - startTime;
+
+        {
+            std::lock_guard<std::mutex> lock(m_FinishedMutex);
+            if (finished.response.status == STATUS_FAILED) {
+                m_FailedCount++;
+            }
+            else {
+                m_CompletedCount++;
+                m_ByteCount += finished.response.data.size();
+            }
+
+            if (deliverOnWorker == false) {
+                m_Finished.push_back(std::move(finished));
+            }
+        }
+
+        if (deliverOnWorker) {
+            deliver(finished);
+        }
+
+        //Only once the response is waiting for update() or was delivered, so a request is never counted as neither queued,
+        //active nor finished
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_ActiveCount--;
+    }
+
+    curl_easy_cleanup(curl);
+}
+
+ofHttpResponse ofxInstagramHTTPTransport::perform(void *curl, const ofHttpRequest &request, const std::string &host, const std::string &certPath) const
+{
+    std::string url = request.url;
+    if (host.length() != 0 && url.compare(0, API_HOST.length(), API_HOST) == 0) {
+        url = host + url.substr(API_HOST.length());
+    }
+
+    std::string body;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, TIMEOUT);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeToString);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    if (certPath.length() != 0) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, certPath.c_str());
+    }
+
+    const CURLcode code = curl_easy_perform(curl);
+    if (code != CURLE_OK) {
+        return ofHttpResponse(request, STATUS_FAILED, curl_easy_strerror(code));
+    }
+
+    //Error responses of the API carry a body as well, ofxInstagram reads the error from its meta
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    ofBuffer data;
+    data.set(body.data(), body.size());
+    return ofHttpResponse(request, data, static_cast<int>(status), "");
+}
@@ -0,0 +1,100 @@
+#ifndef OFXINSTAGRAMHTTPTRANSPORT_H
+#define OFXINSTAGRAMHTTPTRANSPORT_H
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ofxInstagram.h"
+#include "ofxInstagramTransport.h"
+
+// Loads ofxInstagram's requests with libcurl on a pool of worker threads, so as many requests as there are workers are on
+// the network at once. ofLoadURLAsync() loads one URL at a time. Every worker keeps its own handle and with it the
+// connection to the API. The responses are handed to ofxInstagram::urlResponse() on the thread that calls update(), or
+// on the worker that loaded them, see setDeliverOnWorkers().
+//
+//     auto transport = std::make_shared<ofxInstagramHTTPTransport>(instagram);
+//     transport->setup(8);
+//     instagram.setTransport(transport);
+class ofxInstagramHTTPTransport : public ofxInstagramTransport
+{
+public:
+    struct Stats {
+        //Requests waiting for a worker, being loaded and waiting for update() to deliver them
+        size_t queuedCount = 0,
+               activeCount = 0,
+               finishedCount = 0;
+
+        uint64_t completedCount = 0,
+                 failedCount = 0,
+                 byteCount = 0;
+    };
+
+public:
+    explicit ofxInstagramHTTPTransport(ofxInstagram &instagram);
+    ~ofxInstagramHTTPTransport();
+
+    void setup(size_t workerCount = 4);
+    void setCertFileLocation(std::string path);
+    // Requests to https://api.instagram.com are sent to this host instead, such as "http://127.0.0.1:8080" for a local
+    // server. An empty host sends them to the API.
+    void setHost(const std::string &host);
+    // Workers hand their responses to ofxInstagram::urlResponse() as soon as they arrive instead of waiting for update(),
+    // so they are parsed in parallel and without the latency of a frame. The callbacks run on the workers unless the
+    // client has an executor.
+    void setDeliverOnWorkers(bool deliverOnWorkers);
+    // Stops the workers once the requests they are loading finish. The queued ones are answered with a failed response on
+    // the calling thread, so their failure callbacks run.
+    void stop();
+
+    // Delivers the finished responses, call it from ofApp::update()
+    void update();
+
+    Stats getStats() const;
+
+    // Can be called from any thread
+    void load(const ofHttpRequest &request) override;
+    // The queue time is until a worker took the request and the network time is how long libcurl took to load it
+    bool getTiming(int requestID, uint64_t &queueTime, uint64_t &networkTime) override;
+
+private:
+    struct Request {
+        ofHttpRequest request;
+        uint64_t queuedTime;
+    };
+
+    struct Finished {
+        ofHttpResponse response;
+        uint64_t queueTime, networkTime;
+    };
+
+    ofxInstagram &m_Instagram;
+    std::vector<std::thread> m_Workers;
+    std::string m_CertPath, m_Host;
+
+    std::deque<Request> m_Queue;
+    mutable std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    bool m_IsRunning, m_DeliverOnWorkers;
+    size_t m_ActiveCount;
+
+    std::deque<Finished> m_Finished;
+    mutable std::mutex m_FinishedMutex;
+    uint64_t m_CompletedCount, m_FailedCount, m_ByteCount;
+
+    //Queue and network time of the responses that are being delivered
+    std::unordered_map<int, std::pair<uint64_t, uint64_t>> m_Timings;
+    std::mutex m_TimingMutex;
+
+private:
+    //Joins the workers and returns the requests that were still queued
+    std::deque<Request> stopWorkers();
+    void threadedFunction();
+    void deliver(Finished &finished);
+    ofHttpResponse perform(void *curl, const ofHttpRequest &request, const std::string &host, const std::string &certPath) const;
+};
+
+#endif // OFXINSTAGRAMHTTPTRANSPORT_H
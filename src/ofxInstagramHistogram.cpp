@@ -0,0 +1,152 @@
+#include "ofxInstagramHistogram.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+//16 buckets for every power of two range
+const unsigned int SUB_BUCKET_BITS = 4;
+const uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+//2^40 microseconds is about 12 days
+const unsigned int HIGHEST_BIT = 39;
+const size_t BUCKET_COUNT = (HIGHEST_BIT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+
+unsigned int getHighestBit(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    unsigned int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+
+    return bit;
+#endif
+}
+}
+
+ofxInstagramHistogram::ofxInstagramHistogram()
+    : m_Count(0)
+    , m_Min(0)
+    , m_Max(0)
+    , m_Sum(0)
+{
+
+}
+
+void ofxInstagramHistogram::record(uint64_t value)
+{
+    //Histograms of endpoints that are never used should not cost the buckets
+    if (m_Buckets.empty()) {
+        m_Buckets.resize(BUCKET_COUNT, 0);
+    }
+
+    value = std::min(value, getHighestTrackableValue());
+    m_Buckets[getBucketIndex(value)]++;
+    m_Min = m_Count == 0 ? value : std::min(m_Min, value);
+    m_Max = std::max(m_Max, value);
+    m_Sum += value;
+    m_Count++;
+}
+
+void ofxInstagramHistogram::merge(const ofxInstagramHistogram &other)
+{
+    if (other.m_Count == 0) {
+        return;
+    }
+
+    if (m_Buckets.empty()) {
+        m_Buckets.resize(BUCKET_COUNT, 0);
+    }
+
+    for (size_t bucketIndex = 0; bucketIndex < BUCKET_COUNT; bucketIndex++) {
+        m_Buckets[bucketIndex] += other.m_Buckets[bucketIndex];
+    }
+
+    m_Min = m_Count == 0 ? other.m_Min : std::min(m_Min, other.m_Min);
+    m_Max = std::max(m_Max, other.m_Max);
+    m_Sum += other.m_Sum;
+    m_Count += other.m_Count;
+}
+
+void ofxInstagramHistogram::clear()
+{
+    m_Buckets.clear();
+    m_Count = 0;
+    m_Min = 0;
+    m_Max = 0;
+    m_Sum = 0;
+}
+
+uint64_t ofxInstagramHistogram::getCount() const
+{
+    return m_Count;
+}
+
+uint64_t ofxInstagramHistogram::getMin() const
+{
+    return m_Min;
+}
+
+uint64_t ofxInstagramHistogram::getMax() const
+{
+    return m_Max;
+}
+
+uint64_t ofxInstagramHistogram::getSum() const
+{
+    return m_Sum;
+}
+
+double ofxInstagramHistogram::getMean() const
+{
+    return m_Count == 0 ? 0.0 : static_cast<double>(m_Sum) / m_Count;
+}
+
+uint64_t ofxInstagramHistogram::getPercentile(double percentile) const
+{
+    if (m_Count == 0) {
+        return 0;
+    }
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(percentile / 100.0 * m_Count + 0.5), 1);
+    uint64_t count = 0;
+    for (size_t bucketIndex = 0; bucketIndex < BUCKET_COUNT; bucketIndex++) {
+        count += m_Buckets[bucketIndex];
+        if (count >= rank) {
+            return std::min(std::max(getBucketUpperBound(bucketIndex), m_Min), m_Max);
+        }
+    }
+
+    return m_Max;
+}
+
+uint64_t ofxInstagramHistogram::getHighestTrackableValue()
+{
+    return (uint64_t(1) << (HIGHEST_BIT + 1)) - 1;
+}
+
+size_t ofxInstagramHistogram::getBucketIndex(uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+
+    //The top SUB_BUCKET_BITS bits below the highest one pick the bucket within the range
+    const unsigned int highestBit = getHighestBit(value);
+    const unsigned int shift = highestBit - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift * SUB_BUCKET_COUNT + (value >> shift));
+}
+
+uint64_t ofxInstagramHistogram::getBucketUpperBound(size_t bucketIndex)
+{
+    if (bucketIndex < 2 * SUB_BUCKET_COUNT) {
+        return bucketIndex;
+    }
+
+    const unsigned int shift = static_cast<unsigned int>(bucketIndex / SUB_BUCKET_COUNT) - 1;
+    const uint64_t subBucket = bucketIndex % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+    return ((subBucket + 1) << shift) - 1;
+}
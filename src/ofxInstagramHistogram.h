@@ -0,0 +1,39 @@
+#ifndef OFXINSTAGRAMHISTOGRAM_H
+#define OFXINSTAGRAMHISTOGRAM_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Histogram of integer values, such as durations in microseconds, with a bounded relative error in the style of
+// HdrHistogram. Values are sorted into power of two ranges that are each split into 16 linear buckets, so a percentile
+// is off by at most 1/16 of its value while recording stays a couple of shifts and an increment. Values above
+// getHighestTrackableValue() are clamped to it.
+class ofxInstagramHistogram
+{
+public:
+    ofxInstagramHistogram();
+
+    void record(uint64_t value);
+    void merge(const ofxInstagramHistogram &other);
+    void clear();
+
+    uint64_t getCount() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    uint64_t getSum() const;
+    double getMean() const;
+    // percentile is between 0 and 100, the result is the highest value of the bucket it falls in
+    uint64_t getPercentile(double percentile) const;
+
+    static uint64_t getHighestTrackableValue();
+
+private:
+    std::vector<uint64_t> m_Buckets;
+    uint64_t m_Count, m_Min, m_Max, m_Sum;
+
+private:
+    static size_t getBucketIndex(uint64_t value);
+    static uint64_t getBucketUpperBound(size_t bucketIndex);
+};
+
+#endif // OFXINSTAGRAMHISTOGRAM_H
@@ -0,0 +1,490 @@
+#include "ofxInstagramImageCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+namespace
+{
+const uint32_t INDEX_MAGIC = 0x43494749; // "IGIC"
+const uint32_t INDEX_VERSION = 2;
+const uint32_t ENTRY_MAGIC = 0x45494749; // "IGIE"
+
+//Journal records with this size remove the entry
+const uint64_t REMOVED_SIZE = UINT64_MAX;
+
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entryCount;
+    uint64_t accessCounter;
+};
+
+//Every entry file starts with this and the URL it was stored for
+struct EntryHeader {
+    uint32_t magic;
+    uint32_t nameLength;
+};
+
+struct PixelsHeader {
+    int32_t width, height, channels;
+};
+}
+
+ofxInstagramImageCache::ofxInstagramImageCache()
+    : m_Directory("")
+    , m_MaxBytes(0)
+    , m_TotalBytes(0)
+    , m_AccessCounter(0)
+    , m_TemporaryCounter(0)
+    , m_IsIndexDirty(false)
+{
+
+}
+
+ofxInstagramImageCache::~ofxInstagramImageCache()
+{
+    saveIndex();
+}
+
+bool ofxInstagramImageCache::setup(const std::string &directory, uint64_t maxBytes)
+{
+    {
+        std::lock_guard<std::mutex> journalLock(m_JournalMutex);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Directory = directory;
+        m_MaxBytes = maxBytes;
+        m_TotalBytes = 0;
+        m_Entries.clear();
+        m_EntryMap.clear();
+        m_JournalQueue.clear();
+        if (m_Journal.is_open()) {
+            m_Journal.close();
+        }
+
+        if (ofDirectory::doesDirectoryExist(m_Directory, false) == false && ofDirectory::createDirectory(m_Directory, false, true) == false) {
+            ofLogError("ofxInstagramImageCache") << __FUNCTION__ << ": Could not create the cache directory " << m_Directory;
+            return false;
+        }
+
+        std::ifstream indexFile(getIndexPath().c_str(), std::ios::binary);
+        IndexHeader header;
+        indexFile.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (indexFile.is_open() && (indexFile.good() == false || header.magic != INDEX_MAGIC || header.version != INDEX_VERSION)) {
+            ofLogWarning("ofxInstagramImageCache") << __FUNCTION__ << ": Ignoring an unknown index in " << m_Directory;
+        }
+        else if (indexFile.is_open()) {
+            //The records are written most recently used first, so they can be appended as they are
+            std::vector<Entry> entries(static_cast<size_t>(header.entryCount));
+            indexFile.read(reinterpret_cast<char *>(entries.data()), entries.size() * sizeof(Entry));
+            entries.resize(static_cast<size_t>(indexFile.gcount() / sizeof(Entry)));
+
+            m_AccessCounter = header.accessCounter;
+            for (const Entry &entry : entries) {
+                m_Entries.push_back(entry);
+                m_EntryMap[entry.key] = std::prev(m_Entries.end());
+                m_TotalBytes += entry.size;
+            }
+        }
+
+        //Stores and removals since the index was last saved, in the order they happened
+        std::ifstream journalFile(getJournalPath().c_str(), std::ios::binary);
+        Entry record;
+        while (journalFile.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+            auto it = m_EntryMap.find(record.key);
+            if (it != m_EntryMap.end()) {
+                m_TotalBytes -= it->second->size;
+                m_Entries.erase(it->second);
+                m_EntryMap.erase(it);
+            }
+
+            if (record.size != REMOVED_SIZE) {
+                m_Entries.push_front(record);
+                m_EntryMap[record.key] = m_Entries.begin();
+                m_TotalBytes += record.size;
+                m_AccessCounter = std::max(m_AccessCounter, record.lastAccess);
+            }
+
+            m_IsIndexDirty = true;
+        }
+
+        m_Journal.open(getJournalPath().c_str(), std::ios::binary | std::ios::app);
+        evict();
+    }
+
+    //Entries evicted while loading are journaled and their files deleted like any other eviction, otherwise they would
+    //stay on disk and come back on the next start. Saving the index then empties the journal that was just read.
+    writeJournal();
+    saveIndex();
+    deleteRemovedFiles();
+    return true;
+}
+
+void ofxInstagramImageCache::setMaxBytes(uint64_t maxBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_MaxBytes = maxBytes;
+        evict();
+    }
+
+    writeJournal();
+    deleteRemovedFiles();
+}
+
+bool ofxInstagramImageCache::contains(const std::string &url) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_EntryMap.find(hashURL(url)) != m_EntryMap.end();
+}
+
+bool ofxInstagramImageCache::load(const std::string &url, ofBuffer &data)
+{
+    std::string bytes;
+    if (readEntry(url, bytes) == false) {
+        return false;
+    }
+
+    data.set(bytes.data(), bytes.size());
+    return true;
+}
+
+bool ofxInstagramImageCache::store(const std::string &url, const ofBuffer &data)
+{
+    return writeEntry(url, data.getData(), data.size());
+}
+
+bool ofxInstagramImageCache::loadPixels(const std::string &url, int width, int height, ofPixels &pixels)
+{
+    std::string bytes;
+    if (readEntry(pixelsName(url, width, height), bytes) == false || bytes.size() < sizeof(PixelsHeader)) {
+        return false;
+    }
+
+    PixelsHeader header;
+    std::copy(bytes.data(), bytes.data() + sizeof(header), reinterpret_cast<char *>(&header));
+    const size_t pixelBytes = static_cast<size_t>(header.width) * header.height * header.channels;
+    if (bytes.size() - sizeof(header) < pixelBytes) {
+        return false;
+    }
+
+    pixels.setFromPixels(reinterpret_cast<const unsigned char *>(bytes.data() + sizeof(header)), header.width, header.height, header.channels);
+    return true;
+}
+
+bool ofxInstagramImageCache::storePixels(const std::string &url, int width, int height, const ofPixels &pixels)
+{
+    PixelsHeader header;
+    header.width = pixels.getWidth();
+    header.height = pixels.getHeight();
+    header.channels = pixels.getNumChannels();
+
+    const size_t pixelBytes = static_cast<size_t>(header.width) * header.height * header.channels;
+    std::string bytes(reinterpret_cast<const char *>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char *>(pixels.getData()), pixelBytes);
+    return writeEntry(pixelsName(url, width, height), bytes.data(), bytes.size());
+}
+
+bool ofxInstagramImageCache::remove(const std::string &url)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_EntryMap.find(hashURL(url));
+        if (it == m_EntryMap.end()) {
+            return false;
+        }
+
+        removeEntry(it->second);
+    }
+
+    writeJournal();
+    deleteRemovedFiles();
+    return true;
+}
+
+void ofxInstagramImageCache::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        while (m_Entries.empty() == false) {
+            removeEntry(m_Entries.begin());
+        }
+    }
+
+    writeJournal();
+    deleteRemovedFiles();
+}
+
+bool ofxInstagramImageCache::saveIndex()
+{
+    //Holding the journal lock keeps stores from appending to the journal that is about to be emptied. Their records stay
+    //queued and go into the new journal.
+    std::lock_guard<std::mutex> journalLock(m_JournalMutex);
+    IndexHeader header;
+    std::vector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_IsIndexDirty == false || m_Directory.length() == 0) {
+            return true;
+        }
+
+        header.magic = INDEX_MAGIC;
+        header.version = INDEX_VERSION;
+        header.entryCount = m_Entries.size();
+        header.accessCounter = m_AccessCounter;
+        entries.assign(m_Entries.begin(), m_Entries.end());
+        m_JournalQueue.clear();
+        m_IsIndexDirty = false;
+    }
+
+    //Written to a temporary file first so a crash can not leave a half written index behind
+    const std::string temporaryPath = getIndexPath() + ".tmp";
+    std::ofstream indexFile(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (indexFile.is_open() == false) {
+        ofLogError("ofxInstagramImageCache") << __FUNCTION__ << ": Could not write the index to " << temporaryPath;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsIndexDirty = true;
+        return false;
+    }
+
+    indexFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    indexFile.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Entry));
+    indexFile.close();
+
+    //rename() replaces the old index in one step
+    if (std::rename(temporaryPath.c_str(), getIndexPath().c_str()) != 0) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_IsIndexDirty = true;
+        return false;
+    }
+
+    m_Journal.close();
+    m_Journal.open(getJournalPath().c_str(), std::ios::binary | std::ios::trunc);
+    return true;
+}
+
+ofxInstagramImageCache::Stats ofxInstagramImageCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats = m_Stats;
+    stats.entryCount = m_Entries.size();
+    stats.totalBytes = m_TotalBytes;
+    return stats;
+}
+
+uint64_t ofxInstagramImageCache::hashURL(const std::string &url)
+{
+    //64 bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char character : url) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+std::string ofxInstagramImageCache::getIndexPath() const
+{
+    return ofFilePath::join(m_Directory, "index.bin");
+}
+
+std::string ofxInstagramImageCache::getJournalPath() const
+{
+    return ofFilePath::join(m_Directory, "journal.bin");
+}
+
+std::string ofxInstagramImageCache::getEntryPath(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return ofFilePath::join(m_Directory, name);
+}
+
+std::string ofxInstagramImageCache::pixelsName(const std::string &url, int width, int height) const
+{
+    return url + "#" + ofToString(width) + "x" + ofToString(height);
+}
+
+bool ofxInstagramImageCache::readEntry(const std::string &name, std::string &data)
+{
+    const uint64_t key = hashURL(name);
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_EntryMap.find(key) == m_EntryMap.end()) {
+            m_Stats.missCount++;
+            return false;
+        }
+
+        path = getEntryPath(key);
+    }
+
+    //Files are replaced by rename(), so this reads either the old or the new file but never half of one
+    std::ifstream file(path.c_str(), std::ios::binary);
+    EntryHeader header;
+    std::string storedName;
+    bool isFound = false;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) && header.magic == ENTRY_MAGIC) {
+        storedName.resize(header.nameLength);
+        if (file.read(&storedName[0], storedName.size())) {
+            isFound = true;
+        }
+    }
+
+    //A different URL with the same hash is a miss, its entry stays
+    const bool isSameName = isFound && storedName == name;
+    if (isSameName) {
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_EntryMap.find(key);
+        if (isFound == false) {
+            //The file was removed or damaged behind our back
+            if (it != m_EntryMap.end()) {
+                removeEntry(it->second);
+            }
+        }
+        else if (isSameName && it != m_EntryMap.end()) {
+            it->second->lastAccess = ++m_AccessCounter;
+            m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+            m_IsIndexDirty = true;
+        }
+
+        if (isSameName) {
+            m_Stats.hitCount++;
+        }
+        else {
+            m_Stats.missCount++;
+        }
+    }
+
+    if (isFound == false) {
+        writeJournal();
+        deleteRemovedFiles();
+    }
+
+    return isSameName;
+}
+
+bool ofxInstagramImageCache::writeEntry(const std::string &name, const char *data, size_t size)
+{
+    const uint64_t key = hashURL(name);
+    std::string path, temporaryPath;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Directory.length() == 0 || (m_MaxBytes != 0 && size > m_MaxBytes)) {
+            return false;
+        }
+
+        path = getEntryPath(key);
+        temporaryPath = path + "." + ofToString(++m_TemporaryCounter) + ".tmp";
+    }
+
+    EntryHeader header;
+    header.magic = ENTRY_MAGIC;
+    header.nameLength = static_cast<uint32_t>(name.length());
+
+    std::ofstream file(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (file.is_open() == false) {
+        ofLogError("ofxInstagramImageCache") << __FUNCTION__ << ": Could not write " << temporaryPath;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(name.data(), name.length());
+    file.write(data, size);
+    file.close();
+    if (file.fail() || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        ofLogError("ofxInstagramImageCache") << __FUNCTION__ << ": Could not write " << path;
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Entry entry;
+        entry.key = key;
+        entry.size = sizeof(header) + name.length() + size;
+        entry.lastAccess = ++m_AccessCounter;
+        addEntry(entry);
+        evict();
+    }
+
+    writeJournal();
+    deleteRemovedFiles();
+    return true;
+}
+
+void ofxInstagramImageCache::addEntry(const Entry &entry)
+{
+    auto it = m_EntryMap.find(entry.key);
+    if (it != m_EntryMap.end()) {
+        m_TotalBytes -= it->second->size;
+        m_Entries.erase(it->second);
+    }
+
+    m_Entries.push_front(entry);
+    m_EntryMap[entry.key] = m_Entries.begin();
+    m_TotalBytes += entry.size;
+    m_JournalQueue.push_back(entry);
+    m_IsIndexDirty = true;
+}
+
+void ofxInstagramImageCache::removeEntry(std::list<Entry>::iterator entry)
+{
+    Entry record = *entry;
+    record.size = REMOVED_SIZE;
+    m_JournalQueue.push_back(record);
+    m_RemovedFiles.push_back(std::make_pair(entry->key, getEntryPath(entry->key)));
+
+    m_TotalBytes -= entry->size;
+    m_EntryMap.erase(entry->key);
+    m_Entries.erase(entry);
+    m_IsIndexDirty = true;
+}
+
+void ofxInstagramImageCache::evict()
+{
+    while (m_MaxBytes != 0 && m_TotalBytes > m_MaxBytes && m_Entries.empty() == false) {
+        removeEntry(std::prev(m_Entries.end()));
+        m_Stats.evictionCount++;
+    }
+}
+
+void ofxInstagramImageCache::writeJournal()
+{
+    //Records are taken in the order they were queued and only one thread writes at a time, so the journal keeps that order
+    std::lock_guard<std::mutex> journalLock(m_JournalMutex);
+    std::vector<Entry> records;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        records.swap(m_JournalQueue);
+    }
+
+    if (records.empty() || m_Journal.is_open() == false) {
+        return;
+    }
+
+    m_Journal.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Entry));
+    m_Journal.flush();
+}
+
+void ofxInstagramImageCache::deleteRemovedFiles()
+{
+    std::vector<std::pair<uint64_t, std::string>> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        removed.swap(m_RemovedFiles);
+        //Keys that were stored again since then have a new file at the same path
+        removed.erase(std::remove_if(removed.begin(), removed.end(), [this](const std::pair<uint64_t, std::string> &file) {
+            return m_EntryMap.find(file.first) != m_EntryMap.end();
+        }), removed.end());
+    }
+
+    //A store of the same key that lands between the check and the removal loses its file, its next load is a miss
+    for (const auto &file : removed) {
+        std::remove(file.second.c_str());
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef OFXINSTAGRAMIMAGECACHE_H
+#define OFXINSTAGRAMIMAGECACHE_H
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ofMain.h"
+
+// Content addressed image cache on disk. Entries are keyed by a 64 bit hash of the media URL and stored as one file per
+// entry, either the original bytes or pre-decoded pixels at a given size. Every file starts with the URL it was stored
+// for, so two URLs with the same hash do not read each other's data. The entries are listed in a single index file that
+// is read in one go at startup, plus a journal that every store and removal is appended to, so entries written since the
+// last saveIndex() are not lost if the app does not shut down cleanly. The least recently used entries are evicted once
+// the cache goes over its budget. Files are read and written without holding the lock, so workers do not wait on each
+// other's disk I/O.
+class ofxInstagramImageCache
+{
+public:
+    struct Stats {
+        uint64_t hitCount = 0,
+                 missCount = 0,
+                 evictionCount = 0,
+                 entryCount = 0,
+                 totalBytes = 0;
+    };
+
+public:
+    ofxInstagramImageCache();
+    ~ofxInstagramImageCache();
+
+    // Opens or creates the cache in the directory. maxBytes is the size budget of the cached files.
+    bool setup(const std::string &directory, uint64_t maxBytes = 256 * 1024 * 1024);
+    void setMaxBytes(uint64_t maxBytes);
+
+    bool contains(const std::string &url) const;
+
+    // Original bytes
+    bool load(const std::string &url, ofBuffer &data);
+    bool store(const std::string &url, const ofBuffer &data);
+
+    // Decoded pixels for the size they were requested at, so a downscaled image does not have to be decoded and resized
+    // again. The pixels themselves can be smaller when the aspect ratio was kept.
+    bool loadPixels(const std::string &url, int width, int height, ofPixels &pixels);
+    bool storePixels(const std::string &url, int width, int height, const ofPixels &pixels);
+
+    bool remove(const std::string &url);
+    void clear();
+
+    // Writes the index to disk and empties the journal. Also called from the destructor.
+    bool saveIndex();
+
+    Stats getStats() const;
+
+    static uint64_t hashURL(const std::string &url);
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t size;
+        uint64_t lastAccess;
+    };
+
+    std::string m_Directory;
+    uint64_t m_MaxBytes;
+    uint64_t m_TotalBytes;
+    uint64_t m_AccessCounter;
+    uint64_t m_TemporaryCounter;
+    bool m_IsIndexDirty;
+
+    //Most recently used first
+    std::list<Entry> m_Entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_EntryMap;
+
+    //Stores and removals in the order they happened, waiting to be appended to the journal
+    std::vector<Entry> m_JournalQueue;
+    //Keys and files of removed entries, deleted once the lock is released
+    std::vector<std::pair<uint64_t, std::string>> m_RemovedFiles;
+
+    Stats m_Stats;
+    mutable std::mutex m_Mutex;
+
+    //Held while the journal or the index file is written, taken before m_Mutex
+    std::mutex m_JournalMutex;
+    std::ofstream m_Journal;
+
+private:
+    std::string getIndexPath() const;
+    std::string getJournalPath() const;
+    std::string getEntryPath(uint64_t key) const;
+    std::string pixelsName(const std::string &url, int width, int height) const;
+
+    bool readEntry(const std::string &name, std::string &data);
+    bool writeEntry(const std::string &name, const char *data, size_t size);
+    void addEntry(const Entry &entry);
+    void removeEntry(std::list<Entry>::iterator entry);
+    void evict();
+
+    //Both are called without holding m_Mutex
+    void writeJournal();
+    void deleteRemovedFiles();
+};
+
+#endif // OFXINSTAGRAMIMAGECACHE_H
@@ -0,0 +1,197 @@
+#include "ofxInstagramImageResizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OFXINSTAGRAM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+unsigned char toByte(float value)
+{
+    return static_cast<unsigned char>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+}
+
+ofxInstagramImageResizer::ofxInstagramImageResizer()
+    : m_IsAccelerated(isAccelerationAvailable())
+{
+
+}
+
+void ofxInstagramImageResizer::setAccelerated(bool isAccelerated)
+{
+    m_IsAccelerated = isAccelerated && isAccelerationAvailable();
+}
+
+bool ofxInstagramImageResizer::isAccelerated() const
+{
+    return m_IsAccelerated;
+}
+
+bool ofxInstagramImageResizer::isAccelerationAvailable()
+{
+#ifdef OFXINSTAGRAM_USE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ofxInstagramImageResizer::resize(const ofPixels &source, ofPixels &destination, int width, int height)
+{
+    const int channels = source.getNumChannels();
+    if (source.isAllocated() == false || width <= 0 || height <= 0 || channels < 1 || channels > 4) {
+        return false;
+    }
+
+    destination.allocate(width, height, channels);
+    resize(source.getData(), source.getWidth(), source.getHeight(), channels, destination.getData(), width, height);
+    return true;
+}
+
+void ofxInstagramImageResizer::resize(const unsigned char *source, int sourceWidth, int sourceHeight, int channels, unsigned char *destination, int width, int height)
+{
+    computeContributions(sourceWidth, width, m_ColumnContributions, m_ColumnWeights);
+    computeContributions(sourceHeight, height, m_RowContributions, m_RowWeights);
+
+    //Padded by a pixel so the column pass can always read four floats per pixel
+    const size_t rowLength = static_cast<size_t>(sourceWidth) * channels;
+    m_Row.assign(rowLength + 4, 0.0f);
+
+    //Rows first, every destination row only needs a weighted sum of a few source rows
+    const size_t sourceStride = rowLength;
+    const size_t destinationStride = static_cast<size_t>(width) * channels;
+    for (int y = 0; y < height; y++) {
+        resampleRow(source, sourceStride, m_RowContributions[y], rowLength);
+        resampleColumns(channels, destination + y * destinationStride, width);
+    }
+}
+
+void ofxInstagramImageResizer::getFitSize(int sourceWidth, int sourceHeight, int maxWidth, int maxHeight, int &width, int &height)
+{
+    const double scale = std::min(1.0, std::min(static_cast<double>(maxWidth) / sourceWidth, static_cast<double>(maxHeight) / sourceHeight));
+    width = std::max(1, static_cast<int>(std::lround(sourceWidth * scale)));
+    height = std::max(1, static_cast<int>(std::lround(sourceHeight * scale)));
+}
+
+void ofxInstagramImageResizer::computeContributions(int sourceSize, int destinationSize, std::vector<Contribution> &contributions, std::vector<float> &weights) const
+{
+    const double scale = static_cast<double>(sourceSize) / destinationSize;
+    //When downscaling the filter is stretched so it covers every source pixel
+    const double radius = std::max(scale, 1.0);
+
+    contributions.resize(destinationSize);
+    weights.clear();
+    for (int index = 0; index < destinationSize; index++) {
+        const double center = (index + 0.5) * scale;
+        const int first = std::max(0, static_cast<int>(std::floor(center - radius)));
+        const int last = std::min(sourceSize - 1, static_cast<int>(std::ceil(center + radius)));
+
+        Contribution &contribution = contributions[index];
+        contribution.first = first;
+        contribution.count = 0;
+        contribution.weightOffset = weights.size();
+
+        double total = 0.0;
+        for (int sourceIndex = first; sourceIndex <= last; sourceIndex++) {
+            const double weight = std::max(0.0, 1.0 - std::abs((sourceIndex + 0.5 - center) / radius));
+            weights.push_back(static_cast<float>(weight));
+            total += weight;
+            contribution.count++;
+        }
+
+        //Normalised so edges and odd scales do not change the brightness
+        for (int tap = 0; tap < contribution.count; tap++) {
+            weights[contribution.weightOffset + tap] /= static_cast<float>(total);
+        }
+    }
+}
+
+void ofxInstagramImageResizer::resampleRow(const unsigned char *source, size_t stride, const Contribution &contribution, size_t rowLength)
+{
+    const float *weights = &m_RowWeights[contribution.weightOffset];
+    float *row = m_Row.data();
+    size_t index = 0;
+
+#ifdef OFXINSTAGRAM_USE_SSE2
+    if (m_IsAccelerated) {
+        //16 bytes at a time, widened to four vectors of floats
+        const __m128i zero = _mm_setzero_si128();
+        for (; index + 16 <= rowLength; index += 16) {
+            __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps(), sum3 = _mm_setzero_ps();
+            for (int tap = 0; tap < contribution.count; tap++) {
+                const unsigned char *sourceRow = source + (contribution.first + tap) * stride;
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceRow + index));
+                const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                const __m128 weight = _mm_set1_ps(weights[tap]);
+
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), weight));
+                sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), weight));
+                sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), weight));
+                sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), weight));
+            }
+
+            _mm_storeu_ps(row + index, sum0);
+            _mm_storeu_ps(row + index + 4, sum1);
+            _mm_storeu_ps(row + index + 8, sum2);
+            _mm_storeu_ps(row + index + 12, sum3);
+        }
+    }
+#endif
+
+    for (; index < rowLength; index++) {
+        float sum = 0.0f;
+        for (int tap = 0; tap < contribution.count; tap++) {
+            sum += source[(contribution.first + tap) * stride + index] * weights[tap];
+        }
+
+        row[index] = sum;
+    }
+}
+
+void ofxInstagramImageResizer::resampleColumns(int channels, unsigned char *destination, int width)
+{
+    const float *row = m_Row.data();
+
+#ifdef OFXINSTAGRAM_USE_SSE2
+    if (m_IsAccelerated && channels >= 3) {
+        //A whole pixel per vector, the fourth lane is ignored for RGB
+        for (int x = 0; x < width; x++) {
+            const Contribution &contribution = m_ColumnContributions[x];
+            const float *weights = &m_ColumnWeights[contribution.weightOffset];
+            const float *pixel = row + contribution.first * channels;
+
+            __m128 sum = _mm_setzero_ps();
+            for (int tap = 0; tap < contribution.count; tap++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pixel + tap * channels), _mm_set1_ps(weights[tap])));
+            }
+
+            const __m128i integers = _mm_cvtps_epi32(sum);
+            const __m128i shorts = _mm_packs_epi32(integers, integers);
+            const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(shorts, shorts));
+            std::memcpy(destination + x * channels, &packed, channels);
+        }
+
+        return;
+    }
+#endif
+
+    for (int x = 0; x < width; x++) {
+        const Contribution &contribution = m_ColumnContributions[x];
+        const float *weights = &m_ColumnWeights[contribution.weightOffset];
+        for (int channel = 0; channel < channels; channel++) {
+            const float *value = row + contribution.first * channels + channel;
+            float sum = 0.0f;
+            for (int tap = 0; tap < contribution.count; tap++) {
+                sum += value[tap * channels] * weights[tap];
+            }
+
+            destination[x * channels + channel] = toByte(sum);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef OFXINSTAGRAMIMAGERESIZER_H
+#define OFXINSTAGRAMIMAGERESIZER_H
+#include <vector>
+#include "ofMain.h"
+
+// Separable triangle filter resampler for 8 bit images with 1 to 4 channels. Downscaling averages every source pixel
+// under the filter instead of point sampling, so thumbnails do not alias. The inner loops use SSE2 where it is available
+// and fall back to plain C++ on the other platforms (ARM). An instance keeps its scratch buffers between calls, so use
+// one per thread.
+class ofxInstagramImageResizer
+{
+public:
+    ofxInstagramImageResizer();
+
+    // Turning it off forces the plain C++ path, this is only useful for comparing the two
+    void setAccelerated(bool isAccelerated);
+    bool isAccelerated() const;
+    static bool isAccelerationAvailable();
+
+    bool resize(const ofPixels &source, ofPixels &destination, int width, int height);
+    void resize(const unsigned char *source, int sourceWidth, int sourceHeight, int channels, unsigned char *destination, int width, int height);
+
+    // Largest size that fits within maxWidth x maxHeight with the aspect ratio of the source. Images are never scaled up.
+    static void getFitSize(int sourceWidth, int sourceHeight, int maxWidth, int maxHeight, int &width, int &height);
+
+private:
+    struct Contribution {
+        int first, count;
+        size_t weightOffset;
+    };
+
+    bool m_IsAccelerated;
+
+    std::vector<Contribution> m_ColumnContributions, m_RowContributions;
+    std::vector<float> m_ColumnWeights, m_RowWeights;
+    //One source row after the vertical pass
+    std::vector<float> m_Row;
+
+private:
+    void computeContributions(int sourceSize, int destinationSize, std::vector<Contribution> &contributions, std::vector<float> &weights) const;
+
+    void resampleRow(const unsigned char *source, size_t stride, const Contribution &contribution, size_t rowLength);
+    void resampleColumns(int channels, unsigned char *destination, int width);
+};
+
+#endif // OFXINSTAGRAMIMAGERESIZER_H
@@ -0,0 +1,93 @@
+#include "ofxInstagramImporter.h"
+#include "ofLog.h"
+using namespace ofxInstagramTypes;
+
+ofxInstagramImporter::ofxInstagramImporter()
+    : m_LineNumber(0)
+    , m_ErrorCount(0)
+{
+
+}
+
+bool ofxInstagramImporter::open(const std::string &path)
+{
+    close();
+    m_File.open(path.c_str(), std::ios::binary);
+    if (m_File.is_open() == false) {
+        ofLogError("ofxInstagramImporter") << __FUNCTION__ << ": Cannot open " << path;
+        return false;
+    }
+
+    return true;
+}
+
+void ofxInstagramImporter::close()
+{
+    if (m_File.is_open()) {
+        m_File.close();
+    }
+
+    m_File.clear();
+    m_LineNumber = 0;
+    m_ErrorCount = 0;
+}
+
+bool ofxInstagramImporter::isOpen() const
+{
+    return m_File.is_open();
+}
+
+bool ofxInstagramImporter::isDone() const
+{
+    //good() and not eof(), a read error would otherwise never end readAll()
+    return m_File.is_open() == false || m_File.good() == false;
+}
+
+size_t ofxInstagramImporter::read(size_t count, const std::function<void(Posts)> &callback)
+{
+    Posts posts;
+    posts.first.reserve(count);
+    ofxJSONElement postJson;
+    while (posts.first.size() < count && std::getline(m_File, m_Line)) {
+        m_LineNumber++;
+        if (m_Line.empty() || m_Line == "\r") {
+            continue;
+        }
+
+        if (postJson.parse(m_Line) == false || postJson.isObject() == false) {
+            ofLogWarning("ofxInstagramImporter") << __FUNCTION__ << ": Skipping line " << m_LineNumber << ", it is not a post.";
+            m_ErrorCount++;
+            continue;
+        }
+
+        posts.first.push_back(m_Decoder.constructPostData(postJson));
+    }
+
+    const size_t postCount = posts.first.size();
+    if (postCount != 0 && callback) {
+        callback(std::move(posts));
+    }
+
+    return postCount;
+}
+
+uint64_t ofxInstagramImporter::readAll(const std::function<void(Posts)> &callback, size_t pageSize)
+{
+    uint64_t postCount = 0;
+    pageSize = std::max<size_t>(pageSize, 1);
+    while (isDone() == false) {
+        postCount += read(pageSize, callback);
+    }
+
+    return postCount;
+}
+
+uint64_t ofxInstagramImporter::getLineNumber() const
+{
+    return m_LineNumber;
+}
+
+uint64_t ofxInstagramImporter::getErrorCount() const
+{
+    return m_ErrorCount;
+}
@@ -0,0 +1,42 @@
+#ifndef OFXINSTAGRAMIMPORTER_H
+#define OFXINSTAGRAMIMPORTER_H
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include "ofxInstagram.h"
+
+// Reads the newline delimited JSON written by ofxInstagramExporter back one line at a time and delivers the posts in pages,
+// so an archive of any size is replayed in constant memory. The pages have the same type as the ones of the live
+// endpoints, which means the on...Received callbacks of ofxInstagram can be passed in as they are. The pagination of the
+// replayed pages is empty.
+class ofxInstagramImporter
+{
+public:
+    ofxInstagramImporter();
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+    // True once the whole file has been read, or reading it failed
+    bool isDone() const;
+
+    // Reads up to count posts and delivers them as one page, returns the number of posts read. Reading a few pages in
+    // every update() keeps the frame rate up while a large archive is replayed.
+    size_t read(size_t count, const std::function<void(ofxInstagramTypes::Posts)> &callback);
+    // Reads the rest of the file in pages of pageSize posts
+    uint64_t readAll(const std::function<void(ofxInstagramTypes::Posts)> &callback, size_t pageSize = 20);
+
+    uint64_t getLineNumber() const;
+    // Lines that could not be parsed, they are skipped
+    uint64_t getErrorCount() const;
+
+private:
+    std::ifstream m_File;
+    //Only used for its decoding
+    const ofxInstagram m_Decoder;
+    std::string m_Line;
+    uint64_t m_LineNumber, m_ErrorCount;
+};
+
+#endif // OFXINSTAGRAMIMPORTER_H
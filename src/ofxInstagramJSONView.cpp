@@ -0,0 +1,33 @@
+#include "ofxInstagramJSONView.h"
+#include "ofMain.h"
+
+ofxInstagramJSONView::ofxInstagramJSONView()
+    : m_ScrollValue(0)
+{
+
+}
+
+void ofxInstagramJSONView::draw(const ofxInstagram &instagram, int x)
+{
+    ofPushMatrix();
+    {
+        ofTranslate(x, m_ScrollValue);
+        ofDrawBitmapString(instagram.getParsedJSONString(), 0, 0);
+    }
+    ofPopMatrix();
+}
+
+void ofxInstagramJSONView::mouseScroll(int scrollY)
+{
+    m_ScrollValue += scrollY;
+}
+
+void ofxInstagramJSONView::resetScroll()
+{
+    m_ScrollValue = 0;
+}
+
+int ofxInstagramJSONView::getScrollValue() const
+{
+    return m_ScrollValue;
+}
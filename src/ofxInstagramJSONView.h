@@ -0,0 +1,26 @@
+#ifndef OFXINSTAGRAMJSONVIEW_H
+#define OFXINSTAGRAMJSONVIEW_H
+#include "ofxInstagram.h"
+
+// Draws the last response of an ofxInstagram as text and scrolls it with the mouse wheel. This is the only part of the
+// client that needs a renderer, so apps without a window leave it out.
+//
+//     jsonView.draw(instagram, 10);                 // in ofApp::draw()
+//     jsonView.mouseScroll(scrollY);                // in ofApp::mouseScrolled()
+class ofxInstagramJSONView
+{
+public:
+    ofxInstagramJSONView();
+
+    void draw(const ofxInstagram &instagram, int x);
+
+    void resetScroll();
+    void mouseScroll(int scrollY);
+    // Vertical offset draw() is translated by, negative once scrolled down
+    int getScrollValue() const;
+
+private:
+    int m_ScrollValue;
+};
+
+#endif // OFXINSTAGRAMJSONVIEW_H
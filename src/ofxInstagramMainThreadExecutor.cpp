@@ -0,0 +1,50 @@
+#include "ofxInstagramMainThreadExecutor.h"
+#include "ofUtils.h"
+
+ofxInstagramMainThreadExecutor::ofxInstagramMainThreadExecutor()
+{
+
+}
+
+void ofxInstagramMainThreadExecutor::execute(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(m_TaskMutex);
+    m_Tasks.push_back(std::move(task));
+}
+
+void ofxInstagramMainThreadExecutor::update(uint64_t budgetMicros)
+{
+    const uint64_t startTime = ofGetElapsedTimeMicros();
+    //Tasks queued while this runs wait for the next call, so a task that queues another one cannot keep it busy
+    size_t taskCount = getQueuedCount();
+    while (taskCount > 0) {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(m_TaskMutex);
+            if (m_Tasks.empty()) {
+                break;
+            }
+
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop_front();
+        }
+
+        task();
+        taskCount--;
+        if (budgetMicros != 0 && ofGetElapsedTimeMicros() - startTime >= budgetMicros) {
+            break;
+        }
+    }
+}
+
+size_t ofxInstagramMainThreadExecutor::getQueuedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_TaskMutex);
+    return m_Tasks.size();
+}
+
+void ofxInstagramMainThreadExecutor::clear()
+{
+    std::lock_guard<std::mutex> lock(m_TaskMutex);
+    m_Tasks.clear();
+}
@@ -0,0 +1,35 @@
+#ifndef OFXINSTAGRAMMAINTHREADEXECUTOR_H
+#define OFXINSTAGRAMMAINTHREADEXECUTOR_H
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include "ofxInstagramExecutor.h"
+
+// Queues the tasks and runs them from update() on the main thread, so callbacks can touch GL resources and the app's
+// state. A time budget spreads a burst of responses over several frames.
+//
+//     auto executor = std::make_shared<ofxInstagramMainThreadExecutor>();
+//     instagram.setExecutor(executor);
+//     ...
+//     executor->update(4000);
+class ofxInstagramMainThreadExecutor : public ofxInstagramExecutor
+{
+public:
+    ofxInstagramMainThreadExecutor();
+
+    void execute(std::function<void()> task) override;
+
+    // Runs the queued tasks, call it from ofApp::update(). Once budgetMicros have passed the rest waits for the next call,
+    // at least one task runs per call. 0 runs every task that was queued.
+    void update(uint64_t budgetMicros = 0);
+
+    size_t getQueuedCount() const;
+    // Drops the queued tasks without running them
+    void clear();
+
+private:
+    std::deque<std::function<void()>> m_Tasks;
+    mutable std::mutex m_TaskMutex;
+};
+
+#endif // OFXINSTAGRAMMAINTHREADEXECUTOR_H
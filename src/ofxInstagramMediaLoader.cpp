@@ -0,0 +1,560 @@
+#include "ofxInstagramMediaLoader.h"
+#include <curl/curl.h>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+//The throughput stats are averaged over this window, in microseconds
+const uint64_t STATS_WINDOW = 5000000;
+
+//A download that does not connect within this many seconds, or stays under LOW_SPEED_LIMIT bytes per second for
+//LOW_SPEED_TIME seconds, fails instead of keeping its worker
+const long CONNECT_TIMEOUT = 10;
+const long LOW_SPEED_LIMIT = 1024;
+const long LOW_SPEED_TIME = 30;
+
+std::once_flag curlInitFlag;
+
+size_t writeToString(char *data, size_t size, size_t count, void *userData)
+{
+    std::string *body = static_cast<std::string *>(userData);
+    body->append(data, size * count);
+    return size * count;
+}
+
+//Aborts the download once the loader is stopped, so stop() does not wait for it to finish
+int checkIsRunning(void *userData, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+    const std::atomic<bool> *isRunning = static_cast<const std::atomic<bool> *>(userData);
+    return *isRunning ? 0 : 1;
+}
+
+bool isImage(MediaType mediaType)
+{
+    return mediaType == MEDIA_IMAGE_THUMBNAIL || mediaType == MEDIA_IMAGE_LOW_RESOLUTION || mediaType == MEDIA_IMAGE_STANDARD_RESOLUTION;
+}
+}
+
+ofxInstagramMediaLoader::ofxInstagramMediaLoader()
+    : m_CertPath("")
+    , m_IsRunning(false)
+    , m_NextRequestID(1)
+    , m_ActiveCount(0)
+    , m_CompletedCount(0)
+    , m_FailedCount(0)
+    , m_TotalBytes(0)
+    , m_CacheHitCount(0)
+    , m_CoalescedCount(0)
+{
+
+}
+
+ofxInstagramMediaLoader::~ofxInstagramMediaLoader()
+{
+    stop();
+}
+
+void ofxInstagramMediaLoader::setup(size_t workerCount, size_t decodeWorkerCount)
+{
+    stop();
+    std::call_once(curlInitFlag, []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+    });
+
+    if (decodeWorkerCount == 0) {
+        decodeWorkerCount = std::thread::hardware_concurrency();
+    }
+
+    m_IsRunning = true;
+    for (size_t workerIndex = 0; workerIndex < std::max<size_t>(workerCount, 1); workerIndex++) {
+        m_Workers.push_back(std::thread(&ofxInstagramMediaLoader::threadedFunction, this));
+    }
+
+    for (size_t workerIndex = 0; workerIndex < std::max<size_t>(decodeWorkerCount, 1); workerIndex++) {
+        m_Workers.push_back(std::thread(&ofxInstagramMediaLoader::decodeThreadedFunction, this));
+    }
+}
+
+void ofxInstagramMediaLoader::setCertFileLocation(std::string path)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_CertPath = path;
+}
+
+void ofxInstagramMediaLoader::setCache(std::shared_ptr<ofxInstagramImageCache> cache)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_Cache = cache;
+}
+
+void ofxInstagramMediaLoader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_IsRunning = false;
+    }
+
+    m_QueueCondition.notify_all();
+    m_DecodeCondition.notify_all();
+    for (std::thread &worker : m_Workers) {
+        worker.join();
+    }
+
+    m_Workers.clear();
+}
+
+uint64_t ofxInstagramMediaLoader::load(const PostData &post, MediaType mediaType, Callback callback)
+{
+    const PostMedia &media = post.getMedia(mediaType);
+    if (media.url.length() == 0) {
+        return 0;
+    }
+
+    return loadURL(media.url, isImage(mediaType), callback, post.id, mediaType);
+}
+
+uint64_t ofxInstagramMediaLoader::load(const PostData &post, int targetWidth, int targetHeight, Callback callback)
+{
+    const double bytesPerSecond = getStats().bytesPerSecond;
+    const MediaType mediaType = m_RenditionSelector.select(post, targetWidth, targetHeight, bytesPerSecond);
+    const PostMedia &media = post.getMedia(mediaType);
+    if (media.url.length() == 0) {
+        return 0;
+    }
+
+    if (isImage(mediaType)) {
+        return loadImage(media.url, targetWidth, targetHeight, callback, post.id, mediaType);
+    }
+
+    return loadURL(media.url, false, callback, post.id, mediaType);
+}
+
+uint64_t ofxInstagramMediaLoader::loadURL(const std::string &url, bool decode, Callback callback, const std::string &mediaID, MediaType mediaType)
+{
+    Request request;
+    request.url = url;
+    request.mediaID = mediaID;
+    request.mediaType = mediaType;
+    request.decode = decode;
+    request.targetWidth = 0;
+    request.targetHeight = 0;
+    request.callback = callback;
+    return queue(request);
+}
+
+uint64_t ofxInstagramMediaLoader::loadImage(const std::string &url, int targetWidth, int targetHeight, Callback callback, const std::string &mediaID, MediaType mediaType)
+{
+    Request request;
+    request.url = url;
+    request.mediaID = mediaID;
+    request.mediaType = mediaType;
+    request.decode = true;
+    request.targetWidth = std::max(targetWidth, 0);
+    request.targetHeight = std::max(targetHeight, 0);
+    request.callback = callback;
+    return queue(request);
+}
+
+uint64_t ofxInstagramMediaLoader::queue(Request &request)
+{
+    request.id = m_NextRequestID++;
+    request.queuedTime = ofGetElapsedTimeMicros();
+
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        auto followers = m_Followers.find(requestKey(request));
+        if (followers != m_Followers.end()) {
+            followers->second.push_back(request);
+            std::lock_guard<std::mutex> statsLock(m_StatsMutex);
+            m_CoalescedCount++;
+            return request.id;
+        }
+
+        m_Followers[requestKey(request)];
+        m_Queue.push_back(request);
+    }
+
+    m_QueueCondition.notify_one();
+    return request.id;
+}
+
+bool ofxInstagramMediaLoader::cancel(uint64_t requestID)
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    auto isRequest = [requestID](const Request & request) {
+        return request.id == requestID;
+    };
+
+    auto it = std::find_if(m_Queue.begin(), m_Queue.end(), isRequest);
+    if (it != m_Queue.end()) {
+        std::vector<Request> &followers = m_Followers[requestKey(*it)];
+        if (followers.empty()) {
+            m_Followers.erase(requestKey(*it));
+            m_Queue.erase(it);
+        }
+        else {
+            //Someone else is waiting for the same URL, the first follower takes over the queued download
+            *it = followers.front();
+            followers.erase(followers.begin());
+        }
+
+        return true;
+    }
+
+    for (auto &entry : m_Followers) {
+        auto followerIt = std::find_if(entry.second.begin(), entry.second.end(), isRequest);
+        if (followerIt != entry.second.end()) {
+            entry.second.erase(followerIt);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ofxInstagramMediaLoader::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    for (const Request &request : m_Queue) {
+        m_Followers.erase(requestKey(request));
+    }
+
+    //What is left belongs to downloads that already started, only their followers can be cancelled
+    for (auto &entry : m_Followers) {
+        entry.second.clear();
+    }
+
+    m_Queue.clear();
+}
+
+void ofxInstagramMediaLoader::update()
+{
+    std::deque<Finished> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_FinishedMutex);
+        finished.swap(m_Finished);
+    }
+
+    for (Finished &item : finished) {
+        if (item.callback) {
+            item.callback(item.result);
+        }
+
+        if (onMediaLoaded) {
+            onMediaLoaded(item.result);
+        }
+    }
+}
+
+ofxInstagramMediaLoader::Stats ofxInstagramMediaLoader::getStats() const
+{
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        stats.queuedCount = m_Queue.size();
+        stats.decodeQueuedCount = m_DecodeQueue.size();
+    }
+
+    stats.activeCount = m_ActiveCount;
+
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    stats.completedCount = m_CompletedCount;
+    stats.failedCount = m_FailedCount;
+    stats.totalBytes = m_TotalBytes;
+    stats.savedBytes = m_RenditionSelector.getSavedBytes();
+    stats.savedVideoBytesPerSecond = m_RenditionSelector.getSavedVideoBytesPerSecond();
+    stats.cacheHitCount = m_CacheHitCount;
+    stats.pixelPool = m_PixelPool.getStats();
+    stats.coalescedCount = m_CoalescedCount;
+
+    const uint64_t now = ofGetElapsedTimeMicros();
+    size_t windowBytes = 0, windowImages = 0;
+    uint64_t windowTransferTime = 0;
+    for (const Sample &sample : m_Samples) {
+        if (now - sample.time <= STATS_WINDOW) {
+            windowBytes += sample.bytes;
+            windowTransferTime += sample.transferTime;
+            windowImages += sample.isImage ? 1 : 0;
+        }
+    }
+
+    //Time spent waiting in the queue or idle does not say anything about the bandwidth
+    const double windowSeconds = STATS_WINDOW / 1000000.0;
+    stats.bytesPerSecond = windowTransferTime != 0 ? windowBytes / (windowTransferTime / 1000000.0) : 0.0;
+    stats.imagesPerSecond = windowImages / windowSeconds;
+    return stats;
+}
+
+ofxInstagramRenditionSelector &ofxInstagramMediaLoader::getRenditionSelector()
+{
+    return m_RenditionSelector;
+}
+
+ofxInstagramPixelPool &ofxInstagramMediaLoader::getPixelPool()
+{
+    return m_PixelPool;
+}
+
+void ofxInstagramMediaLoader::threadedFunction()
+{
+    //One handle per worker so that connections are kept alive between downloads
+    CURL *curl = curl_easy_init();
+    ofPixels cachedPixels;
+    while (true) {
+        Request request;
+        std::string certPath;
+        std::shared_ptr<ofxInstagramImageCache> cache;
+        {
+            std::unique_lock<std::mutex> lock(m_QueueMutex);
+            m_QueueCondition.wait(lock, [this]() {
+                return m_IsRunning == false || m_Queue.empty() == false;
+            });
+
+            if (m_IsRunning == false) {
+                break;
+            }
+
+            request = m_Queue.front();
+            m_Queue.pop_front();
+            certPath = m_CertPath;
+            cache = m_Cache;
+            m_ActiveCount++;
+        }
+
+        if (certPath.length() != 0) {
+            curl_easy_setopt(curl, CURLOPT_CAINFO, certPath.c_str());
+        }
+
+        Result result;
+        result.requestID = request.id;
+        result.mediaID = request.mediaID;
+        result.url = request.url;
+        result.mediaType = request.mediaType;
+
+        const uint64_t startTime = ofGetElapsedTimeMicros();
+        result.queueTime = (startTime - request.queuedTime) / 1000000.0;
+
+        //Resized images are cached as pixels, which saves both the download and the decode
+        const bool isResized = request.decode && (request.targetWidth != 0 || request.targetHeight != 0);
+        if (isResized && cache && cache->loadPixels(request.url, request.targetWidth, request.targetHeight, cachedPixels)) {
+            result.pixels = m_PixelPool.acquire(cachedPixels);
+            result.isFromCache = true;
+            result.isSuccessful = true;
+            finish(request, result, 0, 0);
+            continue;
+        }
+
+        uint64_t transferTime = 0;
+        result.isFromCache = cache && cache->load(request.url, result.data);
+        if (result.isFromCache) {
+            result.isSuccessful = true;
+        }
+        else {
+            const uint64_t transferStartTime = ofGetElapsedTimeMicros();
+            result.isSuccessful = download(curl, request.url, result.data, result.error);
+            transferTime = ofGetElapsedTimeMicros() - transferStartTime;
+            if (result.isSuccessful && cache) {
+                cache->store(request.url, result.data);
+            }
+        }
+
+        result.downloadTime = (ofGetElapsedTimeMicros() - startTime) / 1000000.0;
+
+        //Cache hits did not use the network, so they do not count towards the throughput
+        const size_t byteCount = result.isFromCache ? 0 : result.data.size();
+        if (result.isSuccessful == false || request.decode == false) {
+            finish(request, result, byteCount, transferTime);
+            continue;
+        }
+
+        //Decoding is CPU bound, so it is handed over and this worker can start on the next download
+        DecodeJob job;
+        job.request = request;
+        job.result = std::move(result);
+        job.byteCount = byteCount;
+        job.transferTime = transferTime;
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_DecodeQueue.push_back(std::move(job));
+        }
+
+        m_DecodeCondition.notify_one();
+    }
+
+    curl_easy_cleanup(curl);
+}
+
+void ofxInstagramMediaLoader::decodeThreadedFunction()
+{
+    ofxInstagramImageResizer resizer;
+    ofPixels decoded;
+    while (true) {
+        DecodeJob job;
+        std::shared_ptr<ofxInstagramImageCache> cache;
+        {
+            std::unique_lock<std::mutex> lock(m_QueueMutex);
+            m_DecodeCondition.wait(lock, [this]() {
+                return m_IsRunning == false || m_DecodeQueue.empty() == false;
+            });
+
+            if (m_IsRunning == false) {
+                break;
+            }
+
+            job = std::move(m_DecodeQueue.front());
+            m_DecodeQueue.pop_front();
+            cache = m_Cache;
+        }
+
+        const Request &request = job.request;
+        Result &result = job.result;
+        const uint64_t startTime = ofGetElapsedTimeMicros();
+        const bool isResized = request.targetWidth != 0 || request.targetHeight != 0;
+        //The decoder reuses the buffer of this worker as long as the source images have the same size
+        result.isSuccessful = ofLoadImage(decoded, result.data);
+        if (result.isSuccessful) {
+            int width = decoded.getWidth(), height = decoded.getHeight();
+            if (isResized) {
+                const int maxWidth = request.targetWidth != 0 ? request.targetWidth : width;
+                const int maxHeight = request.targetHeight != 0 ? request.targetHeight : height;
+                ofxInstagramImageResizer::getFitSize(decoded.getWidth(), decoded.getHeight(), maxWidth, maxHeight, width, height);
+            }
+
+            if (width == decoded.getWidth() && height == decoded.getHeight()) {
+                result.pixels = m_PixelPool.acquire(decoded);
+            }
+            else {
+                result.pixels = m_PixelPool.acquire(width, height, decoded.getNumChannels());
+                result.isSuccessful = resizer.resize(decoded, *result.pixels, width, height);
+            }
+
+            if (result.isSuccessful && isResized && cache) {
+                cache->storePixels(request.url, request.targetWidth, request.targetHeight, *result.pixels);
+            }
+        }
+
+        if (result.isSuccessful) {
+            result.data.clear();
+        }
+        else {
+            result.error = "Could not decode image";
+        }
+
+        result.decodeTime = (ofGetElapsedTimeMicros() - startTime) / 1000000.0;
+        finish(request, result, job.byteCount, job.transferTime);
+    }
+}
+
+void ofxInstagramMediaLoader::finish(const Request &request, Result &result, size_t byteCount, uint64_t transferTime)
+{
+    recordSample(result, byteCount, transferTime);
+
+    std::vector<Request> followers;
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        auto followersIt = m_Followers.find(requestKey(request));
+        if (followersIt != m_Followers.end()) {
+            followers.swap(followersIt->second);
+            m_Followers.erase(followersIt);
+        }
+
+        m_ActiveCount--;
+    }
+
+    //Every follower gets its own copy of the pixels, so one consumer changing them does not affect the others
+    std::vector<ofxInstagramPixelPool::Handle> followerPixels;
+    if (result.pixels) {
+        for (size_t followerIndex = 0; followerIndex < followers.size(); followerIndex++) {
+            followerPixels.push_back(m_PixelPool.acquireCopy(*result.pixels));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_FinishedMutex);
+    for (size_t followerIndex = 0; followerIndex < followers.size(); followerIndex++) {
+        const Request &follower = followers[followerIndex];
+        Finished finished;
+        finished.result = result;
+        if (result.pixels) {
+            finished.result.pixels = followerPixels[followerIndex];
+        }
+
+        finished.result.requestID = follower.id;
+        finished.result.mediaID = follower.mediaID;
+        finished.result.mediaType = follower.mediaType;
+        finished.callback = follower.callback;
+        m_Finished.push_back(std::move(finished));
+    }
+
+    Finished finished;
+    finished.result = std::move(result);
+    finished.callback = request.callback;
+    m_Finished.push_back(std::move(finished));
+}
+
+bool ofxInstagramMediaLoader::download(void *curl, const std::string &url, ofBuffer &data, std::string &error) const
+{
+    std::string body;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeToString);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, checkIsRunning);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &m_IsRunning);
+
+    const CURLcode code = curl_easy_perform(curl);
+    if (code != CURLE_OK) {
+        error = curl_easy_strerror(code);
+        return false;
+    }
+
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    if (status >= 400) {
+        error = "HTTP " + ofToString(status);
+        return false;
+    }
+
+    data.set(body.data(), body.size());
+    return true;
+}
+
+void ofxInstagramMediaLoader::recordSample(const Result &result, size_t bytes, uint64_t transferTime)
+{
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    if (result.isSuccessful == false) {
+        m_FailedCount++;
+        return;
+    }
+
+    m_CompletedCount++;
+    m_TotalBytes += bytes;
+
+    Sample sample;
+    sample.time = ofGetElapsedTimeMicros();
+    sample.bytes = bytes;
+    sample.transferTime = transferTime;
+    sample.isImage = result.pixels != nullptr;
+    m_Samples.push_back(sample);
+    if (result.isFromCache) {
+        m_CacheHitCount++;
+    }
+
+    while (m_Samples.empty() == false && sample.time - m_Samples.front().time > STATS_WINDOW) {
+        m_Samples.pop_front();
+    }
+}
+
+std::string ofxInstagramMediaLoader::requestKey(const Request &request) const
+{
+    //The same URL can be asked for as raw bytes and decoded at different sizes
+    if (request.decode) {
+        return request.url + "#" + ofToString(request.targetWidth) + "x" + ofToString(request.targetHeight);
+    }
+
+    return request.url;
+}
@@ -0,0 +1,181 @@
+#ifndef OFXINSTAGRAMMEDIALOADER_H
+#define OFXINSTAGRAMMEDIALOADER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ofMain.h"
+#include "ofxInstagramTypes.h"
+#include "ofxInstagramRenditionSelector.h"
+#include "ofxInstagramImageCache.h"
+#include "ofxInstagramImageResizer.h"
+#include "ofxInstagramPixelPool.h"
+
+// Downloads post images and videos on a bounded pool of worker threads. Every worker keeps its own libcurl handle so
+// connections to the CDN are reused between downloads. Downloaded images go through a second pool that decodes them and
+// scales them down to the requested size, so the pixels that are handed back on the main thread from update() are ready to
+// be uploaded. Requests for a URL that is already being loaded wait for that download instead of starting another one.
+class ofxInstagramMediaLoader
+{
+public:
+    struct Result {
+        uint64_t requestID = 0;
+        std::string mediaID = "",
+                    url = "",
+                    error = "";
+
+        ofxInstagramTypes::MediaType mediaType = ofxInstagramTypes::MEDIA_IMAGE_THUMBNAIL;
+        bool isSuccessful = false,
+             isFromCache = false;
+
+        //Raw bytes as downloaded, this is what videos are delivered as
+        ofBuffer data;
+        //Decoded pixels, only set for images. The buffer goes back to the pixel pool once every copy of the handle is released,
+        //so let go of it after uploading it to a texture.
+        ofxInstagramPixelPool::Handle pixels;
+
+        //In seconds
+        double queueTime = 0.0,
+               downloadTime = 0.0,
+               decodeTime = 0.0;
+    };
+
+    using Callback = std::function<void(Result &)>;
+
+    struct Stats {
+        size_t queuedCount = 0,
+               activeCount = 0,
+               decodeQueuedCount = 0;
+
+        uint64_t completedCount = 0,
+                 failedCount = 0,
+                 totalBytes = 0,
+                 //Bytes saved by the image renditions picked by load(post, width, height), see ofxInstagramRenditionSelector
+                 savedBytes = 0,
+                 savedVideoBytesPerSecond = 0,
+                 cacheHitCount = 0,
+                 coalescedCount = 0;
+
+        //Bytes downloaded over the last few seconds divided by the time spent downloading them, so this is the
+        //throughput of one download. Cache hits are not counted.
+        double bytesPerSecond = 0.0,
+               //Averaged over the last few seconds
+               imagesPerSecond = 0.0;
+
+        ofxInstagramPixelPool::Stats pixelPool;
+    };
+
+    // Called for every finished item after its own callback
+    std::function<void(Result &)> onMediaLoaded;
+
+public:
+    ofxInstagramMediaLoader();
+    ~ofxInstagramMediaLoader();
+
+    // decodeWorkerCount defaults to the number of cores
+    void setup(size_t workerCount = 4, size_t decodeWorkerCount = 0);
+    void setCertFileLocation(std::string path);
+    // Downloads are looked up in the cache first and stored in it afterwards
+    void setCache(std::shared_ptr<ofxInstagramImageCache> cache);
+    void stop();
+
+    // Returns the request ID, or 0 if the post has no media of that type
+    uint64_t load(const ofxInstagramTypes::PostData &post, ofxInstagramTypes::MediaType mediaType, Callback callback = nullptr);
+    // Loads the smallest rendition that covers the target size, taking the current throughput into account. Images are
+    // scaled down to fit the target size.
+    uint64_t load(const ofxInstagramTypes::PostData &post, int targetWidth, int targetHeight, Callback callback = nullptr);
+    uint64_t loadURL(const std::string &url, bool decode, Callback callback = nullptr, const std::string &mediaID = "",
+                     ofxInstagramTypes::MediaType mediaType = ofxInstagramTypes::MEDIA_IMAGE_THUMBNAIL);
+    // Decodes the image and scales it down to fit within targetWidth x targetHeight, keeping the aspect ratio
+    uint64_t loadImage(const std::string &url, int targetWidth, int targetHeight, Callback callback = nullptr, const std::string &mediaID = "",
+                       ofxInstagramTypes::MediaType mediaType = ofxInstagramTypes::MEDIA_IMAGE_THUMBNAIL);
+
+    // Only requests that have not started downloading can be cancelled
+    bool cancel(uint64_t requestID);
+    void cancelAll();
+
+    // Call this from ofApp::update(). Delivers the finished items.
+    void update();
+
+    Stats getStats() const;
+    ofxInstagramRenditionSelector &getRenditionSelector();
+    ofxInstagramPixelPool &getPixelPool();
+
+private:
+    struct Request {
+        uint64_t id;
+        std::string url, mediaID;
+        ofxInstagramTypes::MediaType mediaType;
+        bool decode;
+        //0 keeps the original size
+        int targetWidth, targetHeight;
+        Callback callback;
+        uint64_t queuedTime;
+    };
+
+    struct Finished {
+        Result result;
+        Callback callback;
+    };
+
+    struct DecodeJob {
+        Request request;
+        Result result;
+        size_t byteCount;
+        uint64_t transferTime;
+    };
+
+    std::vector<std::thread> m_Workers;
+    ofxInstagramRenditionSelector m_RenditionSelector;
+    ofxInstagramPixelPool m_PixelPool;
+    std::string m_CertPath;
+
+    std::shared_ptr<ofxInstagramImageCache> m_Cache;
+
+    std::deque<Request> m_Queue;
+    //Keyed by URL. An entry exists while a request for the URL is queued or downloading and holds the requests waiting for it.
+    std::unordered_map<std::string, std::vector<Request>> m_Followers;
+    mutable std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    //Also read without the lock by the progress callback of running downloads
+    std::atomic<bool> m_IsRunning;
+
+    //Guarded by m_QueueMutex as well
+    std::deque<DecodeJob> m_DecodeQueue;
+    std::condition_variable m_DecodeCondition;
+
+    std::deque<Finished> m_Finished;
+    std::mutex m_FinishedMutex;
+
+    std::atomic<uint64_t> m_NextRequestID;
+    std::atomic<size_t> m_ActiveCount;
+
+    //Completion time and transfer time in microseconds, bytes downloaded and whether it was a decoded image
+    struct Sample {
+        uint64_t time,
+                 transferTime;
+        size_t bytes;
+        bool isImage;
+    };
+
+    mutable std::mutex m_StatsMutex;
+    std::deque<Sample> m_Samples;
+    uint64_t m_CompletedCount, m_FailedCount, m_TotalBytes, m_CacheHitCount, m_CoalescedCount;
+
+private:
+    void threadedFunction();
+    void decodeThreadedFunction();
+    void finish(const Request &request, Result &result, size_t byteCount, uint64_t transferTime);
+    bool download(void *curl, const std::string &url, ofBuffer &data, std::string &error) const;
+    void recordSample(const Result &result, size_t bytes, uint64_t transferTime);
+    std::string requestKey(const Request &request) const;
+    uint64_t queue(Request &request);
+};
+
+#endif // OFXINSTAGRAMMEDIALOADER_H
@@ -0,0 +1,210 @@
+#include "ofxInstagramMetrics.h"
+#include <sstream>
+#include "ofxJSON.h"
+
+const std::string ofxInstagramMetrics::ERROR_HTTP = "HTTPError";
+const std::string ofxInstagramMetrics::ERROR_PARSE = "ParseError";
+
+namespace
+{
+const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+struct HistogramField {
+    const char *name;
+    ofxInstagramHistogram ofxInstagramMetrics::Endpoint::*histogram;
+};
+
+const HistogramField HISTOGRAMS[] = {
+    {"queue", &ofxInstagramMetrics::Endpoint::queueTime},
+    {"network", &ofxInstagramMetrics::Endpoint::networkTime},
+    {"parse", &ofxInstagramMetrics::Endpoint::parseTime},
+    {"decode", &ofxInstagramMetrics::Endpoint::decodeTime},
+    {"callback", &ofxInstagramMetrics::Endpoint::callbackTime}
+};
+
+void merge(ofxInstagramMetrics::Endpoint &target, const ofxInstagramMetrics::Endpoint &source)
+{
+    target.requestCount += source.requestCount;
+    target.responseCount += source.responseCount;
+    target.errorCount += source.errorCount;
+    target.byteCount += source.byteCount;
+    for (const auto &errorCount : source.errorCounts) {
+        target.errorCounts[errorCount.first] += errorCount.second;
+    }
+
+    for (const HistogramField &field : HISTOGRAMS) {
+        (target.*field.histogram).merge(source.*field.histogram);
+    }
+}
+
+Json::Value toJSON(const ofxInstagramHistogram &histogram)
+{
+    Json::Value json;
+    json["count"] = static_cast<Json::UInt64>(histogram.getCount());
+    json["min"] = static_cast<Json::UInt64>(histogram.getMin());
+    json["mean"] = histogram.getMean();
+    json["p50"] = static_cast<Json::UInt64>(histogram.getPercentile(50.0));
+    json["p90"] = static_cast<Json::UInt64>(histogram.getPercentile(90.0));
+    json["p99"] = static_cast<Json::UInt64>(histogram.getPercentile(99.0));
+    json["p999"] = static_cast<Json::UInt64>(histogram.getPercentile(99.9));
+    json["max"] = static_cast<Json::UInt64>(histogram.getMax());
+    return json;
+}
+
+std::string escapeLabel(const std::string &value)
+{
+    std::string escaped;
+    for (const char character : value) {
+        if (character == '\\' || character == '"') {
+            escaped += '\\';
+            escaped += character;
+        }
+        else if (character == '\n') {
+            escaped += "\\n";
+        }
+        else {
+            escaped += character;
+        }
+    }
+
+    return escaped;
+}
+
+void writeHeader(std::ostream &output, const std::string &name, const char *type, const char *help)
+{
+    output << "# HELP " << name << " " << help << "\n";
+    output << "# TYPE " << name << " " << type << "\n";
+}
+}
+
+ofxInstagramMetrics::ofxInstagramMetrics()
+{
+
+}
+
+void ofxInstagramMetrics::recordRequest(const std::string &endpoint)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Endpoints[endpoint].requestCount++;
+}
+
+void ofxInstagramMetrics::recordResponse(const std::string &endpoint, const Sample &sample)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Endpoint &metrics = m_Endpoints[endpoint];
+    metrics.responseCount++;
+    metrics.byteCount += sample.byteCount;
+    if (sample.errorType.length() != 0) {
+        metrics.errorCount++;
+        metrics.errorCounts[sample.errorType]++;
+    }
+
+    metrics.queueTime.record(sample.queueTime);
+    metrics.networkTime.record(sample.networkTime);
+    metrics.parseTime.record(sample.parseTime);
+    metrics.decodeTime.record(sample.decodeTime);
+    metrics.callbackTime.record(sample.callbackTime);
+}
+
+void ofxInstagramMetrics::clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Endpoints.clear();
+}
+
+std::map<std::string, ofxInstagramMetrics::Endpoint> ofxInstagramMetrics::getEndpoints() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Endpoints;
+}
+
+ofxInstagramMetrics::Endpoint ofxInstagramMetrics::getEndpoint(const std::string &endpoint) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto endpointIt = m_Endpoints.find(endpoint);
+    return endpointIt != m_Endpoints.end() ? endpointIt->second : Endpoint();
+}
+
+ofxInstagramMetrics::Endpoint ofxInstagramMetrics::getTotal() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Endpoint total;
+    for (const auto &endpoint : m_Endpoints) {
+        merge(total, endpoint.second);
+    }
+
+    return total;
+}
+
+std::string ofxInstagramMetrics::toJSON() const
+{
+    const std::map<std::string, Endpoint> endpoints = getEndpoints();
+    ofxJSONElement json(Json::objectValue);
+    for (const auto &endpoint : endpoints) {
+        Json::Value &endpointJson = json[endpoint.first];
+        endpointJson["requests"] = static_cast<Json::UInt64>(endpoint.second.requestCount);
+        endpointJson["responses"] = static_cast<Json::UInt64>(endpoint.second.responseCount);
+        endpointJson["errors"] = static_cast<Json::UInt64>(endpoint.second.errorCount);
+        endpointJson["bytes"] = static_cast<Json::UInt64>(endpoint.second.byteCount);
+        endpointJson["error_types"] = Json::Value(Json::objectValue);
+        for (const auto &errorCount : endpoint.second.errorCounts) {
+            endpointJson["error_types"][errorCount.first] = static_cast<Json::UInt64>(errorCount.second);
+        }
+
+        for (const HistogramField &field : HISTOGRAMS) {
+            endpointJson[std::string(field.name) + "_time_us"] = ::toJSON(endpoint.second.*field.histogram);
+        }
+    }
+
+    return json.toStyledString();
+}
+
+std::string ofxInstagramMetrics::toPrometheus(const std::string &prefix) const
+{
+    const std::map<std::string, Endpoint> endpoints = getEndpoints();
+    std::ostringstream output;
+
+    const std::string requestsName = prefix + "_requests_total";
+    writeHeader(output, requestsName, "counter", "Requests made.");
+    for (const auto &endpoint : endpoints) {
+        output << requestsName << "{endpoint=\"" << escapeLabel(endpoint.first) << "\"} " << endpoint.second.requestCount << "\n";
+    }
+
+    const std::string responsesName = prefix + "_responses_total";
+    writeHeader(output, responsesName, "counter", "Responses received.");
+    for (const auto &endpoint : endpoints) {
+        output << responsesName << "{endpoint=\"" << escapeLabel(endpoint.first) << "\"} " << endpoint.second.responseCount << "\n";
+    }
+
+    const std::string errorsName = prefix + "_errors_total";
+    writeHeader(output, errorsName, "counter", "Responses that failed, by error type.");
+    for (const auto &endpoint : endpoints) {
+        for (const auto &errorCount : endpoint.second.errorCounts) {
+            output << errorsName << "{endpoint=\"" << escapeLabel(endpoint.first) << "\",error_type=\"" << escapeLabel(errorCount.first)
+                   << "\"} " << errorCount.second << "\n";
+        }
+    }
+
+    const std::string bytesName = prefix + "_received_bytes_total";
+    writeHeader(output, bytesName, "counter", "Bytes of the response bodies.");
+    for (const auto &endpoint : endpoints) {
+        output << bytesName << "{endpoint=\"" << escapeLabel(endpoint.first) << "\"} " << endpoint.second.byteCount << "\n";
+    }
+
+    for (const HistogramField &field : HISTOGRAMS) {
+        const std::string name = prefix + "_" + field.name + "_seconds";
+        writeHeader(output, name, "summary", (std::string("Time spent in the ") + field.name + " stage.").c_str());
+        for (const auto &endpoint : endpoints) {
+            const ofxInstagramHistogram &histogram = endpoint.second.*field.histogram;
+            const std::string label = "endpoint=\"" + escapeLabel(endpoint.first) + "\"";
+            for (const double quantile : QUANTILES) {
+                output << name << "{" << label << ",quantile=\"" << quantile << "\"} " << histogram.getPercentile(quantile * 100.0) / 1e6 << "\n";
+            }
+
+            output << name << "_sum{" << label << "} " << histogram.getSum() / 1e6 << "\n";
+            output << name << "_count{" << label << "} " << histogram.getCount() << "\n";
+        }
+    }
+
+    return output.str();
+}
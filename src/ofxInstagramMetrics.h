@@ -0,0 +1,66 @@
+#ifndef OFXINSTAGRAMMETRICS_H
+#define OFXINSTAGRAMMETRICS_H
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include "ofxInstagramHistogram.h"
+
+// Counters and latency histograms of the requests of ofxInstagram, kept per endpoint by request name. All times are in
+// microseconds:
+// - queueTime: the request waited to be sent, only known when the transport reports it
+// - networkTime: from sending the request until its response arrived
+// - parseTime: parsing the JSON of the response
+// - decodeTime: turning the JSON of posts into PostData
+// - callbackTime: the rest of the delivery, which is mostly the callbacks
+class ofxInstagramMetrics
+{
+public:
+    struct Sample {
+        uint64_t byteCount = 0,
+                 queueTime = 0,
+                 networkTime = 0,
+                 parseTime = 0,
+                 decodeTime = 0,
+                 callbackTime = 0;
+
+        //Empty when the request succeeded, otherwise Meta::errorType or one of the error types below
+        std::string errorType = "";
+    };
+
+    struct Endpoint {
+        uint64_t requestCount = 0,
+                 responseCount = 0,
+                 errorCount = 0,
+                 byteCount = 0;
+
+        std::map<std::string, uint64_t> errorCounts;
+        ofxInstagramHistogram queueTime, networkTime, parseTime, decodeTime, callbackTime;
+    };
+
+    //Errors that do not come with a Meta
+    static const std::string ERROR_HTTP, ERROR_PARSE;
+
+public:
+    ofxInstagramMetrics();
+
+    void recordRequest(const std::string &endpoint);
+    void recordResponse(const std::string &endpoint, const Sample &sample);
+    void clear();
+
+    // Copies, so they can be read while requests are recorded
+    std::map<std::string, Endpoint> getEndpoints() const;
+    Endpoint getEndpoint(const std::string &endpoint) const;
+    // All endpoints merged into one
+    Endpoint getTotal() const;
+
+    std::string toJSON() const;
+    // Prometheus text format, the histograms are exported as summaries in seconds
+    std::string toPrometheus(const std::string &prefix = "ofxinstagram") const;
+
+private:
+    mutable std::mutex m_Mutex;
+    std::map<std::string, Endpoint> m_Endpoints;
+};
+
+#endif // OFXINSTAGRAMMETRICS_H
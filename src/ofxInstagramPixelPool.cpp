@@ -0,0 +1,130 @@
+#include "ofxInstagramPixelPool.h"
+#include <algorithm>
+
+ofxInstagramPixelPool::ofxInstagramPixelPool(uint64_t maxPooledBytes)
+    : m_State(std::make_shared<State>())
+{
+    m_State->maxPooledBytes = maxPooledBytes;
+}
+
+void ofxInstagramPixelPool::setMaxPooledBytes(uint64_t maxPooledBytes)
+{
+    std::lock_guard<std::mutex> lock(m_State->mutex);
+    m_State->maxPooledBytes = maxPooledBytes;
+}
+
+ofxInstagramPixelPool::Handle ofxInstagramPixelPool::acquire(int width, int height, int channels)
+{
+    ofPixels *pixels = nullptr;
+    const uint64_t size = bufferSize(width, height, channels);
+    {
+        std::lock_guard<std::mutex> lock(m_State->mutex);
+        Stats &stats = m_State->stats;
+        stats.acquireCount++;
+
+        std::vector<ofPixels *> &buffers = m_State->freeBuffers[bufferKey(width, height, channels)];
+        if (buffers.empty() == false) {
+            pixels = buffers.back();
+            buffers.pop_back();
+            stats.hitCount++;
+            stats.pooledBytes -= size;
+        }
+
+        stats.hitRate = static_cast<double>(stats.hitCount) / stats.acquireCount;
+        stats.usedBytes += size;
+        stats.peakBytes = std::max(stats.peakBytes, stats.usedBytes + stats.pooledBytes);
+    }
+
+    if (pixels == nullptr) {
+        pixels = new ofPixels();
+        pixels->allocate(width, height, channels);
+    }
+
+    std::weak_ptr<State> state = m_State;
+    return Handle(pixels, [state, size](ofPixels * released) {
+        std::shared_ptr<State> owner = state.lock();
+        if (owner) {
+            owner->release(released, size);
+        }
+        else {
+            delete released;
+        }
+    });
+}
+
+ofxInstagramPixelPool::Handle ofxInstagramPixelPool::acquire(ofPixels &pixels)
+{
+    if (pixels.isAllocated() == false) {
+        return Handle();
+    }
+
+    Handle handle = acquire(pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels());
+    handle->swap(pixels);
+    return handle;
+}
+
+ofxInstagramPixelPool::Handle ofxInstagramPixelPool::acquireCopy(const ofPixels &pixels)
+{
+    if (pixels.isAllocated() == false) {
+        return Handle();
+    }
+
+    Handle handle = acquire(pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels());
+    const size_t size = static_cast<size_t>(bufferSize(pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels()));
+    std::copy(pixels.getData(), pixels.getData() + size, handle->getData());
+    return handle;
+}
+
+void ofxInstagramPixelPool::clear()
+{
+    std::lock_guard<std::mutex> lock(m_State->mutex);
+    for (auto &entry : m_State->freeBuffers) {
+        for (ofPixels *pixels : entry.second) {
+            delete pixels;
+        }
+    }
+
+    m_State->freeBuffers.clear();
+    m_State->stats.pooledBytes = 0;
+}
+
+ofxInstagramPixelPool::Stats ofxInstagramPixelPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_State->mutex);
+    return m_State->stats;
+}
+
+uint64_t ofxInstagramPixelPool::bufferKey(int width, int height, int channels)
+{
+    return (static_cast<uint64_t>(width) << 36) | (static_cast<uint64_t>(height) << 8) | static_cast<uint64_t>(channels);
+}
+
+uint64_t ofxInstagramPixelPool::bufferSize(int width, int height, int channels)
+{
+    return static_cast<uint64_t>(width) * height * channels;
+}
+
+ofxInstagramPixelPool::State::~State()
+{
+    for (auto &entry : freeBuffers) {
+        for (ofPixels *pixels : entry.second) {
+            delete pixels;
+        }
+    }
+}
+
+void ofxInstagramPixelPool::State::release(ofPixels *pixels, uint64_t acquiredSize)
+{
+    const uint64_t size = bufferSize(pixels->getWidth(), pixels->getHeight(), pixels->getNumChannels());
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.usedBytes -= acquiredSize;
+
+    //The consumer may have reallocated the pixels, they are pooled under their current size
+    if (pixels->isAllocated() == false || stats.pooledBytes + size > maxPooledBytes) {
+        delete pixels;
+        return;
+    }
+
+    freeBuffers[bufferKey(pixels->getWidth(), pixels->getHeight(), pixels->getNumChannels())].push_back(pixels);
+    stats.pooledBytes += size;
+}
@@ -0,0 +1,66 @@
+#ifndef OFXINSTAGRAMPIXELPOOL_H
+#define OFXINSTAGRAMPIXELPOOL_H
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "ofMain.h"
+
+// Recycles pixel buffers of the same size and format. A wall that keeps showing tiles of the same size would otherwise
+// allocate and free the same few hundred kilobytes for every image. Buffers are handed out as shared pointers and go
+// back to the pool when the last copy is released, which is safe from any thread and even after the pool is gone.
+class ofxInstagramPixelPool
+{
+public:
+    using Handle = std::shared_ptr<ofPixels>;
+
+    struct Stats {
+        uint64_t acquireCount = 0,
+                 hitCount = 0;
+        double hitRate = 0.0;
+
+        //Bytes handed out and bytes waiting in the pool
+        uint64_t usedBytes = 0,
+                 pooledBytes = 0,
+                 peakBytes = 0;
+    };
+
+public:
+    // maxPooledBytes limits the memory kept around for reuse, buffers released beyond it are freed
+    ofxInstagramPixelPool(uint64_t maxPooledBytes = 64 * 1024 * 1024);
+
+    void setMaxPooledBytes(uint64_t maxPooledBytes);
+
+    // The contents of the returned pixels are undefined
+    Handle acquire(int width, int height, int channels);
+    // Takes over the buffer of the pixels, they are left with a pooled buffer of the same size (or empty)
+    Handle acquire(ofPixels &pixels);
+    // A pooled buffer with a copy of the pixels, for handing the same image to several consumers that may modify it
+    Handle acquireCopy(const ofPixels &pixels);
+
+    // Frees everything that is waiting in the pool
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, std::vector<ofPixels *>> freeBuffers;
+        uint64_t maxPooledBytes = 0;
+        Stats stats;
+
+        ~State();
+        //acquiredSize is what was counted as used when the buffer was handed out, the consumer may have reallocated it since
+        void release(ofPixels *pixels, uint64_t acquiredSize);
+    };
+
+    std::shared_ptr<State> m_State;
+
+private:
+    static uint64_t bufferKey(int width, int height, int channels);
+    static uint64_t bufferSize(int width, int height, int channels);
+};
+
+#endif // OFXINSTAGRAMPIXELPOOL_H
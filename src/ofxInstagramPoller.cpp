@@ -0,0 +1,325 @@
+#include "ofxInstagramPoller.h"
+#include "ofLog.h"
+#include "ofMath.h"
+#include "ofUtils.h"
+using namespace ofxInstagramTypes;
+
+namespace
+{
+//Weight of the latest poll in the arrival rate average
+const float ARRIVAL_RATE_SMOOTHING = 0.3f;
+//How much the interval grows after a poll without new posts
+const float EMPTY_POLL_BACKOFF = 1.5f;
+//Pages a poll follows back to its high water mark before the posts in between are given up
+const int MAX_GAP_PAGE_COUNT = 10;
+//A request without a response for this long is considered lost
+const float REQUEST_TIMEOUT = 60.f;
+//Error type and status of a response that went over the rate limit
+const std::string RATE_LIMIT_ERROR = "OAuthRateLimitException";
+const std::string RATE_LIMIT_CODE = "429";
+}
+
+ofxInstagramPoller::ofxInstagramPoller(ofxInstagram &instagram)
+    : m_Instagram(instagram)
+    , m_MinInterval(5.f)
+    , m_MaxInterval(300.f)
+    , m_Count(20)
+    , m_RequestCount(0)
+    , m_IsAlive(std::make_shared<bool>(true))
+{
+
+}
+
+void ofxInstagramPoller::addTag(const std::string &tagname, const std::string &highWaterMark)
+{
+    addSource(SOURCE_TAG, tagname, highWaterMark);
+}
+
+void ofxInstagramPoller::addUser(const std::string &userID, const std::string &highWaterMark)
+{
+    addSource(SOURCE_USER, userID, highWaterMark);
+}
+
+void ofxInstagramPoller::addLocation(const std::string &locationID, const std::string &highWaterMark)
+{
+    addSource(SOURCE_LOCATION, locationID, highWaterMark);
+}
+
+void ofxInstagramPoller::addSource(SourceType type, const std::string &sourceID, const std::string &highWaterMark)
+{
+    const std::string key = sourceKey(type, sourceID);
+    if (m_Sources.find(key) != m_Sources.end()) {
+        return;
+    }
+
+    Source source;
+    source.type = type;
+    source.id = sourceID;
+    source.highWaterMark = highWaterMark;
+    source.interval = m_MinInterval;
+    m_Sources.insert(std::make_pair(key, source));
+}
+
+void ofxInstagramPoller::removeSource(SourceType type, const std::string &sourceID)
+{
+    m_Sources.erase(sourceKey(type, sourceID));
+}
+
+void ofxInstagramPoller::clear()
+{
+    m_Sources.clear();
+}
+
+void ofxInstagramPoller::setIntervalRange(float minInterval, float maxInterval)
+{
+    m_MinInterval = minInterval;
+    m_MaxInterval = std::max(minInterval, maxInterval);
+    for (auto &entry : m_Sources) {
+        entry.second.interval = ofClamp(entry.second.interval, m_MinInterval, m_MaxInterval);
+    }
+}
+
+void ofxInstagramPoller::setCount(int count)
+{
+    m_Count = count;
+}
+
+void ofxInstagramPoller::update()
+{
+    const float now = ofGetElapsedTimef();
+    for (auto &entry : m_Sources) {
+        Source &source = entry.second;
+        if (source.isPending && now - source.lastPollTime > std::max(REQUEST_TIMEOUT, m_MaxInterval)) {
+            ofLogWarning("ofxInstagramPoller") << __FUNCTION__ << ": No response for " << entry.first << ", polling again.";
+            source.isPending = false;
+        }
+
+        if (source.isPending == false && now >= source.nextPollTime) {
+            poll(entry.first, source, now);
+        }
+    }
+}
+
+std::string ofxInstagramPoller::getHighWaterMark(SourceType type, const std::string &sourceID) const
+{
+    auto it = m_Sources.find(sourceKey(type, sourceID));
+    return it == m_Sources.end() ? "" : it->second.highWaterMark;
+}
+
+float ofxInstagramPoller::getInterval(SourceType type, const std::string &sourceID) const
+{
+    auto it = m_Sources.find(sourceKey(type, sourceID));
+    return it == m_Sources.end() ? 0.f : it->second.interval;
+}
+
+float ofxInstagramPoller::getArrivalRate(SourceType type, const std::string &sourceID) const
+{
+    auto it = m_Sources.find(sourceKey(type, sourceID));
+    return it == m_Sources.end() ? 0.f : it->second.arrivalRate;
+}
+
+unsigned int ofxInstagramPoller::getRequestCount() const
+{
+    return m_RequestCount;
+}
+
+std::string ofxInstagramPoller::sourceKey(SourceType type, const std::string &sourceID) const
+{
+    return ofToString(static_cast<int>(type)) + ":" + sourceID;
+}
+
+void ofxInstagramPoller::poll(const std::string &key, Source &source, float now)
+{
+    source.isPending = true;
+    source.lastPollTime = now;
+    m_RequestCount++;
+
+    switch (source.type) {
+    case SOURCE_TAG:
+        m_Instagram.getListOfTaggedObjectsNormal(source.id, m_Count, getPostsHandler(key), source.highWaterMark, "", getFailureHandler(key));
+        break;
+    case SOURCE_USER:
+        m_Instagram.getUserRecentMedia(source.id, m_Count, getPostsHandler(key), "", "", source.highWaterMark, "", getFailureHandler(key));
+        break;
+    case SOURCE_LOCATION:
+        m_Instagram.getRecentMediaFromLocation(source.id, getPostsHandler(key), "", "", source.highWaterMark, "", getFailureHandler(key));
+        break;
+    }
+}
+
+void ofxInstagramPoller::pollPageBefore(const std::string &key, Source &source, const Pagination &pagination, float now)
+{
+    source.lastPollTime = now;
+    m_RequestCount++;
+    m_Instagram.getNextPage(pagination, getPostsHandler(key), getFailureHandler(key));
+}
+
+std::function<void(Posts)> ofxInstagramPoller::getPostsHandler(const std::string &key)
+{
+    std::weak_ptr<bool> isAlive = m_IsAlive;
+    return [this, isAlive, key](Posts posts) {
+        if (isAlive.expired()) {
+            return;
+        }
+
+        handlePosts(key, std::move(posts), ofGetElapsedTimef());
+    };
+}
+
+ofxInstagram::FailureHandler ofxInstagramPoller::getFailureHandler(const std::string &key)
+{
+    std::weak_ptr<bool> isAlive = m_IsAlive;
+    return [this, isAlive, key](const Meta & error) {
+        if (isAlive.expired()) {
+            return;
+        }
+
+        handleFailure(key, error, ofGetElapsedTimef());
+    };
+}
+
+void ofxInstagramPoller::handlePosts(const std::string &key, Posts posts, float now)
+{
+    auto it = m_Sources.find(key);
+    if (it == m_Sources.end()) {
+        return;
+    }
+
+    Source &source = it->second;
+    const size_t receivedCount = posts.first.size();
+
+    //The first poll has no mark, it starts from the newest posts
+    bool isMarkReached = source.highWaterMark.length() == 0;
+    std::vector<PostData> newPosts;
+    newPosts.reserve(receivedCount);
+    for (PostData &post : posts.first) {
+        //Newest first, so the posts after one that was seen before are older still
+        if (post.id == source.highWaterMark || source.recentIDSet.find(post.id) != source.recentIDSet.end()) {
+            isMarkReached = true;
+            break;
+        }
+
+        newPosts.push_back(std::move(post));
+    }
+
+    //Oldest first so the newest IDs are the last ones to be evicted from the recent IDs
+    for (auto postIt = newPosts.rbegin(); postIt != newPosts.rend(); ++postIt) {
+        rememberID(source, postIt->id);
+    }
+
+    //The mark moves to the newest post of the first page, but only once the pages before it are in
+    if (source.isFillingGap == false) {
+        source.nextHighWaterMark = source.highWaterMark;
+        if (source.type == SOURCE_TAG) {
+            if (posts.second.minTagID.length() != 0) {
+                source.nextHighWaterMark = posts.second.minTagID;
+            }
+        }
+        else if (newPosts.empty() == false) {
+            //Media is returned newest first
+            source.nextHighWaterMark = newPosts.front().id;
+        }
+
+        source.gapPostCount = 0;
+        source.gapPageCount = 0;
+    }
+
+    source.gapPostCount += newPosts.size();
+
+    //A full page can stop short of the mark, the posts in between would be skipped by the next poll
+    const bool isPageFull = receivedCount >= static_cast<size_t>(m_Count);
+    if (isMarkReached == false && isPageFull && posts.second.nextURL.length() != 0) {
+        if (source.gapPageCount < MAX_GAP_PAGE_COUNT) {
+            source.isFillingGap = true;
+            source.gapPageCount++;
+            //Delivered first, so the pages arrive newest first even when the next one is answered at once
+            if (newPosts.empty() == false && onNewPostsReceived) {
+                const SourceType type = source.type;
+                const std::string sourceID = source.id;
+                onNewPostsReceived(type, sourceID, std::make_pair(std::move(newPosts), posts.second));
+                //The callback may have removed the source
+                it = m_Sources.find(key);
+                if (it == m_Sources.end()) {
+                    return;
+                }
+            }
+
+            pollPageBefore(key, it->second, posts.second, now);
+            return;
+        }
+
+        ofLogWarning("ofxInstagramPoller") << __FUNCTION__ << ": " << key << " is more than " << MAX_GAP_PAGE_COUNT
+                                           << " pages ahead, skipping the posts before them.";
+    }
+
+    source.isPending = false;
+    source.isFillingGap = false;
+    source.highWaterMark = source.nextHighWaterMark;
+
+    //Adapt the interval so that a poll returns about half a page
+    const float elapsed = source.lastResponseTime < 0.f ? source.interval : std::max(now - source.lastResponseTime, 0.001f);
+    const float rate = source.gapPostCount / elapsed;
+    source.arrivalRate = source.lastResponseTime < 0.f ? rate : source.arrivalRate + ARRIVAL_RATE_SMOOTHING * (rate - source.arrivalRate);
+    source.lastResponseTime = now;
+
+    if (source.gapPageCount != 0) {
+        //The poll took more than a page, there are probably more posts waiting
+        source.interval = m_MinInterval;
+    }
+    else if (source.arrivalRate > 0.f) {
+        source.interval = ofClamp((m_Count / 2.f) / source.arrivalRate, m_MinInterval, m_MaxInterval);
+        if (newPosts.empty()) {
+            source.interval = std::min(source.interval * EMPTY_POLL_BACKOFF, m_MaxInterval);
+        }
+    }
+    else {
+        source.interval = std::min(source.interval * EMPTY_POLL_BACKOFF, m_MaxInterval);
+    }
+
+    source.nextPollTime = now + source.interval;
+
+    if (newPosts.empty() == false && onNewPostsReceived) {
+        onNewPostsReceived(source.type, source.id, std::make_pair(std::move(newPosts), posts.second));
+    }
+}
+
+void ofxInstagramPoller::handleFailure(const std::string &key, const Meta &error, float now)
+{
+    auto it = m_Sources.find(key);
+    if (it == m_Sources.end()) {
+        return;
+    }
+
+    Source &source = it->second;
+    source.isPending = false;
+    //The mark was not moved yet, the next poll fills the gap again
+    source.isFillingGap = false;
+    ofLogWarning("ofxInstagramPoller") << __FUNCTION__ << ": Polling " << key << " failed with " << error.errorType << " " << error.code
+                                       << ", " << error.errorMessage;
+
+    //The high water mark is kept, so the next poll picks up what this one missed
+    if (error.errorType == RATE_LIMIT_ERROR || error.code == RATE_LIMIT_CODE) {
+        source.interval = m_MaxInterval;
+    }
+    else {
+        source.interval = std::min(source.interval * EMPTY_POLL_BACKOFF, m_MaxInterval);
+    }
+
+    source.nextPollTime = now + source.interval;
+
+    if (onPollFailed) {
+        onPollFailed(source.type, source.id, error);
+    }
+}
+
+void ofxInstagramPoller::rememberID(Source &source, const std::string &mediaID)
+{
+    source.recentIDs.push_back(mediaID);
+    source.recentIDSet.insert(mediaID);
+
+    const size_t maxRecentIDs = static_cast<size_t>(std::max(m_Count, 1)) * 2;
+    while (source.recentIDs.size() > maxRecentIDs) {
+        source.recentIDSet.erase(source.recentIDs.front());
+        source.recentIDs.pop_front();
+    }
+}
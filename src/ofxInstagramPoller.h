@@ -0,0 +1,106 @@
+#ifndef OFXINSTAGRAMPOLLER_H
+#define OFXINSTAGRAMPOLLER_H
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include "ofxInstagram.h"
+
+// Polls tags, users and locations for new media. The newest ID seen for every source is remembered and passed as
+// min_tag_id/min_id on the next poll, so each tick only asks for media newer than the previous one. The poll interval of
+// every source follows its observed arrival rate within the configured range. When a poll returns a full page the pages
+// before it are requested as well until the posts seen before are reached, and the newest ID only becomes the mark then,
+// so no post in between is skipped. A poll that fails is retried after a longer interval, and after the maximum one when
+// it went over the rate limit.
+//
+// The callbacks of the polls change the sources, so responses must be delivered on the thread that calls update(), as
+// with ofLoadURLAsync(), ofxInstagramHTTPTransport without setDeliverOnWorkers() or ofxInstagramMainThreadExecutor.
+class ofxInstagramPoller
+{
+public:
+    enum SourceType {
+        SOURCE_TAG,
+        SOURCE_USER,
+        SOURCE_LOCATION
+    };
+
+    // Called with the posts that were not delivered before, newest first
+    std::function<void(SourceType, std::string, ofxInstagramTypes::Posts)> onNewPostsReceived;
+    // Called with the meta of a poll that failed. The source is polled again later.
+    std::function<void(SourceType, std::string, ofxInstagramTypes::Meta)> onPollFailed;
+
+public:
+    ofxInstagramPoller(ofxInstagram &instagram);
+
+    void addTag(const std::string &tagname, const std::string &highWaterMark = "");
+    void addUser(const std::string &userID, const std::string &highWaterMark = "");
+    void addLocation(const std::string &locationID, const std::string &highWaterMark = "");
+    void addSource(SourceType type, const std::string &sourceID, const std::string &highWaterMark = "");
+    void removeSource(SourceType type, const std::string &sourceID);
+    void clear();
+
+    // Intervals are in seconds
+    void setIntervalRange(float minInterval, float maxInterval);
+    // Number of posts asked for on every poll
+    void setCount(int count);
+
+    // Call this from ofApp::update(). Polls the sources that are due.
+    void update();
+
+    // The min ID that will be used for the next poll of the source. Save it to resume polling after a restart.
+    std::string getHighWaterMark(SourceType type, const std::string &sourceID) const;
+    float getInterval(SourceType type, const std::string &sourceID) const;
+    // Posts per second, averaged over the recent polls
+    float getArrivalRate(SourceType type, const std::string &sourceID) const;
+    unsigned int getRequestCount() const;
+
+private:
+    struct Source {
+        SourceType type;
+        std::string id,
+            highWaterMark;
+
+        float interval = 0.f,
+              arrivalRate = 0.f,
+              nextPollTime = 0.f,
+              lastPollTime = 0.f,
+              lastResponseTime = -1.f;
+
+        bool isPending = false;
+
+        //While the pages of a poll are followed back to the mark: the mark to move to once it is reached, the new posts
+        //and the pages before the first one so far
+        bool isFillingGap = false;
+        std::string nextHighWaterMark;
+        size_t gapPostCount = 0;
+        int gapPageCount = 0;
+
+        //The min IDs are inclusive for some endpoints, so the last delivered IDs are kept to filter repeats
+        std::deque<std::string> recentIDs;
+        std::unordered_set<std::string> recentIDSet;
+    };
+
+    ofxInstagram &m_Instagram;
+    std::map<std::string, Source> m_Sources;
+
+    float m_MinInterval, m_MaxInterval;
+    int m_Count;
+    unsigned int m_RequestCount;
+
+    //Responses can arrive after the poller is gone, the callbacks check this first
+    std::shared_ptr<bool> m_IsAlive;
+
+private:
+    std::string sourceKey(SourceType type, const std::string &sourceID) const;
+    void poll(const std::string &key, Source &source, float now);
+    void pollPageBefore(const std::string &key, Source &source, const ofxInstagramTypes::Pagination &pagination, float now);
+    std::function<void(ofxInstagramTypes::Posts)> getPostsHandler(const std::string &key);
+    ofxInstagram::FailureHandler getFailureHandler(const std::string &key);
+    void handlePosts(const std::string &key, ofxInstagramTypes::Posts posts, float now);
+    void handleFailure(const std::string &key, const ofxInstagramTypes::Meta &error, float now);
+    void rememberID(Source &source, const std::string &mediaID);
+};
+
+#endif // OFXINSTAGRAMPOLLER_H
@@ -0,0 +1,329 @@
+#include "ofxInstagramPostStore.h"
+#include <algorithm>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+bool isSameComments(const std::vector<Comment> &a, const std::vector<Comment> &b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Comment & left, const Comment & right) {
+        return left.id == right.id && left.text == right.text;
+    });
+}
+
+bool isSameUsers(const std::vector<UserInfo> &a, const std::vector<UserInfo> &b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const UserInfo & left, const UserInfo & right) {
+        return left.id == right.id;
+    });
+}
+}
+
+ofxInstagramPostStore::ofxInstagramPostStore()
+    : m_Shared(std::make_shared<Shared>())
+    , m_NextSubscriberID(1)
+{
+
+}
+
+PostHandle ofxInstagramPostStore::merge(const PostData &post)
+{
+    return mergePost(post);
+}
+
+PostHandle ofxInstagramPostStore::merge(PostData &&post)
+{
+    return mergePost(std::move(post));
+}
+
+std::vector<PostHandle> ofxInstagramPostStore::merge(const std::vector<PostData> &posts)
+{
+    //One lock for the page, the subscribers see it in one piece
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    std::vector<PostHandle> handles;
+    handles.reserve(posts.size());
+    for (const PostData &post : posts) {
+        handles.push_back(mergePost(post));
+    }
+
+    return handles;
+}
+
+std::vector<PostHandle> ofxInstagramPostStore::merge(std::vector<PostData> &&posts)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    std::vector<PostHandle> handles;
+    handles.reserve(posts.size());
+    for (PostData &post : posts) {
+        handles.push_back(mergePost(std::move(post)));
+    }
+
+    posts.clear();
+    return handles;
+}
+
+PostHandle ofxInstagramPostStore::find(const std::string &mediaID) const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    auto it = m_Posts.find(mediaID);
+    if (it == m_Posts.end()) {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+bool ofxInstagramPostStore::contains(const std::string &mediaID) const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    return m_Posts.find(mediaID) != m_Posts.end();
+}
+
+std::vector<PostHandle> ofxInstagramPostStore::getPosts() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    std::vector<PostHandle> posts;
+    posts.reserve(m_Posts.size());
+    for (const auto &entry : m_Posts) {
+        posts.push_back(entry.second);
+    }
+
+    return posts;
+}
+
+size_t ofxInstagramPostStore::size() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    return m_Posts.size();
+}
+
+bool ofxInstagramPostStore::erase(const std::string &mediaID)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    auto it = m_Posts.find(mediaID);
+    if (it == m_Posts.end()) {
+        return false;
+    }
+
+    Delta delta;
+    delta.post = it->second;
+    delta.isRemoved = true;
+    m_Posts.erase(it);
+    notify(delta);
+    return true;
+}
+
+void ofxInstagramPostStore::clear()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    //Subscribers see the store already empty
+    std::unordered_map<std::string, std::shared_ptr<PostData>> removed;
+    removed.swap(m_Posts);
+    for (const auto &entry : removed) {
+        Delta delta;
+        delta.post = entry.second;
+        delta.isRemoved = true;
+        notify(delta);
+    }
+}
+
+unsigned int ofxInstagramPostStore::subscribe(Subscriber subscriber)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    const unsigned int subscriberID = m_NextSubscriberID++;
+    m_Shared->subscribers.push_back(std::make_pair(subscriberID, subscriber));
+    return subscriberID;
+}
+
+void ofxInstagramPostStore::unsubscribe(unsigned int subscriberID)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    removeSubscriber(m_Shared->subscribers, subscriberID);
+}
+
+ofxInstagramPostStore::Subscription ofxInstagramPostStore::subscribeScoped(Subscriber subscriber, bool isReplayed)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    if (isReplayed && subscriber) {
+        for (const auto &entry : m_Posts) {
+            Delta delta;
+            delta.post = entry.second;
+            delta.isNew = true;
+            subscriber(delta);
+        }
+    }
+
+    Subscription subscription;
+    subscription.m_Shared = m_Shared;
+    subscription.m_SubscriberID = subscribe(subscriber);
+    return subscription;
+}
+
+void ofxInstagramPostStore::removeSubscriber(SubscriberList &subscribers, unsigned int subscriberID)
+{
+    subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [subscriberID](const std::pair<unsigned int, Subscriber> &entry) {
+        return entry.first == subscriberID;
+    }), subscribers.end());
+}
+
+template<typename PostType>
+PostHandle ofxInstagramPostStore::mergePost(PostType &&post)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_Shared->mutex);
+    auto it = m_Posts.find(post.id);
+    if (it == m_Posts.end()) {
+        std::shared_ptr<PostData> stored = std::make_shared<PostData>(std::forward<PostType>(post));
+        m_Posts.insert(std::make_pair(stored->id, stored));
+
+        Delta delta;
+        delta.post = stored;
+        delta.isNew = true;
+        notify(delta);
+        return stored;
+    }
+
+    Delta delta;
+    if (diff(*it->second, post, delta) == false) {
+        return it->second;
+    }
+
+    //The old record may still be read through handles that were handed out, the changes go into a copy that replaces it
+    std::shared_ptr<PostData> merged = std::make_shared<PostData>(*it->second);
+    apply(*merged, post, delta);
+    it->second = merged;
+    delta.post = merged;
+    notify(delta);
+    return merged;
+}
+
+bool ofxInstagramPostStore::diff(const PostData &existing, const PostData &incoming, Delta &delta) const
+{
+    bool hasChanged = false;
+
+    if (existing.likeCount != incoming.likeCount) {
+        delta.likeCountChange = static_cast<int>(incoming.likeCount) - static_cast<int>(existing.likeCount);
+        hasChanged = true;
+    }
+
+    if (existing.commentCount != incoming.commentCount) {
+        delta.commentCountChange = static_cast<int>(incoming.commentCount) - static_cast<int>(existing.commentCount);
+        hasChanged = true;
+    }
+
+    if (existing.userHasLiked != incoming.userHasLiked) {
+        delta.userHasLikedChanged = hasChanged = true;
+    }
+
+    if (existing.caption.id != incoming.caption.id || existing.caption.text != incoming.caption.text) {
+        delta.captionChanged = hasChanged = true;
+    }
+
+    // The inline comment and like lists are truncated by the API, an empty list does not mean they were removed.
+    if (incoming.comments.empty() == false && isSameComments(existing.comments, incoming.comments) == false) {
+        delta.commentsChanged = hasChanged = true;
+    }
+
+    if (incoming.likes.empty() == false && isSameUsers(existing.likes, incoming.likes) == false) {
+        delta.likesChanged = hasChanged = true;
+    }
+
+    if (existing.tags != incoming.tags) {
+        delta.tagsChanged = hasChanged = true;
+    }
+
+    if (existing.location.id != incoming.location.id || existing.location.latitude != incoming.location.latitude ||
+            existing.location.longitude != incoming.location.longitude) {
+        delta.locationChanged = hasChanged = true;
+    }
+
+    return hasChanged;
+}
+
+void ofxInstagramPostStore::apply(PostData &merged, const PostData &incoming, const Delta &delta) const
+{
+    merged.likeCount = incoming.likeCount;
+    merged.commentCount = incoming.commentCount;
+    merged.userHasLiked = incoming.userHasLiked;
+
+    if (delta.captionChanged) {
+        merged.caption = incoming.caption;
+    }
+
+    if (delta.commentsChanged) {
+        merged.comments = incoming.comments;
+    }
+
+    if (delta.likesChanged) {
+        merged.likes = incoming.likes;
+    }
+
+    if (delta.tagsChanged) {
+        merged.tags = incoming.tags;
+    }
+
+    if (delta.locationChanged) {
+        merged.location = incoming.location;
+    }
+}
+
+void ofxInstagramPostStore::notify(const Delta &delta) const
+{
+    //A copy, a subscriber may unsubscribe while it is called
+    const SubscriberList subscribers = m_Shared->subscribers;
+    for (const auto &entry : subscribers) {
+        entry.second(delta);
+    }
+}
+
+// *                        SUBSCRIPTION
+// *  Holds the subscriber list weakly, so a subscription that outlives its store has nothing left to remove.
+// *  Removing takes the lock of the store, which waits for a subscriber that is being called on another thread.
+
+ofxInstagramPostStore::Subscription::Subscription()
+    : m_SubscriberID(0)
+{
+
+}
+
+ofxInstagramPostStore::Subscription::Subscription(Subscription &&other)
+    : m_Shared(std::move(other.m_Shared))
+    , m_SubscriberID(other.m_SubscriberID)
+{
+    other.m_Shared.reset();
+    other.m_SubscriberID = 0;
+}
+
+ofxInstagramPostStore::Subscription &ofxInstagramPostStore::Subscription::operator=(Subscription &&other)
+{
+    if (this != &other) {
+        reset();
+        m_Shared = std::move(other.m_Shared);
+        m_SubscriberID = other.m_SubscriberID;
+        other.m_Shared.reset();
+        other.m_SubscriberID = 0;
+    }
+
+    return *this;
+}
+
+ofxInstagramPostStore::Subscription::~Subscription()
+{
+    reset();
+}
+
+void ofxInstagramPostStore::Subscription::reset()
+{
+    std::shared_ptr<Shared> shared = m_Shared.lock();
+    if (shared) {
+        std::lock_guard<std::recursive_mutex> lock(shared->mutex);
+        removeSubscriber(shared->subscribers, m_SubscriberID);
+    }
+
+    m_Shared.reset();
+    m_SubscriberID = 0;
+}
+
+bool ofxInstagramPostStore::Subscription::isActive() const
+{
+    return m_Shared.expired() == false;
+}
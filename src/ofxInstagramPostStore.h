@@ -0,0 +1,118 @@
+#ifndef OFXINSTAGRAMPOSTSTORE_H
+#define OFXINSTAGRAMPOSTSTORE_H
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ofxInstagramTypes.h"
+
+// Central store of posts keyed by media ID. The same media comes back from the feed, tag and location endpoints; the store
+// keeps one record per ID, merges newer data (like/comment counts etc.) into it and hands out shared handles to that record.
+// Records are never modified once handed out: a merge that changes a record stores a changed copy in its place, so a
+// handle stays a consistent snapshot and find() or the Delta give the current version.
+//
+// The store can be used from any thread. Subscribers are called on the thread that changed the store and with the store
+// locked, so every subscriber sees the changes in the order they were made. They may call back into the store, but must
+// not wait for another thread that uses it.
+class ofxInstagramPostStore
+{
+public:
+    // Describes what changed in a record after a merge. Subscribers are only notified when something actually changed.
+    // erase() and clear() notify with isRemoved set and post pointing at the record that was removed.
+    struct Delta {
+        ofxInstagramTypes::PostHandle post;
+        bool isNew = false,
+             isRemoved = false,
+             userHasLikedChanged = false,
+             captionChanged = false,
+             commentsChanged = false,
+             likesChanged = false,
+             tagsChanged = false,
+             locationChanged = false;
+
+        int likeCountChange = 0,
+            commentCountChange = 0;
+    };
+
+    using Subscriber = std::function<void(const Delta &)>;
+
+private:
+    using SubscriberList = std::vector<std::pair<unsigned int, Subscriber>>;
+
+    //Shared with the subscriptions, which may outlive the store. The mutex guards the whole store.
+    struct Shared {
+        std::recursive_mutex mutex;
+        SubscriberList subscribers;
+    };
+
+public:
+    // Unsubscribes when it is reset or destroyed. It may outlive the store.
+    class Subscription
+    {
+    public:
+        Subscription();
+        Subscription(Subscription &&other);
+        Subscription &operator=(Subscription &&other);
+        ~Subscription();
+
+        void reset();
+        bool isActive() const;
+
+    private:
+        friend class ofxInstagramPostStore;
+
+        std::weak_ptr<Shared> m_Shared;
+        unsigned int m_SubscriberID;
+
+    private:
+        Subscription(const Subscription &) = delete;
+        Subscription &operator=(const Subscription &) = delete;
+    };
+
+public:
+    ofxInstagramPostStore();
+
+    // Inserts the post or merges it into the existing record with the same ID. Returns the handle of the stored record.
+    ofxInstagramTypes::PostHandle merge(const ofxInstagramTypes::PostData &post);
+    ofxInstagramTypes::PostHandle merge(ofxInstagramTypes::PostData &&post);
+
+    std::vector<ofxInstagramTypes::PostHandle> merge(const std::vector<ofxInstagramTypes::PostData> &posts);
+    std::vector<ofxInstagramTypes::PostHandle> merge(std::vector<ofxInstagramTypes::PostData> &&posts);
+
+    // Returns nullptr if there is no post with the given ID
+    ofxInstagramTypes::PostHandle find(const std::string &mediaID) const;
+    bool contains(const std::string &mediaID) const;
+
+    std::vector<ofxInstagramTypes::PostHandle> getPosts() const;
+    size_t size() const;
+
+    bool erase(const std::string &mediaID);
+    void clear();
+
+    // Returns an ID that can be passed to unsubscribe()
+    unsigned int subscribe(Subscriber subscriber);
+    void unsubscribe(unsigned int subscriberID);
+    // Subscribes until the returned subscription is reset or destroyed. Use it when the subscriber captures an object
+    // that can be destroyed before the store; once reset() returns the subscriber is not called anymore. With isReplayed
+    // set the subscriber is first called with isNew for every post in the store, with no change made in between.
+    Subscription subscribeScoped(Subscriber subscriber, bool isReplayed = false);
+
+private:
+    std::unordered_map<std::string, std::shared_ptr<ofxInstagramTypes::PostData>> m_Posts;
+    std::shared_ptr<Shared> m_Shared;
+    unsigned int m_NextSubscriberID;
+
+private:
+    template<typename PostType>
+    ofxInstagramTypes::PostHandle mergePost(PostType &&post);
+
+    bool diff(const ofxInstagramTypes::PostData &existing, const ofxInstagramTypes::PostData &incoming, Delta &delta) const;
+    void apply(ofxInstagramTypes::PostData &merged, const ofxInstagramTypes::PostData &incoming, const Delta &delta) const;
+    void notify(const Delta &delta) const;
+
+    static void removeSubscriber(SubscriberList &subscribers, unsigned int subscriberID);
+};
+
+#endif // OFXINSTAGRAMPOSTSTORE_H
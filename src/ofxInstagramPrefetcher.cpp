@@ -0,0 +1,293 @@
+#include "ofxInstagramPrefetcher.h"
+#include "ofMain.h"
+#include <cmath>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+//A page request without a response for this long is considered lost and made again
+const float PAGE_REQUEST_TIMEOUT = 30.f;
+//In seconds, doubled after every failed page request in a row
+const float PAGE_RETRY_DELAY = 1.f;
+const float MAX_PAGE_RETRY_DELAY = 60.f;
+
+//In seconds, doubled after every failure of the same image
+const float IMAGE_RETRY_DELAY = 1.f;
+const float MAX_IMAGE_RETRY_DELAY = 60.f;
+const unsigned int MAX_IMAGE_FAILURE_COUNT = 5;
+}
+
+ofxInstagramPrefetcher::ofxInstagramPrefetcher(ofxInstagram &instagram, ofxInstagramMediaLoader &mediaLoader)
+    : m_Instagram(instagram)
+    , m_MediaLoader(mediaLoader)
+    , m_ItemHeight(160.f)
+    , m_ColumnCount(1)
+    , m_ImageWidth(150)
+    , m_ImageHeight(150)
+    , m_AheadRows(6)
+    , m_KeepRows(24)
+    , m_IsLoadingPage(false)
+    , m_PageRequestTime(0.f)
+    , m_PageRetryTime(0.f)
+    , m_PageFailureCount(0)
+    , m_Generation(0)
+    , m_IsAlive(std::make_shared<bool>(true))
+{
+
+}
+
+ofxInstagramPrefetcher::~ofxInstagramPrefetcher()
+{
+    clear();
+}
+
+void ofxInstagramPrefetcher::setLayout(float itemHeight, int columnCount)
+{
+    m_ItemHeight = std::max(itemHeight, 1.f);
+    m_ColumnCount = std::max(columnCount, 1);
+}
+
+void ofxInstagramPrefetcher::setImageSize(int width, int height)
+{
+    m_ImageWidth = width;
+    m_ImageHeight = height;
+}
+
+void ofxInstagramPrefetcher::setPrefetchRows(int aheadRows, int keepRows)
+{
+    m_AheadRows = std::max(aheadRows, 0);
+    m_KeepRows = std::max(keepRows, m_AheadRows);
+}
+
+void ofxInstagramPrefetcher::append(const Posts &posts)
+{
+    const size_t firstIndex = m_Items.size();
+    m_Items.reserve(m_Items.size() + posts.first.size());
+    for (const PostData &post : posts.first) {
+        Item item;
+        item.post = post;
+        m_Items.push_back(item);
+    }
+
+    m_Pagination = posts.second;
+    if (onPostsAdded && posts.first.empty() == false) {
+        onPostsAdded(firstIndex, posts.first.size());
+    }
+}
+
+void ofxInstagramPrefetcher::clear()
+{
+    for (size_t index : m_ActiveItems) {
+        if (m_Items[index].requestID != 0) {
+            m_MediaLoader.cancel(m_Items[index].requestID);
+        }
+    }
+
+    m_ActiveItems.clear();
+    m_Items.clear();
+    m_Pagination = Pagination();
+    m_IsLoadingPage = false;
+    m_PageRetryTime = 0.f;
+    m_PageFailureCount = 0;
+    m_Generation++;
+}
+
+void ofxInstagramPrefetcher::update(float scrollOffset, float viewportHeight)
+{
+    if (m_Items.empty()) {
+        return;
+    }
+
+    const int rowCount = static_cast<int>((m_Items.size() + m_ColumnCount - 1) / m_ColumnCount);
+    const int firstVisibleRow = std::max(0, static_cast<int>(std::floor(scrollOffset / m_ItemHeight)));
+    const int lastVisibleRow = std::max(firstVisibleRow, static_cast<int>(std::floor((scrollOffset + viewportHeight) / m_ItemHeight)));
+
+    //Rows that scrolled far away give their images back first, so the new requests do not queue behind them
+    std::vector<size_t> farItems;
+    for (size_t index : m_ActiveItems) {
+        const int row = static_cast<int>(index / m_ColumnCount);
+        if (row < firstVisibleRow - m_KeepRows || row > lastVisibleRow + m_KeepRows) {
+            farItems.push_back(index);
+        }
+    }
+
+    for (size_t index : farItems) {
+        releaseItem(index);
+    }
+
+    //The visible rows first, then the ones below since that is where the list usually scrolls to, then the ones above
+    const float now = ofGetElapsedTimef();
+    auto requestRow = [this, now](int row) {
+        for (int column = 0; column < m_ColumnCount; column++) {
+            const size_t index = static_cast<size_t>(row) * m_ColumnCount + column;
+            if (index < m_Items.size() && isImageWanted(m_Items[index], now)) {
+                requestImage(index);
+            }
+        }
+    };
+
+    for (int row = firstVisibleRow; row <= std::min(lastVisibleRow, rowCount - 1); row++) {
+        requestRow(row);
+    }
+
+    for (int row = lastVisibleRow + 1; row <= std::min(lastVisibleRow + m_AheadRows, rowCount - 1); row++) {
+        requestRow(row);
+    }
+
+    for (int row = firstVisibleRow - 1; row >= std::max(firstVisibleRow - m_AheadRows, 0); row--) {
+        requestRow(row);
+    }
+
+    if (lastVisibleRow + m_AheadRows >= rowCount) {
+        requestNextPage();
+    }
+}
+
+size_t ofxInstagramPrefetcher::size() const
+{
+    return m_Items.size();
+}
+
+const PostData &ofxInstagramPrefetcher::getPost(size_t index) const
+{
+    return m_Items.at(index).post;
+}
+
+const ofxInstagramPixelPool::Handle &ofxInstagramPrefetcher::getPixels(size_t index) const
+{
+    return m_Items.at(index).pixels;
+}
+
+bool ofxInstagramPrefetcher::hasNextPage() const
+{
+    return m_Pagination.nextURL.length() != 0;
+}
+
+bool ofxInstagramPrefetcher::isLoadingPage() const
+{
+    return m_IsLoadingPage;
+}
+
+ofxInstagramPrefetcher::Stats ofxInstagramPrefetcher::getStats() const
+{
+    Stats stats = m_Stats;
+    stats.residentCount = 0;
+    stats.pendingCount = 0;
+    for (size_t index : m_ActiveItems) {
+        stats.residentCount += m_Items[index].pixels != nullptr ? 1 : 0;
+        stats.pendingCount += m_Items[index].requestID != 0 ? 1 : 0;
+    }
+
+    return stats;
+}
+
+bool ofxInstagramPrefetcher::isImageWanted(const Item &item, float now) const
+{
+    if (item.pixels != nullptr || item.requestID != 0) {
+        return false;
+    }
+
+    return item.failureCount == 0 || (item.failureCount < MAX_IMAGE_FAILURE_COUNT && now >= item.retryTime);
+}
+
+void ofxInstagramPrefetcher::requestImage(size_t index)
+{
+    std::weak_ptr<bool> isAlive = m_IsAlive;
+    const uint64_t requestID = m_MediaLoader.load(m_Items[index].post, m_ImageWidth, m_ImageHeight,
+    [this, isAlive, index](ofxInstagramMediaLoader::Result & result) {
+        //Also ignores results for rows that were released or for a list that was cleared in the meantime
+        if (isAlive.expired() || index >= m_Items.size() || m_Items[index].requestID != result.requestID) {
+            return;
+        }
+
+        Item &item = m_Items[index];
+        item.requestID = 0;
+        if (result.isSuccessful) {
+            item.pixels = result.pixels;
+            item.failureCount = 0;
+        }
+        else {
+            const float delay = IMAGE_RETRY_DELAY * static_cast<float>(1u << std::min(item.failureCount, 16u));
+            item.retryTime = ofGetElapsedTimef() + std::min(delay, MAX_IMAGE_RETRY_DELAY);
+            item.failureCount++;
+            m_Stats.failedCount++;
+            m_ActiveItems.erase(index);
+        }
+
+        if (onImageLoaded) {
+            onImageLoaded(index, result);
+        }
+    });
+
+    if (requestID != 0) {
+        m_Items[index].requestID = requestID;
+        m_ActiveItems.insert(index);
+        m_Stats.imageRequestCount++;
+    }
+}
+
+void ofxInstagramPrefetcher::releaseItem(size_t index)
+{
+    Item &item = m_Items[index];
+    if (item.requestID != 0) {
+        //A download that already started still finishes, its result is dropped when it arrives
+        m_MediaLoader.cancel(item.requestID);
+        item.requestID = 0;
+        m_Stats.cancelledCount++;
+    }
+
+    if (item.pixels) {
+        item.pixels.reset();
+        m_Stats.releasedCount++;
+    }
+
+    m_ActiveItems.erase(index);
+}
+
+void ofxInstagramPrefetcher::requestNextPage()
+{
+    const float now = ofGetElapsedTimef();
+    if ((m_IsLoadingPage && now - m_PageRequestTime < PAGE_REQUEST_TIMEOUT) || hasNextPage() == false || now < m_PageRetryTime) {
+        return;
+    }
+
+    //Set before the request is made, the failure handler can be called before getNextPage() returns
+    m_IsLoadingPage = true;
+    m_PageRequestTime = now;
+    m_Stats.pageRequestCount++;
+
+    std::weak_ptr<bool> isAlive = m_IsAlive;
+    const unsigned int generation = m_Generation;
+    const int requestID = m_Instagram.getNextPage(m_Pagination, [this, isAlive, generation](Posts posts) {
+        if (isAlive.expired() || generation != m_Generation) {
+            return;
+        }
+
+        m_IsLoadingPage = false;
+        m_PageFailureCount = 0;
+        //A page that comes back twice after a timeout must not be appended twice
+        if (posts.second.nextURL == m_Pagination.nextURL) {
+            return;
+        }
+
+        append(posts);
+    },
+    [this, isAlive, generation](const Meta & meta) {
+        if (isAlive.expired() || generation != m_Generation) {
+            return;
+        }
+
+        //The pagination is kept, so the same page is asked for again once the delay is over
+        const float delay = PAGE_RETRY_DELAY * static_cast<float>(1u << std::min(m_PageFailureCount, 16u));
+        m_PageRetryTime = ofGetElapsedTimef() + std::min(delay, MAX_PAGE_RETRY_DELAY);
+        m_PageFailureCount++;
+        m_IsLoadingPage = false;
+        m_Stats.pageFailedCount++;
+        ofLogWarning("ofxInstagramPrefetcher") << "Loading the next page failed with " << meta.errorType << " " << meta.code
+                                               << ", retrying in " << std::min(delay, MAX_PAGE_RETRY_DELAY) << " s";
+    });
+
+    if (requestID < 0) {
+        m_IsLoadingPage = false;
+    }
+}
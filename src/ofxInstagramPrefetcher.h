@@ -0,0 +1,105 @@
+#ifndef OFXINSTAGRAMPREFETCHER_H
+#define OFXINSTAGRAMPREFETCHER_H
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "ofxInstagram.h"
+#include "ofxInstagramMediaLoader.h"
+
+// Ties a scrolling list of posts to data and image loading. Given the scroll offset and the viewport height it loads the
+// images of the visible rows and of the rows about to appear, asks for the next page before the end of the list is
+// reached, and cancels or releases the images of rows that scrolled far away. Memory stays bounded by the number of rows
+// kept around instead of growing with the length of the list.
+class ofxInstagramPrefetcher
+{
+public:
+    struct Stats {
+        size_t residentCount = 0,
+               pendingCount = 0;
+
+        uint64_t imageRequestCount = 0,
+                 cancelledCount = 0,
+                 releasedCount = 0,
+                 failedCount = 0,
+                 pageRequestCount = 0,
+                 pageFailedCount = 0;
+    };
+
+    // Called on the main thread for every image of a row that is still wanted. A failed image is retried after 1 s, with
+    // the delay doubling after every failure, and not requested again after 5 failures.
+    std::function<void(size_t, ofxInstagramMediaLoader::Result &)> onImageLoaded;
+    // Called with the index of the first new post and the number of posts added
+    std::function<void(size_t, size_t)> onPostsAdded;
+
+public:
+    ofxInstagramPrefetcher(ofxInstagram &instagram, ofxInstagramMediaLoader &mediaLoader);
+    ~ofxInstagramPrefetcher();
+
+    // itemHeight is the height of a row in pixels, every row holds columnCount posts
+    void setLayout(float itemHeight, int columnCount = 1);
+    // Size the images are loaded at
+    void setImageSize(int width, int height);
+    // Rows outside the viewport that are loaded ahead, and the distance in rows after which they are dropped again
+    void setPrefetchRows(int aheadRows, int keepRows);
+
+    // Adds a page of posts, usually the first one. The following pages are requested through its pagination.
+    void append(const ofxInstagramTypes::Posts &posts);
+    void clear();
+
+    // Call this from ofApp::update(). scrollOffset is how far the list is scrolled down in pixels, which is
+    // -ofxInstagramJSONView::getScrollValue() for the same style of scrolling.
+    void update(float scrollOffset, float viewportHeight);
+
+    size_t size() const;
+    const ofxInstagramTypes::PostData &getPost(size_t index) const;
+    // Empty until the image is loaded and again after its row scrolled far away
+    const ofxInstagramPixelPool::Handle &getPixels(size_t index) const;
+
+    bool hasNextPage() const;
+    bool isLoadingPage() const;
+
+    Stats getStats() const;
+
+private:
+    struct Item {
+        ofxInstagramTypes::PostData post;
+        ofxInstagramPixelPool::Handle pixels;
+        uint64_t requestID = 0;
+
+        //Failed images are retried with a growing delay and given up on after a few attempts
+        unsigned int failureCount = 0;
+        float retryTime = 0.f;
+    };
+
+    ofxInstagram &m_Instagram;
+    ofxInstagramMediaLoader &m_MediaLoader;
+
+    float m_ItemHeight;
+    int m_ColumnCount, m_ImageWidth, m_ImageHeight, m_AheadRows, m_KeepRows;
+
+    std::vector<Item> m_Items;
+    //Items that hold pixels or have a request in flight, so far away rows are found without walking the whole list
+    std::unordered_set<size_t> m_ActiveItems;
+
+    ofxInstagramTypes::Pagination m_Pagination;
+    bool m_IsLoadingPage;
+    float m_PageRequestTime;
+    //A failed page is asked for again after 1 s, with the delay doubling after every failure up to 60 s
+    float m_PageRetryTime;
+    unsigned int m_PageFailureCount;
+    //Bumped by clear() so that responses for the previous list are ignored
+    unsigned int m_Generation;
+    Stats m_Stats;
+
+    //Responses can arrive after the prefetcher is gone, the callbacks check this first
+    std::shared_ptr<bool> m_IsAlive;
+
+private:
+    bool isImageWanted(const Item &item, float now) const;
+    void requestImage(size_t index);
+    void releaseItem(size_t index);
+    void requestNextPage();
+};
+
+#endif // OFXINSTAGRAMPREFETCHER_H
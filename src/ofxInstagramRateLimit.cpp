@@ -0,0 +1,71 @@
+#include "ofxInstagramRateLimit.h"
+#include <algorithm>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+//In microseconds
+const uint64_t DEFAULT_BACKOFF = 60000000;
+const uint64_t MAX_BACKOFF = 3600000000;
+
+const std::string RATE_LIMIT_ERROR = "OAuthRateLimitException";
+const std::string RATE_LIMIT_CODE = "429";
+}
+
+ofxInstagramRateLimit::ofxInstagramRateLimit()
+    : m_Backoff(DEFAULT_BACKOFF)
+    , m_CurrentBackoff(DEFAULT_BACKOFF)
+    , m_ResumeTime(0)
+    , m_IsBackingOff(false)
+{
+
+}
+
+bool ofxInstagramRateLimit::isRateLimited(const Meta &error)
+{
+    return error.errorType == RATE_LIMIT_ERROR || error.code == RATE_LIMIT_CODE;
+}
+
+void ofxInstagramRateLimit::setBackoff(double seconds)
+{
+    m_Backoff = static_cast<uint64_t>(std::max(seconds, 0.0) * 1000000.0);
+    m_CurrentBackoff = m_Backoff;
+}
+
+bool ofxInstagramRateLimit::backOff(uint64_t now)
+{
+    if (now < m_ResumeTime) {
+        return false;
+    }
+
+    //Still limited after waiting, so the last pause was too short
+    if (m_IsBackingOff) {
+        m_CurrentBackoff = std::min(m_CurrentBackoff * 2, MAX_BACKOFF);
+    }
+
+    m_IsBackingOff = true;
+    m_ResumeTime = now + m_CurrentBackoff;
+    return true;
+}
+
+void ofxInstagramRateLimit::reset()
+{
+    m_IsBackingOff = false;
+    m_CurrentBackoff = m_Backoff;
+}
+
+void ofxInstagramRateLimit::clear()
+{
+    reset();
+    m_ResumeTime = 0;
+}
+
+bool ofxInstagramRateLimit::isPaused(uint64_t now) const
+{
+    return now < m_ResumeTime;
+}
+
+uint64_t ofxInstagramRateLimit::getResumeTime() const
+{
+    return m_ResumeTime;
+}
@@ -0,0 +1,35 @@
+#ifndef OFXINSTAGRAMRATELIMIT_H
+#define OFXINSTAGRAMRATELIMIT_H
+#include <cstdint>
+#include "ofxInstagramTypes.h"
+
+// Back off for the rate limit responses of the API. The first one pauses the requests for the back off, and one that
+// arrives after the pause is over pauses them again for twice as long, up to an hour. Responses of requests that were
+// already on their way arrive during the pause and do not change it. A successful response resets the back off. Times
+// are ofGetElapsedTimeMicros(). Not thread safe, the owner guards it with its own lock.
+class ofxInstagramRateLimit
+{
+public:
+    ofxInstagramRateLimit();
+
+    static bool isRateLimited(const ofxInstagramTypes::Meta &error);
+
+    // Seconds to wait after the first rate limit response, 60 by default
+    void setBackoff(double seconds);
+
+    // Returns true when the response started a pause, false when it arrived during one
+    bool backOff(uint64_t now);
+    void reset();
+    // Also forgets a pause that is running
+    void clear();
+
+    bool isPaused(uint64_t now) const;
+    uint64_t getResumeTime() const;
+
+private:
+    uint64_t m_Backoff, m_CurrentBackoff, m_ResumeTime;
+    //Set from the first rate limit response until a successful one
+    bool m_IsBackingOff;
+};
+
+#endif // OFXINSTAGRAMRATELIMIT_H
@@ -0,0 +1,177 @@
+#include "ofxInstagramRecorder.h"
+#include <cstring>
+#include "ofLog.h"
+#include "ofUtils.h"
+
+namespace
+{
+const char MAGIC[4] = {'I', 'G', 'R', 'L'};
+const uint32_t VERSION = 1;
+const std::string TOKEN_PARAMETER = "access_token=";
+const std::string REDACTED = "REDACTED";
+
+//Fixed size part of a record, the name, URL and body follow it
+struct RecordHeader {
+    uint32_t nameLength, urlLength, bodyLength;
+    int32_t status;
+    uint64_t startTime, duration;
+};
+
+template<typename T>
+void writeValue(std::ofstream &file, const T &value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream &file, T &value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+}
+
+ofxInstagramRecorder::ofxInstagramRecorder()
+    : m_RecordingStartTime(0)
+    , m_RecordCount(0)
+{
+
+}
+
+ofxInstagramRecorder::~ofxInstagramRecorder()
+{
+    close();
+}
+
+bool ofxInstagramRecorder::open(const std::string &path)
+{
+    close();
+    m_File.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (m_File.is_open() == false) {
+        ofLogError("ofxInstagramRecorder") << __FUNCTION__ << ": Cannot open " << path;
+        return false;
+    }
+
+    m_File.write(MAGIC, sizeof(MAGIC));
+    writeValue(m_File, VERSION);
+    m_RecordingStartTime = ofGetElapsedTimeMicros();
+    m_RecordCount = 0;
+    return true;
+}
+
+void ofxInstagramRecorder::close()
+{
+    if (m_File.is_open()) {
+        m_File.close();
+    }
+}
+
+bool ofxInstagramRecorder::isOpen() const
+{
+    return m_File.is_open();
+}
+
+void ofxInstagramRecorder::record(const ofHttpResponse &response, uint64_t startTime)
+{
+    if (m_File.is_open() == false) {
+        return;
+    }
+
+    const uint64_t now = ofGetElapsedTimeMicros();
+    Record record;
+    record.requestName = response.request.name;
+    record.url = redactURL(response.request.url);
+    record.body = response.data.getText();
+    record.status = response.status;
+    record.startTime = startTime > m_RecordingStartTime ? startTime - m_RecordingStartTime : 0;
+    record.duration = now > startTime ? now - startTime : 0;
+    this->record(record);
+}
+
+void ofxInstagramRecorder::record(const Record &record)
+{
+    std::lock_guard<std::mutex> lock(m_FileMutex);
+    if (m_File.is_open() == false) {
+        return;
+    }
+
+    RecordHeader header;
+    header.nameLength = static_cast<uint32_t>(record.requestName.length());
+    header.urlLength = static_cast<uint32_t>(record.url.length());
+    header.bodyLength = static_cast<uint32_t>(record.body.length());
+    header.status = record.status;
+    header.startTime = record.startTime;
+    header.duration = record.duration;
+
+    writeValue(m_File, header);
+    m_File.write(record.requestName.data(), record.requestName.length());
+    m_File.write(record.url.data(), record.url.length());
+    m_File.write(record.body.data(), record.body.length());
+    m_RecordCount++;
+}
+
+uint64_t ofxInstagramRecorder::getRecordCount() const
+{
+    return m_RecordCount;
+}
+
+std::string ofxInstagramRecorder::redactURL(const std::string &url)
+{
+    std::string redacted = url;
+    size_t position = redacted.find(TOKEN_PARAMETER);
+    while (position != std::string::npos) {
+        const size_t valueStart = position + TOKEN_PARAMETER.length();
+        size_t valueEnd = redacted.find('&', valueStart);
+        if (valueEnd == std::string::npos) {
+            valueEnd = redacted.length();
+        }
+
+        redacted.replace(valueStart, valueEnd - valueStart, REDACTED);
+        position = redacted.find(TOKEN_PARAMETER, valueStart + REDACTED.length());
+    }
+
+    return redacted;
+}
+
+bool ofxInstagramRecorder::load(const std::string &path, std::vector<Record> &records)
+{
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    if (file.is_open() == false) {
+        ofLogError("ofxInstagramRecorder") << __FUNCTION__ << ": Cannot open " << path;
+        return false;
+    }
+
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    if (file.read(magic, sizeof(magic)).good() == false || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            readValue(file, version) == false || version != VERSION) {
+        ofLogError("ofxInstagramRecorder") << __FUNCTION__ << ": " << path << " is not a recording or has another version.";
+        return false;
+    }
+
+    RecordHeader header;
+    while (readValue(file, header)) {
+        //A damaged length must not turn into a huge allocation
+        const uint64_t remaining = fileSize - static_cast<uint64_t>(file.tellg());
+        if (static_cast<uint64_t>(header.nameLength) + header.urlLength + header.bodyLength > remaining) {
+            ofLogWarning("ofxInstagramRecorder") << __FUNCTION__ << ": " << path << " is truncated after " << records.size() << " records.";
+            break;
+        }
+
+        Record record;
+        record.requestName.resize(header.nameLength);
+        record.url.resize(header.urlLength);
+        record.body.resize(header.bodyLength);
+        file.read(&record.requestName[0], header.nameLength);
+        file.read(&record.url[0], header.urlLength);
+        file.read(&record.body[0], header.bodyLength);
+        record.status = header.status;
+        record.startTime = header.startTime;
+        record.duration = header.duration;
+        records.push_back(std::move(record));
+    }
+
+    return true;
+}
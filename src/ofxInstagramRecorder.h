@@ -0,0 +1,53 @@
+#ifndef OFXINSTAGRAMRECORDER_H
+#define OFXINSTAGRAMRECORDER_H
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ofURLFileLoader.h"
+
+// Writes the responses ofxInstagram receives to a log: the request name, the URL with the access token removed, the
+// status, when the request was made and how long it took, and the raw body. Records are length prefixed binary, so the
+// bodies are stored as they were received. ofxInstagramReplayTransport plays a log back.
+class ofxInstagramRecorder
+{
+public:
+    struct Record {
+        std::string requestName = "",
+                    url = "",
+                    body = "";
+
+        int status = 0;
+        //In microseconds, startTime is relative to when the recording started
+        uint64_t startTime = 0,
+                 duration = 0;
+    };
+
+public:
+    ofxInstagramRecorder();
+    ~ofxInstagramRecorder();
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+
+    // startTime is the ofGetElapsedTimeMicros() of when the request was made. Responses delivered on different threads are
+    // written one after the other.
+    void record(const ofHttpResponse &response, uint64_t startTime);
+    void record(const Record &record);
+
+    uint64_t getRecordCount() const;
+
+    // Replaces the values of access_token parameters
+    static std::string redactURL(const std::string &url);
+    // Reads all the records of a log
+    static bool load(const std::string &path, std::vector<Record> &records);
+
+private:
+    std::ofstream m_File;
+    std::mutex m_FileMutex;
+    uint64_t m_RecordingStartTime, m_RecordCount;
+};
+
+#endif // OFXINSTAGRAMRECORDER_H
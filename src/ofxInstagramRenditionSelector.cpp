@@ -0,0 +1,137 @@
+#include "ofxInstagramRenditionSelector.h"
+#include <algorithm>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+//Smallest first
+const MediaType IMAGE_TYPES[] = {MEDIA_IMAGE_THUMBNAIL, MEDIA_IMAGE_LOW_RESOLUTION, MEDIA_IMAGE_STANDARD_RESOLUTION};
+const MediaType VIDEO_TYPES[] = {MEDIA_VIDEO_LOW_BANDWIDTH, MEDIA_VIDEO_LOW_RESOLUTION, MEDIA_VIDEO_STANDARD_RESOLUTION};
+
+//Instagram JPEGs average about 0.2 bytes per pixel
+const double IMAGE_BYTES_PER_PIXEL = 0.2;
+//Bytes per pixel per second of video for each tier
+const double VIDEO_BYTES_PER_PIXEL_SECOND[] = {0.25, 0.45, 0.6};
+
+//The API does not always send the dimensions, these are the documented defaults
+const unsigned int DEFAULT_SIZES[] = {150, 320, 640, 480, 480, 640};
+}
+
+ofxInstagramRenditionSelector::ofxInstagramRenditionSelector()
+    : m_MaxImageDownloadTime(0.0)
+    , m_BandwidthHeadroom(0.8)
+    , m_SavedBytes(0)
+    , m_SavedVideoBytesPerSecond(0)
+    , m_SelectionCount(0)
+{
+
+}
+
+void ofxInstagramRenditionSelector::setMaxImageDownloadTime(double seconds)
+{
+    m_MaxImageDownloadTime = seconds;
+}
+
+void ofxInstagramRenditionSelector::setBandwidthHeadroom(double headroom)
+{
+    m_BandwidthHeadroom = headroom;
+}
+
+MediaType ofxInstagramRenditionSelector::select(const PostData &post, int targetWidth, int targetHeight, double bytesPerSecond)
+{
+    if (post.type == "video") {
+        return selectVideo(post, targetWidth, targetHeight, bytesPerSecond);
+    }
+
+    return selectImage(post, targetWidth, targetHeight, bytesPerSecond);
+}
+
+MediaType ofxInstagramRenditionSelector::selectImage(const PostData &post, int targetWidth, int targetHeight, double bytesPerSecond)
+{
+    return selectFrom(post, IMAGE_TYPES, 3, targetWidth, targetHeight, bytesPerSecond, m_MaxImageDownloadTime, m_SavedBytes);
+}
+
+MediaType ofxInstagramRenditionSelector::selectVideo(const PostData &post, int targetWidth, int targetHeight, double bytesPerSecond)
+{
+    //A video tier fits if one second of it downloads in one second
+    return selectFrom(post, VIDEO_TYPES, 3, targetWidth, targetHeight, bytesPerSecond * m_BandwidthHeadroom, bytesPerSecond > 0.0 ? 1.0 : 0.0,
+                      m_SavedVideoBytesPerSecond);
+}
+
+double ofxInstagramRenditionSelector::estimateBytes(const PostMedia &media, MediaType mediaType)
+{
+    const double width = media.width != 0 ? media.width : DEFAULT_SIZES[mediaType];
+    const double height = media.height != 0 ? media.height : DEFAULT_SIZES[mediaType];
+    switch (mediaType) {
+    case MEDIA_VIDEO_LOW_BANDWIDTH:
+    case MEDIA_VIDEO_LOW_RESOLUTION:
+    case MEDIA_VIDEO_STANDARD_RESOLUTION:
+        return width * height * VIDEO_BYTES_PER_PIXEL_SECOND[mediaType - MEDIA_VIDEO_LOW_BANDWIDTH];
+    default:
+        return width * height * IMAGE_BYTES_PER_PIXEL;
+    }
+}
+
+uint64_t ofxInstagramRenditionSelector::getSavedBytes() const
+{
+    return m_SavedBytes;
+}
+
+uint64_t ofxInstagramRenditionSelector::getSavedVideoBytesPerSecond() const
+{
+    return m_SavedVideoBytesPerSecond;
+}
+
+uint64_t ofxInstagramRenditionSelector::getSelectionCount() const
+{
+    return m_SelectionCount;
+}
+
+void ofxInstagramRenditionSelector::resetStats()
+{
+    m_SavedBytes = 0;
+    m_SavedVideoBytesPerSecond = 0;
+    m_SelectionCount = 0;
+}
+
+MediaType ofxInstagramRenditionSelector::selectFrom(const PostData &post, const MediaType *types, size_t typeCount, int targetWidth, int targetHeight,
+        double bytesPerSecond, double maxTime, std::atomic<uint64_t> &saved)
+{
+    //Only consider the renditions the post actually has
+    std::vector<MediaType> available;
+    for (size_t typeIndex = 0; typeIndex < typeCount; typeIndex++) {
+        if (post.getMedia(types[typeIndex]).url.length() != 0) {
+            available.push_back(types[typeIndex]);
+        }
+    }
+
+    if (available.empty()) {
+        return types[typeCount - 1];
+    }
+
+    //The smallest one that covers the target size, or the largest there is
+    size_t selected = available.size() - 1;
+    for (size_t index = 0; index < available.size(); index++) {
+        const PostMedia &media = post.getMedia(available[index]);
+        const int width = media.width != 0 ? media.width : DEFAULT_SIZES[available[index]];
+        const int height = media.height != 0 ? media.height : DEFAULT_SIZES[available[index]];
+        if (width >= targetWidth && height >= targetHeight) {
+            selected = index;
+            break;
+        }
+    }
+
+    //Step down while the throughput can not keep up
+    if (bytesPerSecond > 0.0 && maxTime > 0.0) {
+        while (selected > 0 && estimateBytes(post.getMedia(available[selected]), available[selected]) / bytesPerSecond > maxTime) {
+            selected--;
+        }
+    }
+
+    const MediaType largest = available.back();
+    const double savedBytes = estimateBytes(post.getMedia(largest), largest) - estimateBytes(post.getMedia(available[selected]), available[selected]);
+    saved += static_cast<uint64_t>(std::max(savedBytes, 0.0));
+    m_SelectionCount++;
+
+    return available[selected];
+}
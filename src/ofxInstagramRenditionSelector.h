@@ -0,0 +1,48 @@
+#ifndef OFXINSTAGRAMRENDITIONSELECTOR_H
+#define OFXINSTAGRAMRENDITIONSELECTOR_H
+#include <atomic>
+#include <cstdint>
+#include "ofxInstagramTypes.h"
+
+// Picks the smallest rendition of a post that still covers the size it will be drawn at. Videos are also limited to the
+// bandwidth tier the measured download throughput can sustain. Every selection adds up what it saved compared to the
+// standard resolution: bytes for images, bytes per second of playback for videos, since the API does not give their length.
+class ofxInstagramRenditionSelector
+{
+public:
+    ofxInstagramRenditionSelector();
+
+    // Images are stepped down further if the chosen one would take longer than this to download. In seconds, 0 disables it.
+    void setMaxImageDownloadTime(double seconds);
+    // Only this fraction of the measured throughput is relied on when picking a video tier
+    void setBandwidthHeadroom(double headroom);
+
+    // bytesPerSecond is the measured throughput of one download, 0 if it is not known yet
+    ofxInstagramTypes::MediaType select(const ofxInstagramTypes::PostData &post, int targetWidth, int targetHeight, double bytesPerSecond = 0.0);
+    ofxInstagramTypes::MediaType selectImage(const ofxInstagramTypes::PostData &post, int targetWidth, int targetHeight, double bytesPerSecond = 0.0);
+    ofxInstagramTypes::MediaType selectVideo(const ofxInstagramTypes::PostData &post, int targetWidth, int targetHeight, double bytesPerSecond = 0.0);
+
+    // Rough size of a rendition. For videos this is bytes per second of playback.
+    static double estimateBytes(const ofxInstagramTypes::PostMedia &media, ofxInstagramTypes::MediaType mediaType);
+
+    // Bytes saved by the image selections
+    uint64_t getSavedBytes() const;
+    // Bytes per second of playback saved by the video selections, added up over all of them
+    uint64_t getSavedVideoBytesPerSecond() const;
+    uint64_t getSelectionCount() const;
+    void resetStats();
+
+private:
+    double m_MaxImageDownloadTime;
+    double m_BandwidthHeadroom;
+
+    std::atomic<uint64_t> m_SavedBytes;
+    std::atomic<uint64_t> m_SavedVideoBytesPerSecond;
+    std::atomic<uint64_t> m_SelectionCount;
+
+private:
+    ofxInstagramTypes::MediaType selectFrom(const ofxInstagramTypes::PostData &post, const ofxInstagramTypes::MediaType *types, size_t typeCount,
+                                            int targetWidth, int targetHeight, double bytesPerSecond, double maxTime, std::atomic<uint64_t> &saved);
+};
+
+#endif // OFXINSTAGRAMRENDITIONSELECTOR_H
@@ -0,0 +1,177 @@
+#include "ofxInstagramReplayTransport.h"
+#include <algorithm>
+#include <limits>
+#include "ofLog.h"
+#include "ofUtils.h"
+
+namespace
+{
+const size_t NO_RECORD = std::numeric_limits<size_t>::max();
+const int STATUS_NOT_RECORDED = 404;
+}
+
+ofxInstagramReplayTransport::ofxInstagramReplayTransport(ofxInstagram &instagram)
+    : m_Instagram(instagram)
+    , m_Speed(1.0)
+    , m_PlayingRecord(NO_RECORD)
+    , m_ReplayedCount(0)
+    , m_MissingCount(0)
+{
+
+}
+
+bool ofxInstagramReplayTransport::open(const std::string &path)
+{
+    std::vector<ofxInstagramRecorder::Record> records;
+    if (ofxInstagramRecorder::load(path, records) == false) {
+        return false;
+    }
+
+    setRecords(records);
+    return true;
+}
+
+void ofxInstagramReplayTransport::setRecords(const std::vector<ofxInstagramRecorder::Record> &records)
+{
+    m_Records = records;
+    m_IsRecordUsed.assign(m_Records.size(), false);
+    m_RecordsByURL.clear();
+    m_RecordsByName.clear();
+    m_Events.clear();
+    m_ReplayedCount = 0;
+    m_MissingCount = 0;
+
+    for (size_t recordIndex = 0; recordIndex < m_Records.size(); recordIndex++) {
+        m_RecordsByURL[m_Records[recordIndex].url].push_back(recordIndex);
+        m_RecordsByName[m_Records[recordIndex].requestName].push_back(recordIndex);
+    }
+}
+
+void ofxInstagramReplayTransport::setSpeed(double speed)
+{
+    m_Speed = std::max(speed, 0.0);
+}
+
+void ofxInstagramReplayTransport::play()
+{
+    const uint64_t now = ofGetElapsedTimeMicros();
+    for (size_t recordIndex = 0; recordIndex < m_Records.size(); recordIndex++) {
+        Event event;
+        event.isRequest = true;
+        event.recordIndex = recordIndex;
+        m_Events.insert(std::make_pair(now + getDelay(m_Records[recordIndex].startTime), event));
+    }
+}
+
+void ofxInstagramReplayTransport::update()
+{
+    //Requests made from the callbacks are scheduled from now on, they wait for the next update() even at speed 0
+    const uint64_t now = ofGetElapsedTimeMicros();
+    std::vector<std::pair<uint64_t, Event>> dueEvents;
+    const auto dueEnd = m_Events.upper_bound(now);
+    for (auto eventIt = m_Events.begin(); eventIt != dueEnd; ++eventIt) {
+        dueEvents.push_back(std::move(*eventIt));
+    }
+
+    m_Events.erase(m_Events.begin(), dueEnd);
+
+    for (auto &dueEvent : dueEvents) {
+        Event &event = dueEvent.second;
+        if (event.isRequest) {
+            const ofxInstagramRecorder::Record &record = m_Records[event.recordIndex];
+            m_PlayingRecord = event.recordIndex;
+            m_Instagram.request(record.url, record.requestName);
+            m_PlayingRecord = NO_RECORD;
+        }
+        else {
+            m_Timings[event.response.request.getID()] = std::make_pair(now - dueEvent.first, event.delay);
+            m_Instagram.urlResponse(event.response);
+            m_Timings.erase(event.response.request.getID());
+        }
+    }
+}
+
+bool ofxInstagramReplayTransport::isDone() const
+{
+    return m_Events.empty();
+}
+
+uint64_t ofxInstagramReplayTransport::getReplayedCount() const
+{
+    return m_ReplayedCount;
+}
+
+uint64_t ofxInstagramReplayTransport::getMissingCount() const
+{
+    return m_MissingCount;
+}
+
+void ofxInstagramReplayTransport::load(const ofHttpRequest &request)
+{
+    size_t recordIndex = m_PlayingRecord;
+    if (recordIndex == NO_RECORD) {
+        recordIndex = takeRecord(m_RecordsByURL[ofxInstagramRecorder::redactURL(request.url)]);
+    }
+
+    if (recordIndex == NO_RECORD) {
+        recordIndex = takeRecord(m_RecordsByName[request.name]);
+    }
+
+    Event event;
+    event.response.request = request;
+    uint64_t delay = 0;
+    if (recordIndex != NO_RECORD) {
+        const ofxInstagramRecorder::Record &record = m_Records[recordIndex];
+        m_IsRecordUsed[recordIndex] = true;
+        event.response.data.set(record.body.data(), record.body.size());
+        event.response.status = record.status;
+        delay = getDelay(record.duration);
+        event.delay = delay;
+        m_ReplayedCount++;
+    }
+    else {
+        ofLogWarning("ofxInstagramReplayTransport") << __FUNCTION__ << ": No recorded response for " << request.name << ".";
+        event.response.status = STATUS_NOT_RECORDED;
+        event.response.error = "Not in the recording";
+        m_MissingCount++;
+    }
+
+    m_Events.insert(std::make_pair(ofGetElapsedTimeMicros() + delay, event));
+}
+
+bool ofxInstagramReplayTransport::getTiming(int requestID, uint64_t &queueTime, uint64_t &networkTime)
+{
+    auto timingIt = m_Timings.find(requestID);
+    if (timingIt == m_Timings.end()) {
+        return false;
+    }
+
+    queueTime = timingIt->second.first;
+    networkTime = timingIt->second.second;
+    return true;
+}
+
+size_t ofxInstagramReplayTransport::takeRecord(std::deque<size_t> &recordIndices)
+{
+    //The other lookup may have used a record already
+    while (recordIndices.empty() == false && m_IsRecordUsed[recordIndices.front()]) {
+        recordIndices.pop_front();
+    }
+
+    if (recordIndices.empty()) {
+        return NO_RECORD;
+    }
+
+    const size_t recordIndex = recordIndices.front();
+    recordIndices.pop_front();
+    return recordIndex;
+}
+
+uint64_t ofxInstagramReplayTransport::getDelay(uint64_t duration) const
+{
+    if (m_Speed == 0.0) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(duration / m_Speed);
+}
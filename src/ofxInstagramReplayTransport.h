@@ -0,0 +1,77 @@
+#ifndef OFXINSTAGRAMREPLAYTRANSPORT_H
+#define OFXINSTAGRAMREPLAYTRANSPORT_H
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "ofxInstagram.h"
+#include "ofxInstagramRecorder.h"
+#include "ofxInstagramTransport.h"
+
+// Answers ofxInstagram's requests from a log written by ofxInstagramRecorder instead of the network. A request gets the
+// first unused recorded response for the same URL, apart from the access token, or else for the same request name. It is
+// delivered after the recorded duration divided by the speed, so the same log always results in the same sequence of
+// callbacks.
+//
+//     auto replay = std::make_shared<ofxInstagramReplayTransport>(instagram);
+//     replay->open("session.igrl");
+//     instagram.setTransport(replay);
+//     replay->play();
+class ofxInstagramReplayTransport : public ofxInstagramTransport
+{
+public:
+    explicit ofxInstagramReplayTransport(ofxInstagram &instagram);
+
+    bool open(const std::string &path);
+    void setRecords(const std::vector<ofxInstagramRecorder::Record> &records);
+
+    // 1 keeps the recorded timing, 2 plays twice as fast and 0 delivers every response on the next update()
+    void setSpeed(double speed);
+
+    // Makes the recorded requests again in their recorded order and timing, without the app calling the getters. The
+    // responses are delivered to the on...Received members.
+    void play();
+
+    // Makes the requests and delivers the responses that are due, call it from ofApp::update()
+    void update();
+
+    // True when nothing is waiting to be requested or delivered
+    bool isDone() const;
+    // Requests that were answered with a response from the log, and ones that had none
+    uint64_t getReplayedCount() const;
+    uint64_t getMissingCount() const;
+
+    void load(const ofHttpRequest &request) override;
+    // The network time is the replayed duration, the queue time is how late update() delivered the response
+    bool getTiming(int requestID, uint64_t &queueTime, uint64_t &networkTime) override;
+
+private:
+    struct Event {
+        //A request that play() makes, otherwise a response to deliver
+        bool isRequest = false;
+        size_t recordIndex = 0;
+        uint64_t delay = 0;
+        ofHttpResponse response;
+    };
+
+    ofxInstagram &m_Instagram;
+    std::vector<ofxInstagramRecorder::Record> m_Records;
+    std::vector<bool> m_IsRecordUsed;
+    //Unused records by redacted URL and by request name, in the order they were recorded
+    std::unordered_map<std::string, std::deque<size_t>> m_RecordsByURL, m_RecordsByName;
+
+    std::multimap<uint64_t, Event> m_Events;
+    //Queue and network time of the response that is being delivered
+    std::unordered_map<int, std::pair<uint64_t, uint64_t>> m_Timings;
+    double m_Speed;
+    //The record play() is requesting, load() answers with it instead of searching
+    size_t m_PlayingRecord;
+    uint64_t m_ReplayedCount, m_MissingCount;
+
+private:
+    size_t takeRecord(std::deque<size_t> &recordIndices);
+    uint64_t getDelay(uint64_t duration) const;
+};
+
+#endif // OFXINSTAGRAMREPLAYTRANSPORT_H
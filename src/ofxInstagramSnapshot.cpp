@@ -0,0 +1,891 @@
+#include "ofxInstagramSnapshot.h"
+#include "ofxInstagram.h"
+#include "ofLog.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace ofxInstagramTypes;
+
+const uint32_t ofxInstagramSnapshot::VERSION;
+
+namespace
+{
+const char MAGIC[4] = {'I', 'G', 'S', 'S'};
+const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+enum Section {
+    SECTION_STRINGS,
+    SECTION_USERS,
+    SECTION_LOCATIONS,
+    SECTION_COMMENTS,
+    SECTION_POSTS,
+    SECTION_TAGS,
+    SECTION_USER_TAGS,
+    SECTION_INDICES,
+    SECTION_COUNT
+};
+
+//Everything is stored little endian with 8 byte aligned sections, so the records can be read in place on every platform
+//openFrameworks runs on
+struct StringRef {
+    uint32_t offset, length;
+};
+
+struct Range {
+    uint32_t first, count;
+};
+
+struct SectionInfo {
+    uint64_t offset, count;
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t flags;
+    SectionInfo sections[SECTION_COUNT];
+    //Standalone lists, ranges in the index section
+    Range userList, locationList, commentList;
+    StringRef minTagID, nextMaxID, nextMaxTagID, nextMinID, nextURL;
+};
+
+struct UserRecord {
+    StringRef bio, fullName, id, profilePicture, username, website;
+    uint32_t followerCount, followingCount, mediaCount;
+};
+
+struct LocationRecord {
+    StringRef id, name;
+    float latitude, longitude;
+};
+
+struct CommentRecord {
+    StringRef createdTime, id, text;
+    uint32_t from;
+};
+
+struct MediaRecord {
+    StringRef url;
+    uint32_t width, height;
+};
+
+struct UserTagRecord {
+    float x, y;
+    uint32_t user;
+};
+
+struct PostRecord {
+    int64_t createdTimestamp;
+    StringRef captionCreatedTime, captionID, captionText;
+    uint32_t captionFrom;
+    StringRef attribution, createdTime, filter, link, type, id;
+    uint32_t location;
+    //In MediaType order
+    MediaRecord media[6];
+    uint32_t user;
+    uint32_t userHasLiked;
+    uint32_t likeCount, commentCount;
+    //comments is a range in the comment section, the others in the tag, user tag and index sections
+    Range comments, tags, usersInPhoto, likes;
+};
+
+//The layout is the file format, a change here needs a new VERSION
+static_assert(sizeof(StringRef) == 8, "StringRef must be 8 bytes on disk");
+static_assert(sizeof(Range) == 8, "Range must be 8 bytes on disk");
+static_assert(sizeof(SectionInfo) == 16, "SectionInfo must be 16 bytes on disk");
+static_assert(sizeof(Header) == 208, "Header must be 208 bytes on disk");
+static_assert(sizeof(UserRecord) == 60, "UserRecord must be 60 bytes on disk");
+static_assert(sizeof(LocationRecord) == 24, "LocationRecord must be 24 bytes on disk");
+static_assert(sizeof(CommentRecord) == 28, "CommentRecord must be 28 bytes on disk");
+static_assert(sizeof(MediaRecord) == 16, "MediaRecord must be 16 bytes on disk");
+static_assert(sizeof(UserTagRecord) == 12, "UserTagRecord must be 12 bytes on disk");
+static_assert(sizeof(PostRecord) == 232, "PostRecord must be 232 bytes on disk");
+
+const size_t RECORD_SIZES[SECTION_COUNT] = {
+    1, sizeof(UserRecord), sizeof(LocationRecord), sizeof(CommentRecord), sizeof(PostRecord), sizeof(StringRef),
+    sizeof(UserTagRecord), sizeof(uint32_t)
+};
+
+const MediaType MEDIA_TYPES[6] = {
+    MEDIA_IMAGE_THUMBNAIL, MEDIA_IMAGE_LOW_RESOLUTION, MEDIA_IMAGE_STANDARD_RESOLUTION,
+    MEDIA_VIDEO_LOW_BANDWIDTH, MEDIA_VIDEO_LOW_RESOLUTION, MEDIA_VIDEO_STANDARD_RESOLUTION
+};
+
+bool isInSection(const Range &range, size_t count)
+{
+    return static_cast<uint64_t>(range.first) + range.count <= count;
+}
+
+PostMedia &getMedia(PostData &post, MediaType mediaType)
+{
+    return const_cast<PostMedia &>(static_cast<const PostData &>(post).getMedia(mediaType));
+}
+
+//Collects the records in memory and writes them out in one go
+class Builder
+{
+public:
+    Builder()
+    {
+        //Offset 0 is the empty string
+        m_Strings.push_back('\0');
+    }
+
+    StringRef addString(const std::string &value)
+    {
+        StringRef ref = {0, 0};
+        if (value.empty()) {
+            return ref;
+        }
+
+        auto it = m_StringMap.find(value);
+        if (it != m_StringMap.end()) {
+            return it->second;
+        }
+
+        ref.offset = static_cast<uint32_t>(m_Strings.size());
+        ref.length = static_cast<uint32_t>(value.size());
+        m_Strings.append(value);
+        m_Strings.push_back('\0');
+        m_StringMap[value] = ref;
+        return ref;
+    }
+
+    //Users are deduplicated by their contents, the same user can come with more or less detail from different endpoints
+    uint32_t addUser(const UserInfo &user)
+    {
+        const std::string key = user.id + '\x1f' + user.username + '\x1f' + user.fullName + '\x1f' + user.profilePicture + '\x1f' +
+                                user.bio + '\x1f' + user.website + '\x1f' + std::to_string(user.followerCount) + '\x1f' +
+                                std::to_string(user.followingCount) + '\x1f' + std::to_string(user.mediaCount);
+        auto it = m_UserMap.find(key);
+        if (it != m_UserMap.end()) {
+            return it->second;
+        }
+
+        UserRecord record;
+        record.bio = addString(user.bio);
+        record.fullName = addString(user.fullName);
+        record.id = addString(user.id);
+        record.profilePicture = addString(user.profilePicture);
+        record.username = addString(user.username);
+        record.website = addString(user.website);
+        record.followerCount = user.followerCount;
+        record.followingCount = user.followingCount;
+        record.mediaCount = user.mediaCount;
+
+        const uint32_t index = static_cast<uint32_t>(m_Users.size());
+        m_Users.push_back(record);
+        m_UserMap[key] = index;
+        return index;
+    }
+
+    uint32_t addLocation(const Location &location)
+    {
+        //The coordinates are compared bit for bit
+        std::string key = location.id + '\x1f' + location.name + '\x1f';
+        key.append(reinterpret_cast<const char *>(&location.latitude), sizeof(location.latitude));
+        key.append(reinterpret_cast<const char *>(&location.longitude), sizeof(location.longitude));
+        auto it = m_LocationMap.find(key);
+        if (it != m_LocationMap.end()) {
+            return it->second;
+        }
+
+        LocationRecord record;
+        record.id = addString(location.id);
+        record.name = addString(location.name);
+        record.latitude = location.latitude;
+        record.longitude = location.longitude;
+
+        const uint32_t index = static_cast<uint32_t>(m_Locations.size());
+        m_Locations.push_back(record);
+        m_LocationMap[key] = index;
+        return index;
+    }
+
+    uint32_t addComment(const Comment &comment)
+    {
+        CommentRecord record;
+        record.createdTime = addString(comment.createdTime);
+        record.id = addString(comment.id);
+        record.text = addString(comment.text);
+        record.from = addUser(comment.from);
+        m_Comments.push_back(record);
+        return static_cast<uint32_t>(m_Comments.size() - 1);
+    }
+
+    void addPost(const PostData &post)
+    {
+        PostRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.createdTimestamp = post.createdTimestamp;
+        record.captionCreatedTime = addString(post.caption.createdTime);
+        record.captionID = addString(post.caption.id);
+        record.captionText = addString(post.caption.text);
+        record.captionFrom = addUser(post.caption.from);
+        record.attribution = addString(post.attribution);
+        record.createdTime = addString(post.createdTime);
+        record.filter = addString(post.filter);
+        record.link = addString(post.link);
+        record.type = addString(post.type);
+        record.id = addString(post.id);
+
+        const bool hasLocation = post.location.id.length() != 0 || post.location.name.length() != 0 ||
+                                 post.location.latitude != 0.f || post.location.longitude != 0.f;
+        record.location = hasLocation ? addLocation(post.location) : INVALID_INDEX;
+
+        for (int mediaIndex = 0; mediaIndex < 6; mediaIndex++) {
+            const PostMedia &media = post.getMedia(MEDIA_TYPES[mediaIndex]);
+            record.media[mediaIndex].url = addString(media.url);
+            record.media[mediaIndex].width = media.width;
+            record.media[mediaIndex].height = media.height;
+        }
+
+        record.user = addUser(post.user);
+        record.userHasLiked = post.userHasLiked ? 1 : 0;
+        record.likeCount = post.likeCount;
+        record.commentCount = post.commentCount;
+
+        record.comments.first = static_cast<uint32_t>(m_Comments.size());
+        record.comments.count = static_cast<uint32_t>(post.comments.size());
+        for (const Comment &comment : post.comments) {
+            addComment(comment);
+        }
+
+        record.tags.first = static_cast<uint32_t>(m_Tags.size());
+        record.tags.count = static_cast<uint32_t>(post.tags.size());
+        for (const std::string &tag : post.tags) {
+            m_Tags.push_back(addString(tag));
+        }
+
+        record.usersInPhoto.first = static_cast<uint32_t>(m_UserTags.size());
+        record.usersInPhoto.count = static_cast<uint32_t>(post.usersInPhoto.size());
+        for (const auto &userInPhoto : post.usersInPhoto) {
+            UserTagRecord userTag;
+            userTag.x = userInPhoto.first.x;
+            userTag.y = userInPhoto.first.y;
+            userTag.user = addUser(userInPhoto.second);
+            m_UserTags.push_back(userTag);
+        }
+
+        record.likes.first = static_cast<uint32_t>(m_Indices.size());
+        record.likes.count = static_cast<uint32_t>(post.likes.size());
+        for (const UserInfo &user : post.likes) {
+            m_Indices.push_back(addUser(user));
+        }
+
+        m_Posts.push_back(record);
+    }
+
+    template<typename Item, typename Add>
+    Range addList(const std::vector<Item> &items, Add add)
+    {
+        std::vector<uint32_t> indices;
+        for (const Item &item : items) {
+            indices.push_back(add(item));
+        }
+
+        Range range;
+        range.first = static_cast<uint32_t>(m_Indices.size());
+        range.count = static_cast<uint32_t>(indices.size());
+        m_Indices.insert(m_Indices.end(), indices.begin(), indices.end());
+        return range;
+    }
+
+    bool write(const std::string &path, const Posts &posts, const std::vector<UserInfo> &users, const std::vector<Location> &locations,
+               const std::vector<Comment> &comments)
+    {
+        for (const PostData &post : posts.first) {
+            addPost(post);
+        }
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = ofxInstagramSnapshot::VERSION;
+        header.headerSize = sizeof(Header);
+        header.userList = addList(users, [this](const UserInfo & user) {
+            return addUser(user);
+        });
+        header.locationList = addList(locations, [this](const Location & location) {
+            return addLocation(location);
+        });
+        header.commentList = addList(comments, [this](const Comment & comment) {
+            return addComment(comment);
+        });
+        header.minTagID = addString(posts.second.minTagID);
+        header.nextMaxID = addString(posts.second.nextMaxID);
+        header.nextMaxTagID = addString(posts.second.nextMaxTagID);
+        header.nextMinID = addString(posts.second.nextMinID);
+        header.nextURL = addString(posts.second.nextURL);
+
+        const std::pair<const void *, size_t> sections[SECTION_COUNT] = {
+            {m_Strings.data(), m_Strings.size()},
+            {m_Users.data(), m_Users.size()},
+            {m_Locations.data(), m_Locations.size()},
+            {m_Comments.data(), m_Comments.size()},
+            {m_Posts.data(), m_Posts.size()},
+            {m_Tags.data(), m_Tags.size()},
+            {m_UserTags.data(), m_UserTags.size()},
+            {m_Indices.data(), m_Indices.size()}
+        };
+
+        uint64_t offset = sizeof(Header);
+        for (int section = 0; section < SECTION_COUNT; section++) {
+            offset = (offset + 7) & ~static_cast<uint64_t>(7);
+            header.sections[section].offset = offset;
+            header.sections[section].count = sections[section].second;
+            offset += sections[section].second * RECORD_SIZES[section];
+        }
+
+        const std::string temporaryPath = path + ".tmp";
+        std::ofstream file(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (file.is_open() == false) {
+            ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": Could not write " << temporaryPath;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        const char padding[8] = {0};
+        for (int section = 0; section < SECTION_COUNT; section++) {
+            file.write(padding, header.sections[section].offset - file.tellp());
+            file.write(static_cast<const char *>(sections[section].first), sections[section].second * RECORD_SIZES[section]);
+        }
+
+        file.close();
+        if (file.fail()) {
+            ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": Could not write " << temporaryPath;
+            return false;
+        }
+
+        //Replace the old snapshot in one step, there is never a moment without a file at path
+#ifdef _WIN32
+        return MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+    }
+
+private:
+    std::string m_Strings;
+    std::unordered_map<std::string, StringRef> m_StringMap;
+
+    std::vector<UserRecord> m_Users;
+    std::unordered_map<std::string, uint32_t> m_UserMap;
+    std::vector<LocationRecord> m_Locations;
+    std::unordered_map<std::string, uint32_t> m_LocationMap;
+    std::vector<CommentRecord> m_Comments;
+    std::vector<PostRecord> m_Posts;
+    std::vector<StringRef> m_Tags;
+    std::vector<UserTagRecord> m_UserTags;
+    std::vector<uint32_t> m_Indices;
+};
+
+void collectResponse(const ofxInstagram &decoder, const ofxJSONElement &json, Posts &posts, std::vector<UserInfo> &users,
+                     std::vector<Location> &locations, std::vector<Comment> &comments)
+{
+    const ofxJSONElement data = json["data"];
+    if (data.isArray() == false) {
+        //Single object responses, such as media or user info
+        if (data.isObject()) {
+            ofxJSONElement wrapped;
+            wrapped["data"].append(data);
+            collectResponse(decoder, wrapped, posts, users, locations, comments);
+        }
+
+        return;
+    }
+
+    for (unsigned int index = 0; index < data.size(); index++) {
+        const ofxJSONElement item = data[index];
+        if (item.isMember("images") || item.isMember("type")) {
+            posts.first.push_back(decoder.constructPostData(item));
+        }
+        else if (item.isMember("text") && item.isMember("from")) {
+            ofxJSONElement commentsJson;
+            commentsJson.append(item);
+            std::vector<Comment> decoded = decoder.constructComments(commentsJson);
+            comments.insert(comments.end(), decoded.begin(), decoded.end());
+        }
+        else if (item.isMember("username")) {
+            users.push_back(decoder.constructUserInfo(item));
+        }
+        else if (item.isMember("media_count")) {
+            //Tags, the snapshot has no section for them
+        }
+        else if (item.isMember("latitude") || item.isMember("name")) {
+            locations.push_back(decoder.constructLocation(item));
+        }
+    }
+
+    if (json.isMember("pagination")) {
+        posts.second = decoder.constructPagination(json["pagination"]);
+    }
+}
+}
+
+std::string ofxInstagramSnapshot::StringView::toString() const
+{
+    return std::string(data != nullptr ? data : "", length);
+}
+
+bool ofxInstagramSnapshot::StringView::operator==(const std::string &other) const
+{
+    return other.size() == length && (length == 0 || std::memcmp(other.data(), data, length) == 0);
+}
+
+ofxInstagramSnapshot::ofxInstagramSnapshot()
+    : m_Data(nullptr)
+    , m_Size(0)
+#ifdef _WIN32
+    , m_File(INVALID_HANDLE_VALUE)
+    , m_Mapping(nullptr)
+#else
+    , m_File(-1)
+#endif
+{
+
+}
+
+ofxInstagramSnapshot::~ofxInstagramSnapshot()
+{
+    close();
+}
+
+bool ofxInstagramSnapshot::save(const std::string &path, const Posts &posts, const std::vector<UserInfo> &users,
+                                const std::vector<Location> &locations, const std::vector<Comment> &comments)
+{
+    Builder builder;
+    return builder.write(path, posts, users, locations, comments);
+}
+
+bool ofxInstagramSnapshot::convertJSON(const std::string &jsonPath, const std::string &snapshotPath)
+{
+    ofxJSONElement json;
+    if (json.open(jsonPath) == false) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": Could not parse " << jsonPath;
+        return false;
+    }
+
+    //Only used for its decoding functions, it is never set up
+    const ofxInstagram decoder;
+    Posts posts;
+    std::vector<UserInfo> users;
+    std::vector<Location> locations;
+    std::vector<Comment> comments;
+    if (json.isArray()) {
+        for (unsigned int index = 0; index < json.size(); index++) {
+            collectResponse(decoder, json[index], posts, users, locations, comments);
+        }
+    }
+    else {
+        collectResponse(decoder, json, posts, users, locations, comments);
+    }
+
+    return save(snapshotPath, posts, users, locations, comments);
+}
+
+bool ofxInstagramSnapshot::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (m_File == INVALID_HANDLE_VALUE || GetFileSizeEx(m_File, &fileSize) == FALSE) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": Could not open " << path;
+        close();
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(fileSize.QuadPart);
+    m_Mapping = m_Size != 0 ? CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    m_Data = m_Mapping != nullptr ? static_cast<const unsigned char *>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+    m_File = ::open(path.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (m_File < 0 || fstat(m_File, &fileStat) != 0) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": Could not open " << path;
+        close();
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(fileStat.st_size);
+    void *data = m_Size != 0 ? mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0) : MAP_FAILED;
+    m_Data = data != MAP_FAILED ? static_cast<const unsigned char *>(data) : nullptr;
+#endif
+
+    if (m_Data == nullptr || m_Size < sizeof(Header)) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": " << path << " is not a snapshot";
+        close();
+        return false;
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(m_Data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->headerSize != sizeof(Header)) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": " << path << " is not a snapshot";
+        close();
+        return false;
+    }
+
+    if (header->version != VERSION) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": " << path << " is version " << header->version << ", expected " << VERSION;
+        close();
+        return false;
+    }
+
+    //The only validation up front, the record fields are checked when they are read
+    for (int section = 0; section < SECTION_COUNT; section++) {
+        const SectionInfo &info = header->sections[section];
+        if (info.offset % 8 != 0 || info.offset > m_Size || info.count > (m_Size - info.offset) / RECORD_SIZES[section]) {
+            ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": " << path << " is truncated";
+            close();
+            return false;
+        }
+    }
+
+    size_t indexCount = getCount(SECTION_INDICES);
+    if (isInSection(header->userList, indexCount) == false || isInSection(header->locationList, indexCount) == false ||
+        isInSection(header->commentList, indexCount) == false) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": " << path << " is truncated";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void ofxInstagramSnapshot::close()
+{
+#ifdef _WIN32
+    if (m_Data != nullptr) {
+        UnmapViewOfFile(m_Data);
+    }
+
+    if (m_Mapping != nullptr) {
+        CloseHandle(m_Mapping);
+    }
+
+    if (m_File != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_File);
+    }
+
+    m_Mapping = nullptr;
+    m_File = INVALID_HANDLE_VALUE;
+#else
+    if (m_Data != nullptr) {
+        munmap(const_cast<unsigned char *>(m_Data), m_Size);
+    }
+
+    if (m_File >= 0) {
+        ::close(m_File);
+    }
+
+    m_File = -1;
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+bool ofxInstagramSnapshot::isOpen() const
+{
+    return m_Data != nullptr;
+}
+
+size_t ofxInstagramSnapshot::getPostCount() const
+{
+    return getCount(SECTION_POSTS);
+}
+
+PostData ofxInstagramSnapshot::getPost(size_t index) const
+{
+    PostData post;
+    const PostRecord *record = getRecord<PostRecord>(SECTION_POSTS, static_cast<uint32_t>(index));
+    if (record == nullptr) {
+        return post;
+    }
+
+    post.createdTimestamp = static_cast<std::time_t>(record->createdTimestamp);
+    post.caption.createdTime = getString(&record->captionCreatedTime).toString();
+    post.caption.id = getString(&record->captionID).toString();
+    post.caption.text = getString(&record->captionText).toString();
+    post.caption.from = decodeUser(record->captionFrom);
+    post.attribution = getString(&record->attribution).toString();
+    post.createdTime = getString(&record->createdTime).toString();
+    post.filter = getString(&record->filter).toString();
+    post.link = getString(&record->link).toString();
+    post.type = getString(&record->type).toString();
+    post.id = getString(&record->id).toString();
+    if (record->location != INVALID_INDEX) {
+        post.location = decodeLocation(record->location);
+    }
+
+    for (int mediaIndex = 0; mediaIndex < 6; mediaIndex++) {
+        PostMedia &media = getMedia(post, MEDIA_TYPES[mediaIndex]);
+        media.url = getString(&record->media[mediaIndex].url).toString();
+        media.width = record->media[mediaIndex].width;
+        media.height = record->media[mediaIndex].height;
+    }
+
+    post.user = decodeUser(record->user);
+    post.userHasLiked = record->userHasLiked != 0;
+    post.likeCount = record->likeCount;
+    post.commentCount = record->commentCount;
+
+    //The counts come from the file, a corrupt range must not turn into a huge reserve()
+    if (isInSection(record->comments, getCount(SECTION_COMMENTS)) == false || isInSection(record->tags, getCount(SECTION_TAGS)) == false ||
+        isInSection(record->usersInPhoto, getCount(SECTION_USER_TAGS)) == false || isInSection(record->likes, getCount(SECTION_INDICES)) == false) {
+        ofLogError("ofxInstagramSnapshot") << __FUNCTION__ << ": Post " << index << " has a list outside its section";
+        return post;
+    }
+
+    post.comments.reserve(record->comments.count);
+    for (uint32_t offset = 0; offset < record->comments.count; offset++) {
+        post.comments.push_back(decodeComment(record->comments.first + offset));
+    }
+
+    post.tags.reserve(record->tags.count);
+    for (uint32_t offset = 0; offset < record->tags.count; offset++) {
+        const StringRef *tag = getRecord<StringRef>(SECTION_TAGS, record->tags.first + offset);
+        if (tag != nullptr) {
+            post.tags.push_back(getString(tag).toString());
+        }
+    }
+
+    for (uint32_t offset = 0; offset < record->usersInPhoto.count; offset++) {
+        const UserTagRecord *userTag = getRecord<UserTagRecord>(SECTION_USER_TAGS, record->usersInPhoto.first + offset);
+        if (userTag != nullptr) {
+            Position position;
+            position.x = userTag->x;
+            position.y = userTag->y;
+            post.usersInPhoto.push_back(std::make_pair(position, decodeUser(userTag->user)));
+        }
+    }
+
+    post.likes.reserve(record->likes.count);
+    for (uint32_t offset = 0; offset < record->likes.count; offset++) {
+        post.likes.push_back(decodeUser(getListIndex(record->likes.first + offset)));
+    }
+
+    return post;
+}
+
+Posts ofxInstagramSnapshot::getPosts() const
+{
+    Posts posts;
+    posts.first.reserve(getPostCount());
+    for (size_t index = 0; index < getPostCount(); index++) {
+        posts.first.push_back(getPost(index));
+    }
+
+    posts.second = getPagination();
+    return posts;
+}
+
+ofxInstagramSnapshot::StringView ofxInstagramSnapshot::getPostID(size_t index) const
+{
+    const PostRecord *record = getRecord<PostRecord>(SECTION_POSTS, static_cast<uint32_t>(index));
+    return record != nullptr ? getString(&record->id) : StringView();
+}
+
+std::time_t ofxInstagramSnapshot::getPostTimestamp(size_t index) const
+{
+    const PostRecord *record = getRecord<PostRecord>(SECTION_POSTS, static_cast<uint32_t>(index));
+    return record != nullptr ? static_cast<std::time_t>(record->createdTimestamp) : 0;
+}
+
+unsigned int ofxInstagramSnapshot::getPostLikeCount(size_t index) const
+{
+    const PostRecord *record = getRecord<PostRecord>(SECTION_POSTS, static_cast<uint32_t>(index));
+    return record != nullptr ? record->likeCount : 0;
+}
+
+size_t ofxInstagramSnapshot::getUserCount() const
+{
+    return isOpen() ? reinterpret_cast<const Header *>(m_Data)->userList.count : 0;
+}
+
+UserInfo ofxInstagramSnapshot::getUser(size_t index) const
+{
+    if (index >= getUserCount()) {
+        return UserInfo();
+    }
+
+    return decodeUser(getListIndex(reinterpret_cast<const Header *>(m_Data)->userList.first + static_cast<uint32_t>(index)));
+}
+
+std::vector<UserInfo> ofxInstagramSnapshot::getUsers() const
+{
+    std::vector<UserInfo> users;
+    for (size_t index = 0; index < getUserCount(); index++) {
+        users.push_back(getUser(index));
+    }
+
+    return users;
+}
+
+size_t ofxInstagramSnapshot::getLocationCount() const
+{
+    return isOpen() ? reinterpret_cast<const Header *>(m_Data)->locationList.count : 0;
+}
+
+Location ofxInstagramSnapshot::getLocation(size_t index) const
+{
+    if (index >= getLocationCount()) {
+        return Location();
+    }
+
+    return decodeLocation(getListIndex(reinterpret_cast<const Header *>(m_Data)->locationList.first + static_cast<uint32_t>(index)));
+}
+
+std::vector<Location> ofxInstagramSnapshot::getLocations() const
+{
+    std::vector<Location> locations;
+    for (size_t index = 0; index < getLocationCount(); index++) {
+        locations.push_back(getLocation(index));
+    }
+
+    return locations;
+}
+
+size_t ofxInstagramSnapshot::getCommentCount() const
+{
+    return isOpen() ? reinterpret_cast<const Header *>(m_Data)->commentList.count : 0;
+}
+
+Comment ofxInstagramSnapshot::getComment(size_t index) const
+{
+    if (index >= getCommentCount()) {
+        return Comment();
+    }
+
+    return decodeComment(getListIndex(reinterpret_cast<const Header *>(m_Data)->commentList.first + static_cast<uint32_t>(index)));
+}
+
+std::vector<Comment> ofxInstagramSnapshot::getComments() const
+{
+    std::vector<Comment> comments;
+    for (size_t index = 0; index < getCommentCount(); index++) {
+        comments.push_back(getComment(index));
+    }
+
+    return comments;
+}
+
+Pagination ofxInstagramSnapshot::getPagination() const
+{
+    Pagination pagination;
+    if (isOpen() == false) {
+        return pagination;
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(m_Data);
+    pagination.minTagID = getString(&header->minTagID).toString();
+    pagination.nextMaxID = getString(&header->nextMaxID).toString();
+    pagination.nextMaxTagID = getString(&header->nextMaxTagID).toString();
+    pagination.nextMinID = getString(&header->nextMinID).toString();
+    pagination.nextURL = getString(&header->nextURL).toString();
+    return pagination;
+}
+
+template<typename Record>
+const Record *ofxInstagramSnapshot::getRecords(int section) const
+{
+    return reinterpret_cast<const Record *>(m_Data + reinterpret_cast<const Header *>(m_Data)->sections[section].offset);
+}
+
+template<typename Record>
+const Record *ofxInstagramSnapshot::getRecord(int section, uint32_t index) const
+{
+    if (index >= getCount(section)) {
+        return nullptr;
+    }
+
+    return getRecords<Record>(section) + index;
+}
+
+size_t ofxInstagramSnapshot::getCount(int section) const
+{
+    return isOpen() ? static_cast<size_t>(reinterpret_cast<const Header *>(m_Data)->sections[section].count) : 0;
+}
+
+ofxInstagramSnapshot::StringView ofxInstagramSnapshot::getString(const void *stringRef) const
+{
+    const StringRef *ref = static_cast<const StringRef *>(stringRef);
+    StringView view;
+    if (ref->length == 0 || static_cast<uint64_t>(ref->offset) + ref->length > getCount(SECTION_STRINGS)) {
+        return view;
+    }
+
+    view.data = getRecords<char>(SECTION_STRINGS) + ref->offset;
+    view.length = ref->length;
+    return view;
+}
+
+UserInfo ofxInstagramSnapshot::decodeUser(uint32_t index) const
+{
+    UserInfo user;
+    const UserRecord *record = getRecord<UserRecord>(SECTION_USERS, index);
+    if (record == nullptr) {
+        return user;
+    }
+
+    user.bio = getString(&record->bio).toString();
+    user.fullName = getString(&record->fullName).toString();
+    user.id = getString(&record->id).toString();
+    user.profilePicture = getString(&record->profilePicture).toString();
+    user.username = getString(&record->username).toString();
+    user.website = getString(&record->website).toString();
+    user.followerCount = record->followerCount;
+    user.followingCount = record->followingCount;
+    user.mediaCount = record->mediaCount;
+    return user;
+}
+
+Location ofxInstagramSnapshot::decodeLocation(uint32_t index) const
+{
+    Location location;
+    const LocationRecord *record = getRecord<LocationRecord>(SECTION_LOCATIONS, index);
+    if (record == nullptr) {
+        return location;
+    }
+
+    location.id = getString(&record->id).toString();
+    location.name = getString(&record->name).toString();
+    location.latitude = record->latitude;
+    location.longitude = record->longitude;
+    return location;
+}
+
+Comment ofxInstagramSnapshot::decodeComment(uint32_t index) const
+{
+    Comment comment;
+    const CommentRecord *record = getRecord<CommentRecord>(SECTION_COMMENTS, index);
+    if (record == nullptr) {
+        return comment;
+    }
+
+    comment.createdTime = getString(&record->createdTime).toString();
+    comment.id = getString(&record->id).toString();
+    comment.text = getString(&record->text).toString();
+    comment.from = decodeUser(record->from);
+    return comment;
+}
+
+uint32_t ofxInstagramSnapshot::getListIndex(uint32_t position) const
+{
+    const uint32_t *index = getRecord<uint32_t>(SECTION_INDICES, position);
+    return index != nullptr ? *index : INVALID_INDEX;
+}
@@ -0,0 +1,90 @@
+#ifndef OFXINSTAGRAMSNAPSHOT_H
+#define OFXINSTAGRAMSNAPSHOT_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ofxInstagramTypes.h"
+
+// Versioned binary archive of posts, users, locations and comments. The file is a header followed by tables of fixed size
+// records that refer to each other by index and to a shared, deduplicated string table. It is memory mapped when opened,
+// so opening only checks the header and a record is decoded when it is asked for. Use convertJSON() to turn saved API
+// responses into a snapshot.
+class ofxInstagramSnapshot
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    // Points into the mapped file, valid until the snapshot is closed
+    struct StringView {
+        const char *data = nullptr;
+        size_t length = 0;
+
+        std::string toString() const;
+        bool operator==(const std::string &other) const;
+    };
+
+public:
+    ofxInstagramSnapshot();
+    ~ofxInstagramSnapshot();
+
+    // The users, locations and comments are standalone lists, such as the results of a user or location search. Users,
+    // locations and comments that are part of the posts are always stored with them.
+    static bool save(const std::string &path, const ofxInstagramTypes::Posts &posts,
+                     const std::vector<ofxInstagramTypes::UserInfo> &users = std::vector<ofxInstagramTypes::UserInfo>(),
+                     const std::vector<ofxInstagramTypes::Location> &locations = std::vector<ofxInstagramTypes::Location>(),
+                     const std::vector<ofxInstagramTypes::Comment> &comments = std::vector<ofxInstagramTypes::Comment>());
+
+    // Converts a JSON file with an API response, or an array of responses, into a snapshot. The entries of the "data"
+    // arrays are sorted into posts, users, locations and comments by their fields.
+    static bool convertJSON(const std::string &jsonPath, const std::string &snapshotPath);
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+
+    size_t getPostCount() const;
+    ofxInstagramTypes::PostData getPost(size_t index) const;
+    ofxInstagramTypes::Posts getPosts() const;
+    // Read straight from the file without decoding the post, for scanning large archives
+    StringView getPostID(size_t index) const;
+    std::time_t getPostTimestamp(size_t index) const;
+    unsigned int getPostLikeCount(size_t index) const;
+
+    size_t getUserCount() const;
+    ofxInstagramTypes::UserInfo getUser(size_t index) const;
+    std::vector<ofxInstagramTypes::UserInfo> getUsers() const;
+
+    size_t getLocationCount() const;
+    ofxInstagramTypes::Location getLocation(size_t index) const;
+    std::vector<ofxInstagramTypes::Location> getLocations() const;
+
+    size_t getCommentCount() const;
+    ofxInstagramTypes::Comment getComment(size_t index) const;
+    std::vector<ofxInstagramTypes::Comment> getComments() const;
+
+    ofxInstagramTypes::Pagination getPagination() const;
+
+private:
+    const unsigned char *m_Data;
+    size_t m_Size;
+#ifdef _WIN32
+    void *m_File, *m_Mapping;
+#else
+    int m_File;
+#endif
+
+private:
+    template<typename Record>
+    const Record *getRecords(int section) const;
+    template<typename Record>
+    const Record *getRecord(int section, uint32_t index) const;
+    size_t getCount(int section) const;
+
+    StringView getString(const void *stringRef) const;
+    ofxInstagramTypes::UserInfo decodeUser(uint32_t index) const;
+    ofxInstagramTypes::Location decodeLocation(uint32_t index) const;
+    ofxInstagramTypes::Comment decodeComment(uint32_t index) const;
+    uint32_t getListIndex(uint32_t position) const;
+};
+
+#endif // OFXINSTAGRAMSNAPSHOT_H
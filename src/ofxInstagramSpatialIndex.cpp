@@ -0,0 +1,421 @@
+#include "ofxInstagramSpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+const double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180.0;
+const double EARTH_RADIUS = 6371008.8;
+const double METERS_PER_DEGREE = EARTH_RADIUS * RADIANS_PER_DEGREE;
+//Location IDs are numeric, so the keys of locations without an ID cannot collide with them
+const std::string POST_LOCATION_PREFIX = "media:";
+
+double toRadians(double degrees)
+{
+    return degrees * RADIANS_PER_DEGREE;
+}
+}
+
+ofxInstagramSpatialIndex::ofxInstagramSpatialIndex(double cellSize)
+    : m_LocationGrid(cellSize)
+    , m_PostGrid(cellSize)
+    , m_PostCount(0)
+{
+
+}
+
+void ofxInstagramSpatialIndex::addLocation(const Location &location)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    insertLocation(location, location.id);
+}
+
+void ofxInstagramSpatialIndex::insertLocation(const Location &location, const std::string &key)
+{
+    if (hasCoordinates(location) == false) {
+        return;
+    }
+
+    if (key.length() != 0) {
+        auto it = m_LocationItems.find(key);
+        if (it != m_LocationItems.end()) {
+            Location &existing = m_Locations[it->second];
+            m_LocationGrid.remove(existing.latitude, existing.longitude, it->second);
+            existing = location;
+            m_LocationGrid.add(location.latitude, location.longitude, it->second);
+            return;
+        }
+    }
+
+    uint32_t item = static_cast<uint32_t>(m_Locations.size());
+    if (m_FreeLocationItems.empty()) {
+        m_Locations.push_back(location);
+    }
+    else {
+        item = m_FreeLocationItems.back();
+        m_FreeLocationItems.pop_back();
+        m_Locations[item] = location;
+    }
+
+    if (key.length() != 0) {
+        m_LocationItems.insert(std::make_pair(key, item));
+    }
+
+    m_LocationGrid.add(location.latitude, location.longitude, item);
+}
+
+void ofxInstagramSpatialIndex::eraseLocation(const std::string &key)
+{
+    auto it = m_LocationItems.find(key);
+    if (it == m_LocationItems.end()) {
+        return;
+    }
+
+    const Location &location = m_Locations[it->second];
+    m_LocationGrid.remove(location.latitude, location.longitude, it->second);
+    m_Locations[it->second] = Location();
+    m_FreeLocationItems.push_back(it->second);
+    m_LocationItems.erase(it);
+}
+
+void ofxInstagramSpatialIndex::addLocations(const std::vector<Location> &locations)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const Location &location : locations) {
+        insertLocation(location, location.id);
+    }
+}
+
+void ofxInstagramSpatialIndex::addPost(const PostHandle &post)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    insertPost(post);
+}
+
+bool ofxInstagramSpatialIndex::removePost(const std::string &mediaID)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return erasePost(mediaID);
+}
+
+void ofxInstagramSpatialIndex::insertPost(const PostHandle &post)
+{
+    if (!post) {
+        return;
+    }
+
+    if (hasCoordinates(post->location) == false) {
+        erasePost(post->id);
+        return;
+    }
+
+    //Repeated posts of a location without an ID would otherwise add a new location every time
+    if (post->location.id.length() != 0) {
+        insertLocation(post->location, post->location.id);
+        //The location may have had no ID the last time the post was added
+        eraseLocation(POST_LOCATION_PREFIX + post->id);
+    }
+    else {
+        insertLocation(post->location, POST_LOCATION_PREFIX + post->id);
+    }
+
+    auto it = m_PostItems.find(post->id);
+    if (it != m_PostItems.end()) {
+        Location &previous = m_PostLocations[it->second];
+        m_PostGrid.remove(previous.latitude, previous.longitude, it->second);
+        previous = post->location;
+        m_Posts[it->second] = post;
+        m_PostGrid.add(previous.latitude, previous.longitude, it->second);
+        return;
+    }
+
+    uint32_t item = static_cast<uint32_t>(m_Posts.size());
+    if (m_FreePostItems.empty()) {
+        m_Posts.push_back(post);
+        m_PostLocations.push_back(post->location);
+    }
+    else {
+        item = m_FreePostItems.back();
+        m_FreePostItems.pop_back();
+        m_Posts[item] = post;
+        m_PostLocations[item] = post->location;
+    }
+
+    m_PostItems.insert(std::make_pair(post->id, item));
+    m_PostGrid.add(post->location.latitude, post->location.longitude, item);
+    m_PostCount++;
+}
+
+bool ofxInstagramSpatialIndex::erasePost(const std::string &mediaID)
+{
+    auto it = m_PostItems.find(mediaID);
+    if (it == m_PostItems.end()) {
+        return false;
+    }
+
+    Location &location = m_PostLocations[it->second];
+    m_PostGrid.remove(location.latitude, location.longitude, it->second);
+    //The location that was keyed by the post goes with it
+    if (location.id.length() == 0) {
+        eraseLocation(POST_LOCATION_PREFIX + mediaID);
+    }
+
+    location = Location();
+    m_Posts[it->second] = nullptr;
+    m_FreePostItems.push_back(it->second);
+    m_PostItems.erase(it);
+    m_PostCount--;
+    return true;
+}
+
+void ofxInstagramSpatialIndex::attach(ofxInstagramPostStore &store)
+{
+    //Replayed, so no post merged in while attaching is missed. The subscription is released with the index, so the store
+    //never calls into a destroyed index.
+    m_Subscription = store.subscribeScoped([this](const ofxInstagramPostStore::Delta & delta) {
+        apply(delta);
+    }, true);
+}
+
+void ofxInstagramSpatialIndex::detach()
+{
+    m_Subscription.reset();
+}
+
+void ofxInstagramSpatialIndex::clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_LocationGrid.clear();
+    m_PostGrid.clear();
+    m_Locations.clear();
+    m_LocationItems.clear();
+    m_FreeLocationItems.clear();
+    m_Posts.clear();
+    m_PostLocations.clear();
+    m_PostItems.clear();
+    m_FreePostItems.clear();
+    m_PostCount = 0;
+}
+
+std::vector<Location> ofxInstagramSpatialIndex::findLocationsInRadius(double latitude, double longitude, double radius) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<uint32_t> items;
+    m_LocationGrid.findInRadius(latitude, longitude, radius, items);
+
+    std::vector<Location> locations;
+    locations.reserve(items.size());
+    for (uint32_t item : items) {
+        locations.push_back(m_Locations[item]);
+    }
+
+    return locations;
+}
+
+std::vector<PostHandle> ofxInstagramSpatialIndex::findPostsInRadius(double latitude, double longitude, double radius) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<uint32_t> items;
+    m_PostGrid.findInRadius(latitude, longitude, radius, items);
+
+    std::vector<PostHandle> posts;
+    posts.reserve(items.size());
+    for (uint32_t item : items) {
+        if (m_Posts[item]) {
+            posts.push_back(m_Posts[item]);
+        }
+    }
+
+    return posts;
+}
+
+std::vector<Location> ofxInstagramSpatialIndex::findLocationsInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<uint32_t> items;
+    m_LocationGrid.findInBounds(minLatitude, minLongitude, maxLatitude, maxLongitude, items);
+
+    std::vector<Location> locations;
+    locations.reserve(items.size());
+    for (uint32_t item : items) {
+        locations.push_back(m_Locations[item]);
+    }
+
+    return locations;
+}
+
+std::vector<PostHandle> ofxInstagramSpatialIndex::findPostsInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<uint32_t> items;
+    m_PostGrid.findInBounds(minLatitude, minLongitude, maxLatitude, maxLongitude, items);
+
+    std::vector<PostHandle> posts;
+    posts.reserve(items.size());
+    for (uint32_t item : items) {
+        if (m_Posts[item]) {
+            posts.push_back(m_Posts[item]);
+        }
+    }
+
+    return posts;
+}
+
+size_t ofxInstagramSpatialIndex::getLocationCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Locations.size() - m_FreeLocationItems.size();
+}
+
+size_t ofxInstagramSpatialIndex::getPostCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_PostCount;
+}
+
+void ofxInstagramSpatialIndex::apply(const ofxInstagramPostStore::Delta &delta)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (delta.isRemoved) {
+        erasePost(delta.post->id);
+    }
+    else if (delta.isNew || delta.locationChanged) {
+        insertPost(delta.post);
+    }
+    else {
+        //The store replaced the record, keep handing out the current one
+        auto it = m_PostItems.find(delta.post->id);
+        if (it != m_PostItems.end()) {
+            m_Posts[it->second] = delta.post;
+        }
+    }
+}
+
+bool ofxInstagramSpatialIndex::hasCoordinates(const Location &location)
+{
+    // The API leaves both coordinates at zero for posts without a location
+    return location.latitude != 0.f || location.longitude != 0.f;
+}
+
+double ofxInstagramSpatialIndex::distance(double latitudeA, double longitudeA, double latitudeB, double longitudeB)
+{
+    const double deltaLatitude = toRadians(latitudeB - latitudeA);
+    const double deltaLongitude = toRadians(longitudeB - longitudeA);
+    const double a = std::sin(deltaLatitude / 2) * std::sin(deltaLatitude / 2) +
+                     std::cos(toRadians(latitudeA)) * std::cos(toRadians(latitudeB)) * std::sin(deltaLongitude / 2) * std::sin(deltaLongitude / 2);
+    return 2 * EARTH_RADIUS * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+// *                        GRID
+// *  Cells are keyed by their latitude and longitude cell indices packed into 64 bits.
+// *  Longitudes do not wrap around the antimeridian.
+
+ofxInstagramSpatialIndex::Grid::Grid(double cellSize)
+    : m_CellSize(cellSize)
+{
+
+}
+
+void ofxInstagramSpatialIndex::Grid::add(float latitude, float longitude, uint32_t item)
+{
+    Point point;
+    point.latitude = latitude;
+    point.longitude = longitude;
+    point.item = item;
+    m_Cells[cellKey(toCell(latitude), toCell(longitude))].push_back(point);
+}
+
+void ofxInstagramSpatialIndex::Grid::remove(float latitude, float longitude, uint32_t item)
+{
+    auto it = m_Cells.find(cellKey(toCell(latitude), toCell(longitude)));
+    if (it == m_Cells.end()) {
+        return;
+    }
+
+    std::vector<Point> &points = it->second;
+    auto pointIt = std::find_if(points.begin(), points.end(), [item](const Point & point) {
+        return point.item == item;
+    });
+
+    if (pointIt != points.end()) {
+        *pointIt = points.back();
+        points.pop_back();
+    }
+
+    if (points.empty()) {
+        m_Cells.erase(it);
+    }
+}
+
+void ofxInstagramSpatialIndex::Grid::clear()
+{
+    m_Cells.clear();
+}
+
+void ofxInstagramSpatialIndex::Grid::findInRadius(double latitude, double longitude, double radius, std::vector<uint32_t> &items) const
+{
+    const double latitudeSpan = radius / METERS_PER_DEGREE;
+    const double longitudeSpan = radius / (METERS_PER_DEGREE * std::max(std::cos(toRadians(latitude)), 1e-6));
+
+    // The bounding box of the circle rejects most points, only the ones inside it get the exact distance check
+    forEachPointInBounds(latitude - latitudeSpan, longitude - longitudeSpan, latitude + latitudeSpan, longitude + longitudeSpan,
+    [&](const Point & point) {
+        if (distance(latitude, longitude, point.latitude, point.longitude) <= radius) {
+            items.push_back(point.item);
+        }
+    });
+}
+
+void ofxInstagramSpatialIndex::Grid::findInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+        std::vector<uint32_t> &items) const
+{
+    forEachPointInBounds(minLatitude, minLongitude, maxLatitude, maxLongitude, [&items](const Point & point) {
+        items.push_back(point.item);
+    });
+}
+
+template<typename Function>
+void ofxInstagramSpatialIndex::Grid::forEachPointInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+        Function function) const
+{
+    const int minLatitudeCell = toCell(minLatitude), maxLatitudeCell = toCell(maxLatitude);
+    const int minLongitudeCell = toCell(minLongitude), maxLongitudeCell = toCell(maxLongitude);
+
+    auto visit = [&](const std::vector<Point> &points) {
+        for (const Point &point : points) {
+            if (point.latitude >= minLatitude && point.latitude <= maxLatitude && point.longitude >= minLongitude && point.longitude <= maxLongitude) {
+                function(point);
+            }
+        }
+    };
+
+    const double cellCount = (static_cast<double>(maxLatitudeCell) - minLatitudeCell + 1) * (static_cast<double>(maxLongitudeCell) - minLongitudeCell + 1);
+    if (cellCount > static_cast<double>(m_Cells.size())) {
+        // Large areas cover more cells than are populated, walk the populated ones instead
+        for (const auto &cell : m_Cells) {
+            visit(cell.second);
+        }
+
+        return;
+    }
+
+    for (int latitudeCell = minLatitudeCell; latitudeCell <= maxLatitudeCell; latitudeCell++) {
+        for (int longitudeCell = minLongitudeCell; longitudeCell <= maxLongitudeCell; longitudeCell++) {
+            auto it = m_Cells.find(cellKey(latitudeCell, longitudeCell));
+            if (it != m_Cells.end()) {
+                visit(it->second);
+            }
+        }
+    }
+}
+
+int ofxInstagramSpatialIndex::Grid::toCell(double degrees) const
+{
+    return static_cast<int>(std::floor(degrees / m_CellSize));
+}
+
+uint64_t ofxInstagramSpatialIndex::Grid::cellKey(int latitudeCell, int longitudeCell) const
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(latitudeCell)) << 32) | static_cast<uint32_t>(longitudeCell);
+}
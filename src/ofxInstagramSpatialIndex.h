@@ -0,0 +1,109 @@
+#ifndef OFXINSTAGRAMSPATIALINDEX_H
+#define OFXINSTAGRAMSPATIALINDEX_H
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ofxInstagramTypes.h"
+#include "ofxInstagramPostStore.h"
+
+// Local spatial index over the locations and geotagged posts seen so far. Points are bucketed into a uniform
+// latitude/longitude grid so radius and bounding box queries only look at the cells they overlap. It can be queried from
+// any thread while it is updated by its store.
+class ofxInstagramSpatialIndex
+{
+public:
+    // cellSize is in degrees, the default is roughly 1km at the equator
+    ofxInstagramSpatialIndex(double cellSize = 0.01);
+
+    void addLocation(const ofxInstagramTypes::Location &location);
+    void addLocations(const std::vector<ofxInstagramTypes::Location> &locations);
+
+    // Posts without a location are ignored. Adding a post again moves it if its location changed, or removes it if its
+    // location was cleared. The location of the post is added as well. When it has no ID it is keyed by the post and removed
+    // with it.
+    void addPost(const ofxInstagramTypes::PostHandle &post);
+    bool removePost(const std::string &mediaID);
+
+    // Indexes the geotagged posts in the store and keeps the index updated as posts are merged in or erased, until
+    // detach() is called or the index is destroyed. Attaching again detaches from the previous store.
+    void attach(ofxInstagramPostStore &store);
+    void detach();
+
+    void clear();
+
+    // radius is in meters
+    std::vector<ofxInstagramTypes::Location> findLocationsInRadius(double latitude, double longitude, double radius) const;
+    std::vector<ofxInstagramTypes::PostHandle> findPostsInRadius(double latitude, double longitude, double radius) const;
+
+    std::vector<ofxInstagramTypes::Location> findLocationsInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const;
+    std::vector<ofxInstagramTypes::PostHandle> findPostsInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const;
+
+    size_t getLocationCount() const;
+    size_t getPostCount() const;
+
+    static bool hasCoordinates(const ofxInstagramTypes::Location &location);
+    // Great circle distance in meters
+    static double distance(double latitudeA, double longitudeA, double latitudeB, double longitudeB);
+
+private:
+    struct Point {
+        float latitude, longitude;
+        uint32_t item;
+    };
+
+    class Grid
+    {
+    public:
+        Grid(double cellSize);
+
+        void add(float latitude, float longitude, uint32_t item);
+        void remove(float latitude, float longitude, uint32_t item);
+        void clear();
+
+        void findInRadius(double latitude, double longitude, double radius, std::vector<uint32_t> &items) const;
+        void findInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude, std::vector<uint32_t> &items) const;
+
+    private:
+        const double m_CellSize;
+        std::unordered_map<uint64_t, std::vector<Point>> m_Cells;
+
+    private:
+        template<typename Function>
+        void forEachPointInBounds(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude, Function function) const;
+
+        int toCell(double degrees) const;
+        uint64_t cellKey(int latitudeCell, int longitudeCell) const;
+    };
+
+    Grid m_LocationGrid, m_PostGrid;
+
+    //Removed items leave an empty slot behind so the item indices stay stable, the next item added takes it
+    std::vector<ofxInstagramTypes::Location> m_Locations;
+    std::unordered_map<std::string, uint32_t> m_LocationItems;
+    std::vector<uint32_t> m_FreeLocationItems;
+
+    std::vector<ofxInstagramTypes::PostHandle> m_Posts;
+    std::vector<ofxInstagramTypes::Location> m_PostLocations;
+    std::unordered_map<std::string, uint32_t> m_PostItems;
+    std::vector<uint32_t> m_FreePostItems;
+    size_t m_PostCount;
+
+    //Guards everything above. Taken inside the lock of the store when a delta is applied.
+    mutable std::mutex m_Mutex;
+    //Last, so it is released first and no delta arrives while the rest is destroyed
+    ofxInstagramPostStore::Subscription m_Subscription;
+
+private:
+    //Called by the store
+    void apply(const ofxInstagramPostStore::Delta &delta);
+
+    //These expect m_Mutex to be locked
+    void insertLocation(const ofxInstagramTypes::Location &location, const std::string &key);
+    void eraseLocation(const std::string &key);
+    void insertPost(const ofxInstagramTypes::PostHandle &post);
+    bool erasePost(const std::string &mediaID);
+};
+
+#endif // OFXINSTAGRAMSPATIALINDEX_H
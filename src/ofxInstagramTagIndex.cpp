@@ -0,0 +1,327 @@
+#include "ofxInstagramTagIndex.h"
+#include <algorithm>
+#include <iterator>
+using namespace ofxInstagramTypes;
+
+namespace
+{
+//Compaction walks every posting list, so it only runs once the removed posts outnumber the remaining ones
+const size_t MIN_COMPACT_COUNT = 1024;
+const uint32_t REMOVED_ID = static_cast<uint32_t>(-1);
+
+std::vector<std::string> uniqueTags(std::vector<std::string> tags)
+{
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+    return tags;
+}
+
+//Finds the first ID not less than value by doubling the step from first until it passes value and then binary searching
+//the last step. Cheaper than a plain binary search over the rest of the list when the next match is close by.
+std::vector<uint32_t>::const_iterator gallop(std::vector<uint32_t>::const_iterator first, std::vector<uint32_t>::const_iterator last, uint32_t value)
+{
+    size_t step = 1;
+    while (static_cast<size_t>(last - first) > step && first[step] < value) {
+        first += step;
+        step *= 2;
+    }
+
+    return std::lower_bound(first, static_cast<size_t>(last - first) > step ? first + step + 1 : last, value);
+}
+}
+
+ofxInstagramTagIndex::ofxInstagramTagIndex()
+    : m_PostCount(0)
+{
+
+}
+
+void ofxInstagramTagIndex::add(const PostHandle &post)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    insert(post);
+}
+
+bool ofxInstagramTagIndex::remove(const std::string &mediaID)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return erase(mediaID);
+}
+
+void ofxInstagramTagIndex::insert(const PostHandle &post)
+{
+    if (!post) {
+        return;
+    }
+
+    const std::vector<std::string> tags = uniqueTags(post->tags);
+    auto it = m_DenseIDs.find(post->id);
+    if (it == m_DenseIDs.end()) {
+        const uint32_t denseID = static_cast<uint32_t>(m_Posts.size());
+        m_DenseIDs.insert(std::make_pair(post->id, denseID));
+        m_Posts.push_back(post);
+        m_LikeCounts.push_back(post->likeCount);
+        m_PostTags.push_back(tags);
+        // Dense IDs only grow, so appending keeps every posting list sorted
+        addToPostingLists(denseID, tags);
+        m_PostCount++;
+        return;
+    }
+
+    const uint32_t denseID = it->second;
+    m_Posts[denseID] = post;
+    m_LikeCounts[denseID] = post->likeCount;
+    if (m_PostTags[denseID] != tags) {
+        removeFromPostingLists(denseID, m_PostTags[denseID]);
+        addToPostingLists(denseID, tags);
+        m_PostTags[denseID] = tags;
+    }
+}
+
+bool ofxInstagramTagIndex::erase(const std::string &mediaID)
+{
+    auto it = m_DenseIDs.find(mediaID);
+    if (it == m_DenseIDs.end()) {
+        return false;
+    }
+
+    const uint32_t denseID = it->second;
+    removeFromPostingLists(denseID, m_PostTags[denseID]);
+    m_Posts[denseID] = nullptr;
+    m_PostTags[denseID].clear();
+    m_LikeCounts[denseID] = 0;
+    m_DenseIDs.erase(it);
+    m_PostCount--;
+
+    const size_t removedCount = m_Posts.size() - m_PostCount;
+    if (removedCount >= MIN_COMPACT_COUNT && removedCount > m_PostCount) {
+        compact();
+    }
+
+    return true;
+}
+
+void ofxInstagramTagIndex::clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_PostingLists.clear();
+    m_DenseIDs.clear();
+    m_Posts.clear();
+    m_PostTags.clear();
+    m_LikeCounts.clear();
+    m_PostCount = 0;
+}
+
+void ofxInstagramTagIndex::attach(ofxInstagramPostStore &store)
+{
+    //Replayed, so no post merged in while attaching is missed. The subscription is released with the index, so the store
+    //never calls into a destroyed index.
+    m_Subscription = store.subscribeScoped([this](const ofxInstagramPostStore::Delta & delta) {
+        apply(delta);
+    }, true);
+}
+
+void ofxInstagramTagIndex::detach()
+{
+    m_Subscription.reset();
+}
+
+std::vector<PostHandle> ofxInstagramTagIndex::findAll(const std::vector<std::string> &tags) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return toPosts(intersect(tags));
+}
+
+std::vector<PostHandle> ofxInstagramTagIndex::findAny(const std::vector<std::string> &tags) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return toPosts(unite(tags));
+}
+
+std::vector<PostHandle> ofxInstagramTagIndex::findTopLiked(const std::vector<std::string> &tags, size_t count, bool matchAll) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    PostingList ids = matchAll ? intersect(tags) : unite(tags);
+    const size_t resultCount = std::min(count, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + resultCount, ids.end(), [this](uint32_t left, uint32_t right) {
+        return m_LikeCounts[left] > m_LikeCounts[right];
+    });
+
+    ids.resize(resultCount);
+    return toPosts(ids);
+}
+
+size_t ofxInstagramTagIndex::getPostCount(const std::string &tag) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_PostingLists.find(tag);
+    return it == m_PostingLists.end() ? 0 : it->second.size();
+}
+
+size_t ofxInstagramTagIndex::getTagCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_PostingLists.size();
+}
+
+size_t ofxInstagramTagIndex::size() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_PostCount;
+}
+
+void ofxInstagramTagIndex::apply(const ofxInstagramPostStore::Delta &delta)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (delta.isRemoved) {
+        erase(delta.post->id);
+    }
+    else if (delta.isNew || delta.tagsChanged) {
+        insert(delta.post);
+    }
+    else {
+        //The store replaced the record, keep handing out the current one
+        auto it = m_DenseIDs.find(delta.post->id);
+        if (it != m_DenseIDs.end()) {
+            m_Posts[it->second] = delta.post;
+            m_LikeCounts[it->second] = delta.post->likeCount;
+        }
+    }
+}
+
+void ofxInstagramTagIndex::addToPostingLists(uint32_t denseID, const std::vector<std::string> &tags)
+{
+    for (const std::string &tag : tags) {
+        PostingList &list = m_PostingLists[tag];
+        if (list.empty() || list.back() < denseID) {
+            list.push_back(denseID);
+        }
+        else {
+            list.insert(std::lower_bound(list.begin(), list.end(), denseID), denseID);
+        }
+    }
+}
+
+void ofxInstagramTagIndex::removeFromPostingLists(uint32_t denseID, const std::vector<std::string> &tags)
+{
+    for (const std::string &tag : tags) {
+        auto listIt = m_PostingLists.find(tag);
+        if (listIt == m_PostingLists.end()) {
+            continue;
+        }
+
+        PostingList &list = listIt->second;
+        auto it = std::lower_bound(list.begin(), list.end(), denseID);
+        if (it != list.end() && *it == denseID) {
+            list.erase(it);
+        }
+
+        if (list.empty()) {
+            m_PostingLists.erase(listIt);
+        }
+    }
+}
+
+void ofxInstagramTagIndex::compact()
+{
+    //Dense IDs keep their order, so the posting lists stay sorted when they are renumbered
+    std::vector<uint32_t> newIDs(m_Posts.size(), REMOVED_ID);
+    uint32_t nextID = 0;
+    for (size_t denseID = 0; denseID < m_Posts.size(); denseID++) {
+        if (!m_Posts[denseID]) {
+            continue;
+        }
+
+        newIDs[denseID] = nextID;
+        m_Posts[nextID] = std::move(m_Posts[denseID]);
+        m_PostTags[nextID] = std::move(m_PostTags[denseID]);
+        m_LikeCounts[nextID] = m_LikeCounts[denseID];
+        nextID++;
+    }
+
+    m_Posts.resize(nextID);
+    m_PostTags.resize(nextID);
+    m_LikeCounts.resize(nextID);
+
+    for (auto &entry : m_DenseIDs) {
+        entry.second = newIDs[entry.second];
+    }
+
+    for (auto &entry : m_PostingLists) {
+        for (uint32_t &id : entry.second) {
+            id = newIDs[id];
+        }
+    }
+}
+
+ofxInstagramTagIndex::PostingList ofxInstagramTagIndex::intersect(const std::vector<std::string> &tags) const
+{
+    std::vector<const PostingList *> lists;
+    for (const std::string &tag : tags) {
+        auto it = m_PostingLists.find(tag);
+        if (it == m_PostingLists.end()) {
+            return PostingList();
+        }
+
+        lists.push_back(&it->second);
+    }
+
+    if (lists.empty()) {
+        return PostingList();
+    }
+
+    // Start from the shortest list and gallop through the longer ones
+    std::sort(lists.begin(), lists.end(), [](const PostingList * left, const PostingList * right) {
+        return left->size() < right->size();
+    });
+
+    PostingList result = *lists.front();
+    for (size_t listIndex = 1; listIndex < lists.size() && result.empty() == false; listIndex++) {
+        const PostingList &list = *lists[listIndex];
+        PostingList::const_iterator position = list.begin();
+        size_t writeIndex = 0;
+        for (uint32_t id : result) {
+            position = gallop(position, list.end(), id);
+            if (position == list.end()) {
+                break;
+            }
+
+            if (*position == id) {
+                result[writeIndex++] = id;
+            }
+        }
+
+        result.resize(writeIndex);
+    }
+
+    return result;
+}
+
+ofxInstagramTagIndex::PostingList ofxInstagramTagIndex::unite(const std::vector<std::string> &tags) const
+{
+    PostingList result;
+    for (const std::string &tag : tags) {
+        auto it = m_PostingLists.find(tag);
+        if (it == m_PostingLists.end()) {
+            continue;
+        }
+
+        PostingList merged;
+        merged.reserve(result.size() + it->second.size());
+        std::set_union(result.begin(), result.end(), it->second.begin(), it->second.end(), std::back_inserter(merged));
+        result.swap(merged);
+    }
+
+    return result;
+}
+
+std::vector<PostHandle> ofxInstagramTagIndex::toPosts(const PostingList &ids) const
+{
+    std::vector<PostHandle> posts;
+    posts.reserve(ids.size());
+    for (uint32_t id : ids) {
+        posts.push_back(m_Posts[id]);
+    }
+
+    return posts;
+}
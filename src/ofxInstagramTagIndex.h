@@ -0,0 +1,75 @@
+#ifndef OFXINSTAGRAMTAGINDEX_H
+#define OFXINSTAGRAMTAGINDEX_H
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ofxInstagramTypes.h"
+#include "ofxInstagramPostStore.h"
+
+// In-memory inverted index from tag to the posts that have it. Every post gets a dense integer ID in arrival order and
+// each tag keeps a sorted posting list of those IDs, so AND/OR queries are list intersections/unions. It can be queried
+// from any thread while it is updated by its store.
+class ofxInstagramTagIndex
+{
+public:
+    ofxInstagramTagIndex();
+
+    // Adds the post or updates its tags and like count if it is already indexed
+    void add(const ofxInstagramTypes::PostHandle &post);
+    bool remove(const std::string &mediaID);
+    void clear();
+
+    // Indexes the posts already in the store and keeps the index updated as posts are merged in or erased, until detach()
+    // is called or the index is destroyed. Attaching again detaches from the previous store.
+    void attach(ofxInstagramPostStore &store);
+    void detach();
+
+    // Posts that have all of the tags
+    std::vector<ofxInstagramTypes::PostHandle> findAll(const std::vector<std::string> &tags) const;
+    // Posts that have at least one of the tags
+    std::vector<ofxInstagramTypes::PostHandle> findAny(const std::vector<std::string> &tags) const;
+    // Most liked posts that have all (or any) of the tags, sorted by like count in descending order
+    std::vector<ofxInstagramTypes::PostHandle> findTopLiked(const std::vector<std::string> &tags, size_t count, bool matchAll = true) const;
+
+    size_t getPostCount(const std::string &tag) const;
+    size_t getTagCount() const;
+    size_t size() const;
+
+private:
+    using PostingList = std::vector<uint32_t>;
+
+    std::unordered_map<std::string, PostingList> m_PostingLists;
+    std::unordered_map<std::string, uint32_t> m_DenseIDs;
+
+    //Indexed by dense ID. Removed posts leave a nullptr behind until there are enough of them to compact.
+    std::vector<ofxInstagramTypes::PostHandle> m_Posts;
+    std::vector<std::vector<std::string>> m_PostTags;
+    std::vector<unsigned int> m_LikeCounts;
+
+    size_t m_PostCount;
+
+    //Guards everything above. Taken inside the lock of the store when a delta is applied.
+    mutable std::mutex m_Mutex;
+    //Last, so it is released first and no delta arrives while the rest is destroyed
+    ofxInstagramPostStore::Subscription m_Subscription;
+
+private:
+    //Called by the store
+    void apply(const ofxInstagramPostStore::Delta &delta);
+
+    //These and the ones below expect m_Mutex to be locked
+    void insert(const ofxInstagramTypes::PostHandle &post);
+    bool erase(const std::string &mediaID);
+    void addToPostingLists(uint32_t denseID, const std::vector<std::string> &tags);
+    void removeFromPostingLists(uint32_t denseID, const std::vector<std::string> &tags);
+    //Renumbers the remaining posts so the removed ones stop taking up space
+    void compact();
+
+    PostingList intersect(const std::vector<std::string> &tags) const;
+    PostingList unite(const std::vector<std::string> &tags) const;
+    std::vector<ofxInstagramTypes::PostHandle> toPosts(const PostingList &ids) const;
+};
+
+#endif // OFXINSTAGRAMTAGINDEX_H
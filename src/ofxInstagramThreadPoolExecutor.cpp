@@ -0,0 +1,82 @@
+#include "ofxInstagramThreadPoolExecutor.h"
+#include <algorithm>
+#include "ofLog.h"
+
+ofxInstagramThreadPoolExecutor::ofxInstagramThreadPoolExecutor()
+    : m_IsRunning(false)
+{
+
+}
+
+ofxInstagramThreadPoolExecutor::~ofxInstagramThreadPoolExecutor()
+{
+    stop();
+}
+
+void ofxInstagramThreadPoolExecutor::setup(size_t threadCount)
+{
+    stop();
+    m_IsRunning = true;
+    for (size_t threadIndex = 0; threadIndex < std::max<size_t>(threadCount, 1); threadIndex++) {
+        m_Threads.push_back(std::thread(&ofxInstagramThreadPoolExecutor::threadedFunction, this));
+    }
+}
+
+void ofxInstagramThreadPoolExecutor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_TaskMutex);
+        m_IsRunning = false;
+        m_Tasks.clear();
+    }
+
+    m_TaskCondition.notify_all();
+    for (std::thread &thread : m_Threads) {
+        thread.join();
+    }
+
+    m_Threads.clear();
+}
+
+void ofxInstagramThreadPoolExecutor::execute(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_TaskMutex);
+        if (m_IsRunning == false) {
+            ofLogError("ofxInstagramThreadPoolExecutor") << __FUNCTION__ << ": setup() was not called, the task is dropped.";
+            return;
+        }
+
+        m_Tasks.push_back(std::move(task));
+    }
+
+    m_TaskCondition.notify_one();
+}
+
+size_t ofxInstagramThreadPoolExecutor::getQueuedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_TaskMutex);
+    return m_Tasks.size();
+}
+
+void ofxInstagramThreadPoolExecutor::threadedFunction()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_TaskMutex);
+            m_TaskCondition.wait(lock, [this]() {
+                return m_IsRunning == false || m_Tasks.empty() == false;
+            });
+
+            if (m_IsRunning == false) {
+                break;
+            }
+
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop_front();
+        }
+
+        task();
+    }
+}
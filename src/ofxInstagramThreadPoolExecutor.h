@@ -0,0 +1,37 @@
+#ifndef OFXINSTAGRAMTHREADPOOLEXECUTOR_H
+#define OFXINSTAGRAMTHREADPOOLEXECUTOR_H
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ofxInstagramExecutor.h"
+
+// Runs the tasks on a pool of threads, so callbacks that do heavy work with the posts run in parallel and off the main
+// thread. The callbacks of different responses run at the same time.
+class ofxInstagramThreadPoolExecutor : public ofxInstagramExecutor
+{
+public:
+    ofxInstagramThreadPoolExecutor();
+    ~ofxInstagramThreadPoolExecutor();
+
+    void setup(size_t threadCount = 4);
+    // Waits for the running tasks, the queued ones are dropped
+    void stop();
+
+    void execute(std::function<void()> task) override;
+
+    size_t getQueuedCount() const;
+
+private:
+    std::vector<std::thread> m_Threads;
+    std::deque<std::function<void()>> m_Tasks;
+    mutable std::mutex m_TaskMutex;
+    std::condition_variable m_TaskCondition;
+    bool m_IsRunning;
+
+private:
+    void threadedFunction();
+};
+
+#endif // OFXINSTAGRAMTHREADPOOLEXECUTOR_H
@@ -0,0 +1,219 @@
+#include "ofxInstagramTimeIndex.h"
+#include <algorithm>
+using namespace ofxInstagramTypes;
+
+ofxInstagramTimeIndex::ofxInstagramTimeIndex(size_t maxCount, std::time_t maxAge)
+    : m_MaxCount(maxCount)
+    , m_MaxAge(maxAge)
+{
+
+}
+
+void ofxInstagramTimeIndex::setMaxCount(size_t maxCount)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxCount = maxCount;
+    removeExpired();
+}
+
+void ofxInstagramTimeIndex::setMaxAge(std::time_t maxAge)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_MaxAge = maxAge;
+    removeExpired();
+}
+
+void ofxInstagramTimeIndex::add(const PostHandle &post)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    insert(post);
+    removeExpired();
+}
+
+void ofxInstagramTimeIndex::add(const std::vector<PostHandle> &posts)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const PostHandle &post : posts) {
+        insert(post);
+    }
+
+    removeExpired();
+}
+
+void ofxInstagramTimeIndex::insert(const PostHandle &post)
+{
+    if (!post || m_MediaIDs.insert(post->id).second == false) {
+        return;
+    }
+
+    Entry entry;
+    entry.timestamp = post->createdTimestamp;
+    entry.post = post;
+
+    // Posts mostly arrive newest last, so this is usually a push_back
+    if (m_Entries.empty() || m_Entries.back().timestamp <= entry.timestamp) {
+        m_Entries.push_back(entry);
+    }
+    else {
+        auto position = std::upper_bound(m_Entries.begin(), m_Entries.end(), entry.timestamp, [](std::time_t timestamp, const Entry & other) {
+            return timestamp < other.timestamp;
+        });
+        m_Entries.insert(position, entry);
+    }
+}
+
+void ofxInstagramTimeIndex::attach(ofxInstagramPostStore &store)
+{
+    //Replayed, so no post merged in while attaching is missed. The subscription is released with the index, so the store
+    //never calls into a destroyed index.
+    m_Subscription = store.subscribeScoped([this](const ofxInstagramPostStore::Delta & delta) {
+        apply(delta);
+    }, true);
+}
+
+void ofxInstagramTimeIndex::detach()
+{
+    m_Subscription.reset();
+}
+
+std::vector<PostHandle> ofxInstagramTimeIndex::findInWindow(std::time_t from, std::time_t to, const Filter &filter) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<PostHandle> posts;
+    if (from > to) {
+        return posts;
+    }
+
+    const auto end = upperBound(to);
+    for (auto it = lowerBound(from); it != end; ++it) {
+        if (!filter || filter(*it->post)) {
+            posts.push_back(it->post);
+        }
+    }
+
+    return posts;
+}
+
+std::vector<PostHandle> ofxInstagramTimeIndex::findLatest(std::time_t duration, const Filter &filter) const
+{
+    const std::time_t now = std::time(nullptr);
+    return findInWindow(now - duration, now, filter);
+}
+
+size_t ofxInstagramTimeIndex::countInWindow(std::time_t from, std::time_t to) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (from > to) {
+        return 0;
+    }
+
+    return static_cast<size_t>(std::distance(lowerBound(from), upperBound(to)));
+}
+
+void ofxInstagramTimeIndex::evict()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    removeExpired();
+}
+
+void ofxInstagramTimeIndex::removeExpired()
+{
+    while (m_MaxCount != 0 && m_Entries.size() > m_MaxCount) {
+        popOldest();
+    }
+
+    if (m_MaxAge != 0) {
+        const std::time_t oldestAllowed = std::time(nullptr) - m_MaxAge;
+        while (m_Entries.empty() == false && m_Entries.front().timestamp < oldestAllowed) {
+            popOldest();
+        }
+    }
+}
+
+void ofxInstagramTimeIndex::clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Entries.clear();
+    m_MediaIDs.clear();
+}
+
+size_t ofxInstagramTimeIndex::size() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Entries.size();
+}
+
+std::time_t ofxInstagramTimeIndex::getOldestTimestamp() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Entries.empty() ? 0 : m_Entries.front().timestamp;
+}
+
+std::time_t ofxInstagramTimeIndex::getNewestTimestamp() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Entries.empty() ? 0 : m_Entries.back().timestamp;
+}
+
+void ofxInstagramTimeIndex::apply(const ofxInstagramPostStore::Delta &delta)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (delta.isNew) {
+        insert(delta.post);
+        removeExpired();
+    }
+    else if (delta.isRemoved) {
+        auto it = findEntry(*delta.post);
+        if (it != m_Entries.end()) {
+            m_MediaIDs.erase(delta.post->id);
+            m_Entries.erase(it);
+        }
+    }
+    else {
+        //The store replaced the record, keep handing out the current one
+        auto it = findEntry(*delta.post);
+        if (it != m_Entries.end()) {
+            it->post = delta.post;
+        }
+    }
+}
+
+std::deque<ofxInstagramTimeIndex::Entry>::const_iterator ofxInstagramTimeIndex::lowerBound(std::time_t timestamp) const
+{
+    return std::lower_bound(m_Entries.begin(), m_Entries.end(), timestamp, [](const Entry & entry, std::time_t other) {
+        return entry.timestamp < other;
+    });
+}
+
+std::deque<ofxInstagramTimeIndex::Entry>::const_iterator ofxInstagramTimeIndex::upperBound(std::time_t timestamp) const
+{
+    return std::upper_bound(m_Entries.begin(), m_Entries.end(), timestamp, [](std::time_t other, const Entry & entry) {
+        return other < entry.timestamp;
+    });
+}
+
+std::deque<ofxInstagramTimeIndex::Entry>::iterator ofxInstagramTimeIndex::findEntry(const PostData &post)
+{
+    if (m_MediaIDs.count(post.id) == 0) {
+        return m_Entries.end();
+    }
+
+    //The creation time of a post does not change, so only the entries with the same timestamp need to be checked
+    auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), post.createdTimestamp, [](const Entry & entry, std::time_t other) {
+        return entry.timestamp < other;
+    });
+
+    for (; it != m_Entries.end() && it->timestamp == post.createdTimestamp; ++it) {
+        if (it->post->id == post.id) {
+            return it;
+        }
+    }
+
+    return m_Entries.end();
+}
+
+void ofxInstagramTimeIndex::popOldest()
+{
+    m_MediaIDs.erase(m_Entries.front().post->id);
+    m_Entries.pop_front();
+}
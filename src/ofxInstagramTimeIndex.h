@@ -0,0 +1,81 @@
+#ifndef OFXINSTAGRAMTIMEINDEX_H
+#define OFXINSTAGRAMTIMEINDEX_H
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "ofxInstagramTypes.h"
+#include "ofxInstagramPostStore.h"
+
+// Posts ordered by PostData::createdTimestamp. Window queries are binary searches over the ordered buffer and the oldest
+// posts are evicted automatically once the buffer goes over its count or age limit. It can be queried from any thread while
+// it is updated by its store.
+class ofxInstagramTimeIndex
+{
+public:
+    using Filter = std::function<bool(const ofxInstagramTypes::PostData &)>;
+
+public:
+    // A limit of 0 disables that limit. maxAge is in seconds.
+    ofxInstagramTimeIndex(size_t maxCount = 0, std::time_t maxAge = 0);
+
+    void setMaxCount(size_t maxCount);
+    void setMaxAge(std::time_t maxAge);
+
+    // Posts that are already in the index are ignored
+    void add(const ofxInstagramTypes::PostHandle &post);
+    void add(const std::vector<ofxInstagramTypes::PostHandle> &posts);
+
+    // Adds the posts in the store and every new post merged in afterwards. Posts erased from the store are removed.
+    // Stays attached until detach() is called or the index is destroyed. Attaching again detaches from the previous store.
+    void attach(ofxInstagramPostStore &store);
+    void detach();
+
+    // Posts created in [from, to], oldest first. The filter is called with the index locked and must not use it.
+    std::vector<ofxInstagramTypes::PostHandle> findInWindow(std::time_t from, std::time_t to, const Filter &filter = nullptr) const;
+    // Posts created in the last duration seconds
+    std::vector<ofxInstagramTypes::PostHandle> findLatest(std::time_t duration, const Filter &filter = nullptr) const;
+    size_t countInWindow(std::time_t from, std::time_t to) const;
+
+    // Drops the posts that are over the limits. Called by add(), call it from update() if nothing is being added.
+    void evict();
+    void clear();
+
+    size_t size() const;
+    std::time_t getOldestTimestamp() const;
+    std::time_t getNewestTimestamp() const;
+
+private:
+    struct Entry {
+        std::time_t timestamp;
+        ofxInstagramTypes::PostHandle post;
+    };
+
+    std::deque<Entry> m_Entries;
+    std::unordered_set<std::string> m_MediaIDs;
+
+    size_t m_MaxCount;
+    std::time_t m_MaxAge;
+
+    //Guards everything above. Taken inside the lock of the store when a delta is applied.
+    mutable std::mutex m_Mutex;
+    //Last, so it is released first and no delta arrives while the rest is destroyed
+    ofxInstagramPostStore::Subscription m_Subscription;
+
+private:
+    //Called by the store
+    void apply(const ofxInstagramPostStore::Delta &delta);
+
+    //These expect m_Mutex to be locked
+    void insert(const ofxInstagramTypes::PostHandle &post);
+    void removeExpired();
+    std::deque<Entry>::const_iterator lowerBound(std::time_t timestamp) const;
+    std::deque<Entry>::const_iterator upperBound(std::time_t timestamp) const;
+    std::deque<Entry>::iterator findEntry(const ofxInstagramTypes::PostData &post);
+    void popOldest();
+};
+
+#endif // OFXINSTAGRAMTIMEINDEX_H
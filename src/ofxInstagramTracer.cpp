@@ -0,0 +1,209 @@
+#include "ofxInstagramTracer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include "ofLog.h"
+#include "ofUtils.h"
+
+const size_t ofxInstagramTracer::MAX_ENDPOINT_LENGTH;
+
+namespace
+{
+const uint64_t FLAG_ASYNC = 1;
+
+void appendEscaped(std::ostream &output, const std::string &value)
+{
+    for (const char character : value) {
+        if (character == '"' || character == '\\') {
+            output << '\\' << character;
+        }
+        else if (static_cast<unsigned char>(character) >= 0x20) {
+            output << character;
+        }
+    }
+}
+
+void writeEvent(std::ostream &output, const ofxInstagramTracer::Span &span, const char *phase, uint64_t time)
+{
+    output << ",\n{\"name\":\"";
+    appendEscaped(output, span.name);
+    output << "\",\"cat\":\"" << (span.isAsync ? "network" : "ofxInstagram") << "\",\"ph\":\"" << phase << "\",\"ts\":" << time
+           << ",\"pid\":1,\"tid\":" << span.threadID;
+    if (phase[0] == 'X') {
+        output << ",\"dur\":" << span.duration;
+    }
+    else {
+        output << ",\"id\":" << span.requestID;
+    }
+
+    output << ",\"args\":{";
+    if (span.endpoint.length() != 0) {
+        output << "\"endpoint\":\"";
+        appendEscaped(output, span.endpoint);
+        output << "\",";
+    }
+
+    output << "\"request_id\":" << span.requestID << "}}";
+}
+}
+
+ofxInstagramTracer::Scope::Scope(ofxInstagramTracer *tracer, const char *name, const std::string &endpoint, int requestID)
+    : m_Tracer(tracer)
+    , m_Name(name)
+    , m_RequestID(requestID)
+    , m_StartTime(0)
+{
+    if (m_Tracer) {
+        m_Endpoint = endpoint;
+        m_StartTime = ofGetElapsedTimeMicros();
+    }
+}
+
+ofxInstagramTracer::Scope::~Scope()
+{
+    if (m_Tracer) {
+        m_Tracer->record(m_Name, m_Endpoint, m_RequestID, m_StartTime, ofGetElapsedTimeMicros() - m_StartTime);
+    }
+}
+
+ofxInstagramTracer::ofxInstagramTracer(size_t capacity)
+    : m_Capacity(1)
+    , m_NextPosition(0)
+    , m_FirstPosition(0)
+    , m_MainThreadID(getThreadID())
+{
+    while (m_Capacity < capacity) {
+        m_Capacity <<= 1;
+    }
+
+    m_Slots.reset(new Slot[m_Capacity]);
+    for (size_t slotIndex = 0; slotIndex < m_Capacity; slotIndex++) {
+        m_Slots[slotIndex].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ofxInstagramTracer::record(const char *name, const std::string &endpoint, int requestID, uint64_t startTime, uint64_t duration, bool isAsync)
+{
+    const uint64_t position = m_NextPosition.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = m_Slots[position & (m_Capacity - 1)];
+
+    //An odd sequence marks the slot as being written, readers skip it until the even one follows
+    slot.sequence.store(position * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(reinterpret_cast<uintptr_t>(name), std::memory_order_relaxed);
+    slot.requestAndThread.store((static_cast<uint64_t>(static_cast<uint32_t>(requestID)) << 32) | getThreadID(), std::memory_order_relaxed);
+    slot.flags.store(isAsync ? FLAG_ASYNC : 0, std::memory_order_relaxed);
+    slot.startTime.store(startTime, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+
+    uint64_t endpointWords[ENDPOINT_WORD_COUNT] = {};
+    std::memcpy(endpointWords, endpoint.data(), std::min(endpoint.length(), MAX_ENDPOINT_LENGTH));
+    for (size_t wordIndex = 0; wordIndex < ENDPOINT_WORD_COUNT; wordIndex++) {
+        slot.endpoint[wordIndex].store(endpointWords[wordIndex], std::memory_order_relaxed);
+    }
+
+    slot.sequence.store(position * 2 + 2, std::memory_order_release);
+}
+
+std::vector<ofxInstagramTracer::Span> ofxInstagramTracer::getSpans() const
+{
+    const uint64_t endPosition = m_NextPosition.load(std::memory_order_acquire);
+    uint64_t position = m_FirstPosition.load(std::memory_order_acquire);
+    if (endPosition - position > m_Capacity) {
+        position = endPosition - m_Capacity;
+    }
+
+    std::vector<Span> spans;
+    spans.reserve(static_cast<size_t>(endPosition - position));
+    for (; position < endPosition; position++) {
+        const Slot &slot = m_Slots[position & (m_Capacity - 1)];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != position * 2 + 2) {
+            continue;
+        }
+
+        Span span;
+        span.name = reinterpret_cast<const char *>(static_cast<uintptr_t>(slot.name.load(std::memory_order_relaxed)));
+        const uint64_t requestAndThread = slot.requestAndThread.load(std::memory_order_relaxed);
+        span.requestID = static_cast<int>(static_cast<uint32_t>(requestAndThread >> 32));
+        span.threadID = static_cast<uint32_t>(requestAndThread);
+        span.isAsync = (slot.flags.load(std::memory_order_relaxed) & FLAG_ASYNC) != 0;
+        span.startTime = slot.startTime.load(std::memory_order_relaxed);
+        span.duration = slot.duration.load(std::memory_order_relaxed);
+
+        char endpoint[ENDPOINT_WORD_COUNT * 8 + 1] = {};
+        for (size_t wordIndex = 0; wordIndex < ENDPOINT_WORD_COUNT; wordIndex++) {
+            const uint64_t word = slot.endpoint[wordIndex].load(std::memory_order_relaxed);
+            std::memcpy(endpoint + wordIndex * 8, &word, 8);
+        }
+
+        //The slot was reused while it was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        span.endpoint = endpoint;
+        spans.push_back(span);
+    }
+
+    return spans;
+}
+
+void ofxInstagramTracer::clear()
+{
+    m_FirstPosition.store(m_NextPosition.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+uint64_t ofxInstagramTracer::getRecordedCount() const
+{
+    return m_NextPosition.load(std::memory_order_relaxed) - m_FirstPosition.load(std::memory_order_relaxed);
+}
+
+size_t ofxInstagramTracer::getCapacity() const
+{
+    return m_Capacity;
+}
+
+std::string ofxInstagramTracer::toChromeTrace() const
+{
+    const std::vector<Span> spans = getSpans();
+    std::ostringstream output;
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    //Names the thread that created the tracer, which is usually the main thread
+    output << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << m_MainThreadID << ",\"args\":{\"name\":\"main\"}}";
+    for (const Span &span : spans) {
+        if (span.isAsync) {
+            writeEvent(output, span, "b", span.startTime);
+            writeEvent(output, span, "e", span.startTime + span.duration);
+        }
+        else {
+            writeEvent(output, span, "X", span.startTime);
+        }
+    }
+
+    output << "\n]}\n";
+    return output.str();
+}
+
+bool ofxInstagramTracer::save(const std::string &path) const
+{
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (file.is_open() == false) {
+        ofLogError("ofxInstagramTracer") << __FUNCTION__ << ": Cannot open " << path;
+        return false;
+    }
+
+    file << toChromeTrace();
+    return file.good();
+}
+
+uint32_t ofxInstagramTracer::getThreadID()
+{
+    static thread_local const uint32_t threadID = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return threadID;
+}
@@ -0,0 +1,86 @@
+#ifndef OFXINSTAGRAMTRACER_H
+#define OFXINSTAGRAMTRACER_H
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Collects timed spans into a fixed size ring buffer and exports them in the Chrome trace event format, which
+// chrome://tracing and Perfetto open. Recording a span takes no lock, any thread can record while another one exports.
+// Once the buffer is full the oldest spans are overwritten.
+//
+// ofxInstagram records the stages of its requests when a tracer is set, see ofxInstagram::setTracer(). Scope puts the
+// app's own work, such as update() and draw(), on the same timeline:
+//
+//     ofxInstagramTracer::Scope scope(tracer.get(), "ofApp::draw");
+class ofxInstagramTracer
+{
+public:
+    struct Span {
+        const char *name = "";
+        std::string endpoint = "";
+        int requestID = -1;
+        uint32_t threadID = 0;
+        //Async spans, such as the network time of a request, overlap others on the same thread
+        bool isAsync = false;
+        //ofGetElapsedTimeMicros() based, in microseconds
+        uint64_t startTime = 0,
+                 duration = 0;
+    };
+
+    // Records the time from its construction to its destruction. Does nothing when tracer is null.
+    class Scope
+    {
+    public:
+        Scope(ofxInstagramTracer *tracer, const char *name, const std::string &endpoint = "", int requestID = -1);
+        ~Scope();
+
+    private:
+        ofxInstagramTracer *m_Tracer;
+        const char *m_Name;
+        std::string m_Endpoint;
+        int m_RequestID;
+        uint64_t m_StartTime;
+    };
+
+    // Longer endpoint names are cut
+    static const size_t MAX_ENDPOINT_LENGTH = 47;
+
+public:
+    // capacity is rounded up to a power of two
+    explicit ofxInstagramTracer(size_t capacity = 16384);
+
+    // name has to stay valid as long as the tracer, a string literal is the usual choice
+    void record(const char *name, const std::string &endpoint, int requestID, uint64_t startTime, uint64_t duration, bool isAsync = false);
+
+    // The spans in the buffer, oldest first. Spans that are being written at the same time are left out.
+    std::vector<Span> getSpans() const;
+    // Forgets the spans recorded so far
+    void clear();
+
+    // Every span recorded since the last clear(), including the overwritten ones
+    uint64_t getRecordedCount() const;
+    size_t getCapacity() const;
+
+    std::string toChromeTrace() const;
+    bool save(const std::string &path) const;
+
+private:
+    //Every field is a word that is written and read atomically, a slot's sequence tells whether it can be read
+    static const size_t ENDPOINT_WORD_COUNT = (MAX_ENDPOINT_LENGTH + 1) / 8;
+    struct Slot {
+        std::atomic<uint64_t> sequence, name, requestAndThread, flags, startTime, duration;
+        std::atomic<uint64_t> endpoint[ENDPOINT_WORD_COUNT];
+    };
+
+    std::unique_ptr<Slot[]> m_Slots;
+    size_t m_Capacity;
+    std::atomic<uint64_t> m_NextPosition, m_FirstPosition;
+    uint32_t m_MainThreadID;
+
+private:
+    static uint32_t getThreadID();
+};
+
+#endif // OFXINSTAGRAMTRACER_H
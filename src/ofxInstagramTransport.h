@@ -0,0 +1,27 @@
+#ifndef OFXINSTAGRAMTRANSPORT_H
+#define OFXINSTAGRAMTRANSPORT_H
+#include <cstdint>
+#include "ofURLFileLoader.h"
+
+// Loads the URLs of ofxInstagram's requests in place of ofLoadURLAsync(), see ofxInstagram::setTransport(). The
+// response has to be handed to ofxInstagram::urlResponse() with the request it was given in response.request. ofxInstagram
+// registers the request before load() is called, so the response can be delivered on any thread, even from inside load().
+// load() is called on the thread that called the getter.
+class ofxInstagramTransport
+{
+public:
+    virtual ~ofxInstagramTransport() {}
+
+    // Starts loading request.url
+    virtual void load(const ofHttpRequest &request) = 0;
+
+    // Called with the request ID once the response of a request arrived. Transports that know how long it waited to be
+    // sent (queue time) and how long it was on the network (network time) fill both in, in microseconds, and return true.
+    // Otherwise the time from the request to its response counts as network time.
+    virtual bool getTiming(int, uint64_t &, uint64_t &)
+    {
+        return false;
+    }
+};
+
+#endif // OFXINSTAGRAMTRANSPORT_H
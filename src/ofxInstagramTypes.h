@@ -3,7 +3,8 @@
 #include <string>
 #include <vector>
 #include <ostream>
-#include "ofVec2f.h"
+#include <memory>
+#include <ctime>
 
 namespace ofxInstagramTypes
 {
@@ -37,6 +38,21 @@ struct PostMedia {
     unsigned int width = 0, height = 0;
 };
 
+//The renditions of a post, see PostData
+enum MediaType {
+    MEDIA_IMAGE_THUMBNAIL,
+    MEDIA_IMAGE_LOW_RESOLUTION,
+    MEDIA_IMAGE_STANDARD_RESOLUTION,
+    MEDIA_VIDEO_LOW_BANDWIDTH,
+    MEDIA_VIDEO_LOW_RESOLUTION,
+    MEDIA_VIDEO_STANDARD_RESOLUTION
+};
+
+//Where a user is tagged in a photo, from 0 to 1 across its width and height
+struct Position {
+    float x = 0.f, y = 0.f;
+};
+
 struct Location {
     std::string id = "", name = "";
     float latitude = 0.f, longitude = 0.f;
@@ -51,6 +67,9 @@ struct PostData {
                 type = "",
                 id = "";
 
+    //createdTime decoded as seconds since epoch
+    std::time_t createdTimestamp = 0;
+
     Location location;
 
     PostMedia imageLowResolution,
@@ -67,8 +86,26 @@ struct PostData {
 
     std::vector<Comment> comments;
     std::vector<std::string> tags;
-    std::vector<std::pair<ofVec2f, UserInfo>> usersInPhoto;
+    std::vector<std::pair<Position, UserInfo>> usersInPhoto;
     std::vector<UserInfo> likes;
+
+    const PostMedia &getMedia(MediaType mediaType) const
+    {
+        switch (mediaType) {
+        case MEDIA_IMAGE_THUMBNAIL:
+            return imageThumbnail;
+        case MEDIA_IMAGE_LOW_RESOLUTION:
+            return imageLowResolution;
+        case MEDIA_IMAGE_STANDARD_RESOLUTION:
+            return imageStandarResolution;
+        case MEDIA_VIDEO_LOW_BANDWIDTH:
+            return videoLowBandwidth;
+        case MEDIA_VIDEO_LOW_RESOLUTION:
+            return videoLowResolution;
+        default:
+            return videoStandartResolution;
+        }
+    }
 };
 
 struct Relationship {
@@ -102,6 +139,11 @@ struct Meta {
 };
 
 using Posts = std::pair<std::vector<PostData>, Pagination>;
+using Users = std::pair<std::vector<UserInfo>, Pagination>;
+
+//Handles to the deduplicated records held by ofxInstagramPostStore
+using PostHandle = std::shared_ptr<const PostData>;
+using SharedPosts = std::pair<std::vector<PostHandle>, Pagination>;
 }
 
 #endif // OFXINSTAGRAMTYPES_H